@@ -18,13 +18,18 @@
 
 #include "maidsafe/launcher/account.h"
 
+#include <cstdint>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cereal/types/set.hpp"
 #include "cereal/types/string.hpp"
 
+#include "maidsafe/common/encode.h"
 #include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/authentication/user_credential_utils.h"
@@ -32,13 +37,56 @@
 #include "maidsafe/common/serialisation/types/asio_and_boost_asio.h"
 
 #include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/binary_encoding.h"
+#include "maidsafe/launcher/profiler.h"
 
 namespace maidsafe {
 
 namespace launcher {
 
+namespace {
+
+// Prefixed to the encrypted contents of chunks created by 'EncryptAccountDelta' so that these can
+// be distinguished from full account chunks without first having to decrypt them.
+const std::string kAccountDeltaTag("MaidSafeAccountDelta");
+
+// Prefixed (with the format version) to the serialised contents of full account chunks since
+// version 1, which replaced each app's inline icon with the name of its icon chunk.  Version 0
+// accounts have no prefix; they start with the length of the encrypted passport, which is a
+// little-endian 64-bit value far smaller than this tag would represent.
+const std::string kAccountFormatTag("MSAC");
+const std::uint16_t kAccountFormatVersion(1);
+
+// Only the name of an app's icon chunk is held in the account; the icon is stored separately.
+void SerialiseApp(BinaryOutputArchive& output_archive, const AppDetails& app) {
+  boost::optional<Identity> icon_id;
+  if (app.icon_id.IsInitialised())
+    icon_id = app.icon_id;
+  output_archive(app.name, app.permitted_dirs, icon_id);
+}
+
+AppDetails ParseApp(BinaryInputArchive& input_archive) {
+  AppDetails app;
+  boost::optional<Identity> icon_id;
+  input_archive(app.name, app.permitted_dirs, icon_id);
+  if (icon_id)
+    app.icon_id = *icon_id;
+  return app;
+}
+
+crypto::SHA512Hash GetAppDigest(const AppDetails& app) {
+  OutputVectorStream binary_output_stream;
+  BinaryOutputArchive output_archive{binary_output_stream};
+  SerialiseApp(output_archive, app);
+  return crypto::Hash<crypto::SHA512>(
+      std::string(binary_output_stream.vector().begin(), binary_output_stream.vector().end()));
+}
+
+}  // unnamed namespace
+
 ImmutableData EncryptAccount(const authentication::UserCredentials& user_credentials,
                              Account& account) {
+  Profiler::Scope scope{"crypto", "EncryptAccount"};
   uint64_t serialised_timestamp{GetTimeStamp()};
   boost::optional<Identity> unique_user_id, root_parent_id;
   if (account.unique_user_id.IsInitialised())
@@ -50,20 +98,83 @@ ImmutableData EncryptAccount(const authentication::UserCredentials& user_credent
   BinaryOutputArchive output_archive{binary_output_stream};
   output_archive(account.passport->Encrypt(user_credentials), serialised_timestamp, account.ip,
                  account.port, unique_user_id, root_parent_id, account.config_file_aes_key_and_iv,
-                 account.apps.size());
+                 static_cast<std::uint32_t>(account.apps.size()));
   for (const auto& app : account.apps)
-    output_archive(app.name, app.permitted_dirs, app.icon);
+    SerialiseApp(output_archive, app);
 
-  NonEmptyString serialised_account{
-      std::string(binary_output_stream.vector().begin(), binary_output_stream.vector().end())};
+  std::string serialised_fields{kAccountFormatTag};
+  AppendUint16(kAccountFormatVersion, serialised_fields);
+  serialised_fields.append(binary_output_stream.vector().begin(),
+                           binary_output_stream.vector().end());
+  NonEmptyString serialised_account{std::move(serialised_fields)};
 
   account.timestamp = TimeStampToPtime(serialised_timestamp);
 
+  scope.AddBytes(serialised_account.string().size());
   return ImmutableData{
       crypto::SymmEncrypt(authentication::Obfuscate(user_credentials, serialised_account),
                           authentication::CreateSecurePassword(user_credentials))};
 }
 
+ImmutableData EncryptAccountDelta(const authentication::UserCredentials& user_credentials,
+                                  const Identity& base_account_name,
+                                  const AppDigests& base_app_digests, std::uint32_t delta_index,
+                                  Account& account) {
+  uint64_t serialised_timestamp{GetTimeStamp()};
+  boost::optional<Identity> unique_user_id, root_parent_id;
+  if (account.unique_user_id.IsInitialised())
+    unique_user_id = account.unique_user_id;
+  if (account.root_parent_id.IsInitialised())
+    root_parent_id = account.root_parent_id;
+
+  // Only the apps changed since the base account was saved can differ from it, so only these are
+  // rehashed.
+  std::vector<const AppDetails*> updated_apps;
+  std::set<AppName> removed_apps;
+  for (const auto& app_name : account.apps.ChangedApps()) {
+    const AppDetails* const app{account.apps.Find(app_name)};
+    const auto digest_itr(base_app_digests.find(app_name));
+    if (!app) {
+      if (digest_itr != base_app_digests.end())
+        removed_apps.insert(app_name);
+    } else if (digest_itr == base_app_digests.end() || GetAppDigest(*app) != digest_itr->second) {
+      updated_apps.push_back(app);
+    }
+  }
+
+  OutputVectorStream binary_output_stream;
+  BinaryOutputArchive output_archive{binary_output_stream};
+  output_archive(base_account_name, delta_index, serialised_timestamp, account.ip, account.port,
+                 unique_user_id, root_parent_id, account.config_file_aes_key_and_iv,
+                 static_cast<std::uint32_t>(updated_apps.size()));
+  for (const auto& app : updated_apps)
+    SerialiseApp(output_archive, *app);
+  output_archive(removed_apps);
+
+  NonEmptyString serialised_delta{
+      std::string(binary_output_stream.vector().begin(), binary_output_stream.vector().end())};
+
+  account.timestamp = TimeStampToPtime(serialised_timestamp);
+
+  crypto::CipherText encrypted_delta{
+      crypto::SymmEncrypt(authentication::Obfuscate(user_credentials, serialised_delta),
+                          authentication::CreateSecurePassword(user_credentials))};
+  return ImmutableData{NonEmptyString{kAccountDeltaTag + encrypted_delta->string()}};
+}
+
+bool IsAccountDelta(const ImmutableData& encrypted_account) {
+  return encrypted_account.Value().string().size() > kAccountDeltaTag.size() &&
+         encrypted_account.Value().string().compare(0, kAccountDeltaTag.size(), kAccountDeltaTag) ==
+             0;
+}
+
+AppDigests GetAppDigests(const AppRegistry& apps) {
+  AppDigests app_digests;
+  for (const auto& app : apps)
+    app_digests.emplace_hint(app_digests.end(), app.name, GetAppDigest(app));
+  return app_digests;
+}
+
 Account::Account(const passport::MaidAndSigner& maid_and_signer)
     : passport(maidsafe::make_unique<passport::Passport>(maid_and_signer)),
       timestamp(),
@@ -76,6 +187,12 @@ Account::Account(const passport::MaidAndSigner& maid_and_signer)
 
 Account::Account(const ImmutableData& encrypted_account,
                  const authentication::UserCredentials& user_credentials)
+    : Account(encrypted_account, user_credentials,
+              authentication::CreateSecurePassword(user_credentials)) {}
+
+Account::Account(const ImmutableData& encrypted_account,
+                 const authentication::UserCredentials& user_credentials,
+                 const crypto::SecurePassword& secure_password)
     : passport(),
       timestamp(),
       ip(),
@@ -84,28 +201,60 @@ Account::Account(const ImmutableData& encrypted_account,
       root_parent_id(),
       config_file_aes_key_and_iv(),
       apps() {
+  Profiler::Scope decrypt_scope{"crypto", "DecryptAccount"};
+  decrypt_scope.AddBytes(encrypted_account.Value().string().size());
   NonEmptyString serialised_account{authentication::Obfuscate(
       user_credentials,
-      crypto::SymmDecrypt(crypto::CipherText{encrypted_account.Value()},
-                          authentication::CreateSecurePassword(user_credentials)))};
+      crypto::SymmDecrypt(crypto::CipherText{encrypted_account.Value()}, secure_password))};
+
+  const std::string& serialised{serialised_account.string()};
+  std::uint16_t version{0};
+  std::size_t fields_offset{0};
+  if (serialised.compare(0, kAccountFormatTag.size(), kAccountFormatTag) == 0) {
+    BinaryReader reader{serialised, kAccountFormatTag.size()};
+    version = reader.ReadUint16();
+    fields_offset = reader.Offset();
+  }
+  if (version > kAccountFormatVersion) {
+    LOG(kError) << "Account format version " << version << " is newer than this version of the "
+                << "launcher supports.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
 
   crypto::CipherText encrypted_passport;
   uint64_t serialised_timestamp{0};
   boost::optional<Identity> optional_unique_user_id, optional_root_parent_id;
-  std::size_t app_count{0};
 
   InputVectorStream binary_input_stream{
-      SerialisedData(serialised_account.string().begin(), serialised_account.string().end())};
+      SerialisedData(serialised.begin() + fields_offset, serialised.end())};
   BinaryInputArchive input_archive{binary_input_stream};
   input_archive(encrypted_passport, serialised_timestamp, ip, port, optional_unique_user_id,
-                optional_root_parent_id, config_file_aes_key_and_iv, app_count);
-  for (std::size_t i{0}; i < app_count; ++i) {
-    AppDetails app_details;
-    input_archive(app_details.name, app_details.permitted_dirs, app_details.icon);
-    apps.insert(apps.end(), std::move(app_details));
+                optional_root_parent_id, config_file_aes_key_and_iv);
+  if (version == 0) {
+    // Each app's icon is held inline.  It's kept in 'icon' so that 'Launcher' can store it as a
+    // separate chunk, and 'icon_id' is set to the name of that chunk.
+    std::size_t app_count{0};
+    input_archive(app_count);
+    for (std::size_t i{0}; i < app_count; ++i) {
+      AppDetails app;
+      input_archive(app.name, app.permitted_dirs, app.icon);
+      if (!app.icon.empty())
+        app.icon_id = MakeIconChunk(app.icon, config_file_aes_key_and_iv).Name();
+      apps.Insert(std::move(app));
+    }
+  } else {
+    std::uint32_t app_count{0};
+    input_archive(app_count);
+    for (std::uint32_t i{0}; i < app_count; ++i)
+      apps.Insert(ParseApp(input_archive));
   }
+  apps.ClearChanged();
 
-  passport = maidsafe::make_unique<passport::Passport>(encrypted_passport, user_credentials);
+  {
+    Profiler::Scope passport_scope{"crypto", "DecryptPassport"};
+    passport_scope.AddBytes(encrypted_passport.data.string().size());
+    passport = maidsafe::make_unique<passport::Passport>(encrypted_passport, user_credentials);
+  }
   timestamp = TimeStampToPtime(serialised_timestamp);
   if (optional_unique_user_id)
     unique_user_id = *optional_unique_user_id;
@@ -147,6 +296,68 @@ void swap(Account& lhs, Account& rhs) MAIDSAFE_NOEXCEPT {
   swap(lhs.apps, rhs.apps);
 }
 
+AccountDelta::AccountDelta(const ImmutableData& encrypted_delta,
+                           const authentication::UserCredentials& user_credentials)
+    : AccountDelta(encrypted_delta, user_credentials,
+                   authentication::CreateSecurePassword(user_credentials)) {}
+
+AccountDelta::AccountDelta(const ImmutableData& encrypted_delta,
+                           const authentication::UserCredentials& user_credentials,
+                           const crypto::SecurePassword& secure_password)
+    : base_account_name(),
+      index(0),
+      timestamp(),
+      ip(),
+      port(0),
+      unique_user_id(),
+      root_parent_id(),
+      config_file_aes_key_and_iv(),
+      updated_apps(),
+      removed_apps() {
+  if (!IsAccountDelta(encrypted_delta)) {
+    LOG(kError) << "Chunk " << hex::Substr(encrypted_delta.Name()) << " is not an account delta.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  NonEmptyString serialised_delta{authentication::Obfuscate(
+      user_credentials,
+      crypto::SymmDecrypt(crypto::CipherText{NonEmptyString{
+                              encrypted_delta.Value().string().substr(kAccountDeltaTag.size())}},
+                          secure_password))};
+
+  uint64_t serialised_timestamp{0};
+  boost::optional<Identity> optional_unique_user_id, optional_root_parent_id;
+  std::uint32_t app_count{0};
+
+  InputVectorStream binary_input_stream{
+      SerialisedData(serialised_delta.string().begin(), serialised_delta.string().end())};
+  BinaryInputArchive input_archive{binary_input_stream};
+  input_archive(base_account_name, index, serialised_timestamp, ip, port, optional_unique_user_id,
+                optional_root_parent_id, config_file_aes_key_and_iv, app_count);
+  updated_apps.reserve(app_count);
+  for (std::uint32_t i{0}; i < app_count; ++i)
+    updated_apps.push_back(ParseApp(input_archive));
+  input_archive(removed_apps);
+
+  timestamp = TimeStampToPtime(serialised_timestamp);
+  if (optional_unique_user_id)
+    unique_user_id = *optional_unique_user_id;
+  if (optional_root_parent_id)
+    root_parent_id = *optional_root_parent_id;
+}
+
+void ApplyAccountDelta(AccountDelta&& delta, Account& account) {
+  account.timestamp = std::move(delta.timestamp);
+  account.ip = std::move(delta.ip);
+  account.port = std::move(delta.port);
+  account.unique_user_id = std::move(delta.unique_user_id);
+  account.root_parent_id = std::move(delta.root_parent_id);
+  account.config_file_aes_key_and_iv = std::move(delta.config_file_aes_key_and_iv);
+  for (const auto& removed_app_name : delta.removed_apps)
+    account.apps.Erase(removed_app_name);
+  for (auto& updated_app : delta.updated_apps)
+    account.apps.InsertOrReplace(std::move(updated_app));
+}
+
 }  // namespace launcher
 
 }  // namespace maidsafe
@@ -20,9 +20,11 @@
 #define MAIDSAFE_LAUNCHER_ACCOUNT_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "asio/ip/address.hpp"
 #include "boost/date_time/posix_time/ptime.hpp"
@@ -35,6 +37,7 @@
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/app_registry.h"
 
 namespace maidsafe {
 
@@ -42,21 +45,50 @@ namespace launcher {
 
 struct Account;
 
+// Digests of the network-held fields (name, permitted_dirs and icon_id) of each app, keyed by app
+// name.  Used to identify which apps have changed since the last full save of the account.
+using AppDigests = std::map<AppName, crypto::SHA512Hash>;
+
 // Used when saving account.  Updates 'timestamp', serialises the account, then encrypts this.
 // Throws on error.
 ImmutableData EncryptAccount(const authentication::UserCredentials& user_credentials,
                              Account& account);
 
+// Used when saving account incrementally.  Updates 'timestamp', then serialises every field except
+// 'passport', but only includes the apps which differ from those recorded in 'base_app_digests' and
+// the names of apps which have been removed since.  The result is encrypted and chained off the
+// full account chunk named 'base_account_name'.  Only the apps in 'account.apps.ChangedApps()' are
+// compared with 'base_app_digests', so that set mustn't have been cleared since the base account
+// was saved.  Throws on error.
+ImmutableData EncryptAccountDelta(const authentication::UserCredentials& user_credentials,
+                                  const Identity& base_account_name,
+                                  const AppDigests& base_app_digests, std::uint32_t delta_index,
+                                  Account& account);
+
+// Returns true if 'encrypted_account' was created by 'EncryptAccountDelta' rather than by
+// 'EncryptAccount'.
+bool IsAccountDelta(const ImmutableData& encrypted_account);
+
+AppDigests GetAppDigests(const AppRegistry& apps);
+
 struct Account {
   // Used when creating a new user account, i.e. registering a new user on the network rather than
   // logging back in.  Creates a new default-constructed passport.  Throws on error.
   explicit Account(const passport::MaidAndSigner& maid_and_signer);
 
-  // Used when logging in.  Parses account from previously-serialised and encrypted account.  Throws
-  // on error.
+  // Used when logging in.  Parses account from previously-serialised and encrypted account, leaving
+  // 'apps.ChangedApps()' empty.  Accounts saved before icons were moved out of the account are
+  // also accepted; for these, each app with an icon has both 'icon' and 'icon_id' set, and the icon
+  // still needs to be stored as a chunk.  Throws on error.
   Account(const ImmutableData& encrypted_account,
           const authentication::UserCredentials& user_credentials);
 
+  // As above, but using 'secure_password' (which must have been created from 'user_credentials')
+  // rather than deriving it again.
+  Account(const ImmutableData& encrypted_account,
+          const authentication::UserCredentials& user_credentials,
+          const crypto::SecurePassword& secure_password);
+
   // Move-constructible and move-assignable only.
   Account(const Account&) = delete;
   Account(Account&& other) MAIDSAFE_NOEXCEPT;
@@ -69,11 +101,41 @@ struct Account {
   uint16_t port;
   Identity unique_user_id, root_parent_id;
   crypto::AES256KeyAndIV config_file_aes_key_and_iv;
-  std::set<AppDetails> apps;
+  AppRegistry apps;
 };
 
 void swap(Account& lhs, Account& rhs) MAIDSAFE_NOEXCEPT;
 
+// The changes made to an account since its last full save.  Only the apps which have been added or
+// modified are held in 'updated_apps'; all other non-passport fields are held in full.
+struct AccountDelta {
+  // Parses delta from previously-serialised and encrypted delta.  Throws on error.
+  AccountDelta(const ImmutableData& encrypted_delta,
+               const authentication::UserCredentials& user_credentials);
+  AccountDelta(const ImmutableData& encrypted_delta,
+               const authentication::UserCredentials& user_credentials,
+               const crypto::SecurePassword& secure_password);
+
+  AccountDelta(const AccountDelta&) = delete;
+  AccountDelta(AccountDelta&&) = delete;
+  AccountDelta& operator=(const AccountDelta&) = delete;
+  AccountDelta& operator=(AccountDelta&&) = delete;
+
+  Identity base_account_name;
+  std::uint32_t index;
+  boost::posix_time::ptime timestamp;
+  asio::ip::address ip;
+  uint16_t port;
+  Identity unique_user_id, root_parent_id;
+  crypto::AES256KeyAndIV config_file_aes_key_and_iv;
+  std::vector<AppDetails> updated_apps;
+  std::set<AppName> removed_apps;
+};
+
+// Applies 'delta' to 'account', which must have been parsed from the full account chunk named
+// 'delta.base_account_name'.
+void ApplyAccountDelta(AccountDelta&& delta, Account& account);
+
 }  // namespace launcher
 
 }  // namespace maidsafe
@@ -0,0 +1,111 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/account_cache.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/encode.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/binary_encoding.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+AccountCache::AccountCache(fs::path directory) : directory_(std::move(directory)) {}
+
+AccountCache::Chunks AccountCache::Get(const Identity& account_location,
+                                       const crypto::SecurePassword& secure_password) const {
+  Chunks chunks;
+  const fs::path file_path(FilePath(account_location));
+  boost::system::error_code ec;
+  if (!fs::exists(file_path, ec))
+    return chunks;
+  try {
+    const std::string contents(
+        crypto::SymmDecrypt(crypto::CipherText{NonEmptyString{ReadFile(file_path).value()}},
+                            secure_password).string());
+    BinaryReader reader{contents};
+    const std::uint32_t chunk_count(reader.ReadUint32());
+    for (std::uint32_t i(0); i < chunk_count; ++i) {
+      Identity name{reader.ReadString()};
+      chunks[std::move(name)] = reader.ReadString();
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Ignoring unreadable account cache " << file_path << ": "
+                  << boost::diagnostic_information(e);
+    chunks.clear();
+  }
+  return chunks;
+}
+
+void AccountCache::Put(const Identity& account_location,
+                       const crypto::SecurePassword& secure_password, const Chunks& chunks) const {
+  std::string contents;
+  AppendUint32(static_cast<std::uint32_t>(chunks.size()), contents);
+  for (const auto& chunk : chunks) {
+    AppendString(chunk.first.string(), contents);
+    AppendString(chunk.second, contents);
+  }
+  const std::string encrypted_contents(
+      crypto::SymmEncrypt(crypto::PlainText{NonEmptyString{contents}}, secure_password)->string());
+
+  if (!fs::exists(directory_))
+    fs::create_directories(directory_);
+  const fs::path file_path(FilePath(account_location));
+  fs::path temp_path(file_path);
+  temp_path += ".tmp";
+  if (!WriteFile(temp_path, encrypted_contents)) {
+    LOG(kError) << "Failed to write account cache " << temp_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  boost::system::error_code ec;
+  fs::rename(temp_path, file_path, ec);
+  if (ec) {
+    LOG(kError) << "Failed to replace account cache " << file_path << ": " << ec.message();
+    fs::remove(temp_path, ec);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+void AccountCache::Remove(const Identity& account_location) const {
+  boost::system::error_code ec;
+  fs::remove(FilePath(account_location), ec);
+  if (ec)
+    LOG(kWarning) << "Failed to remove account cache: " << ec.message();
+}
+
+fs::path AccountCache::FilePath(const Identity& account_location) const {
+  // The account location is itself derived from the keyword and PIN, so it's hashed again rather
+  // than being exposed in the file name.
+  return directory_ /
+         hex::Encode(crypto::Hash<crypto::SHA512>(account_location.string()).string());
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,77 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_ACCOUNT_CACHE_H_
+#define MAIDSAFE_LAUNCHER_ACCOUNT_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Holds on disk a copy of the chunks which make up an account (the account versions and the
+// encrypted account, plus the full account if that's a delta) as last retrieved from or saved to
+// the network, so that logging in can decrypt the account without waiting for the network.  The
+// cached account may be stale, so it should be reconciled with the network once connected.
+//
+// Each account's chunks are held in their own file in 'directory', named after a hash of the
+// account location and encrypted with the account's secure password, so the file can only be read
+// with the credentials which can retrieve the account from the network anyway.  This class is not
+// threadsafe.
+class AccountCache {
+ public:
+  // The serialised chunks, keyed by name.
+  using Chunks = std::map<Identity, std::string>;
+
+  explicit AccountCache(boost::filesystem::path directory);
+
+  AccountCache(const AccountCache&) = delete;
+  AccountCache(AccountCache&&) = delete;
+  AccountCache& operator=(const AccountCache&) = delete;
+  AccountCache& operator=(AccountCache&&) = delete;
+
+  // Returns the cached chunks, or an empty map if there are none.  A corrupt file, or one which
+  // can't be decrypted with 'secure_password', is treated as empty.
+  Chunks Get(const Identity& account_location, const crypto::SecurePassword& secure_password) const;
+
+  // Replaces the cached chunks.  The file is replaced atomically, so a crash while writing leaves
+  // the previous copy intact.  Throws on error.
+  void Put(const Identity& account_location, const crypto::SecurePassword& secure_password,
+           const Chunks& chunks) const;
+
+  // Removes the cached chunks, if any.
+  void Remove(const Identity& account_location) const;
+
+ private:
+  boost::filesystem::path FilePath(const Identity& account_location) const;
+
+  const boost::filesystem::path directory_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_ACCOUNT_CACHE_H_
@@ -18,32 +18,151 @@
 
 #include "maidsafe/launcher/account_getter.h"
 
+#include <chrono>
+#include <functional>
+#include <future>
+#include <limits>
 #include <string>
+#include <utility>
 
+#include "maidsafe/common/application_support_directories.h"
+#include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/on_scope_exit.h"
 
+#include "maidsafe/launcher/bootstrap_cache.h"
 #include "maidsafe/launcher/launcher.h"
 
 namespace maidsafe {
 
 namespace launcher {
 
-std::future<std::unique_ptr<AccountGetter>> AccountGetter::CreateAccountGetter() {
-  return std::async(std::launch::async,
-                    [] { return std::unique_ptr<AccountGetter>(new AccountGetter); });
+namespace {
+
+using SharedAccountGetterFuture = std::shared_future<std::shared_ptr<AccountGetter>>;
+
+// How often a caller blocked in 'GetShared' or 'Get' checks its cancellation token.
+const std::chrono::milliseconds kCancellationPollInterval(100);
+
+std::mutex& SharedAccountGetterMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+SharedAccountGetterFuture& SharedAccountGetter() {
+  static SharedAccountGetterFuture shared_account_getter;
+  return shared_account_getter;
+}
+
+// Used to abort the shared instance's join via 'CancelShared'.
+CancellationToken& SharedCancellationToken() {
+  static CancellationToken cancellation_token;
+  return cancellation_token;
+}
+
+// Returns true if the shared instance doesn't exist, failed to be created or has since lost its
+// connection.  Doesn't block if the shared instance is still being created.
+bool SharedAccountGetterNeedsReplacing(const SharedAccountGetterFuture& account_getter_future) {
+  if (!account_getter_future.valid())
+    return true;
+  if (account_getter_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return false;
+  try {
+    return !account_getter_future.get()->IsConnected();
+  } catch (const std::exception&) {
+    return true;
+  }
+}
+
+// Must be called while holding 'SharedAccountGetterMutex'.
+void ReplaceSharedAccountGetterIfRequired(
+    std::function<SharedAccountGetterFuture(CancellationToken)> create_functor) {
+  if (SharedAccountGetterNeedsReplacing(SharedAccountGetter())) {
+    SharedCancellationToken() = CancellationToken();
+    SharedAccountGetter() = create_functor(SharedCancellationToken());
+  }
+}
+
+}  // unnamed namespace
+
+const std::chrono::steady_clock::duration AccountGetter::kJoinTimeout(std::chrono::minutes(2));
+
+#ifndef USE_FAKE_STORE
+const std::size_t AccountGetter::kMaxParallelJoins = 4;
+const std::size_t AccountGetter::kNoWinningAttempt = std::numeric_limits<std::size_t>::max();
+#endif
+
+std::future<std::unique_ptr<AccountGetter>> AccountGetter::CreateAccountGetter(
+    CancellationToken cancellation_token) {
+  return std::async(std::launch::async, [cancellation_token] {
+    return std::unique_ptr<AccountGetter>(new AccountGetter{cancellation_token});
+  });
+}
+
+void AccountGetter::PrewarmShared() {
+  std::lock_guard<std::mutex> lock{SharedAccountGetterMutex()};
+  ReplaceSharedAccountGetterIfRequired(CreateSharedAccountGetter);
+}
+
+std::shared_ptr<AccountGetter> AccountGetter::GetShared(
+    const CancellationToken& cancellation_token) {
+  SharedAccountGetterFuture account_getter_future;
+  {
+    std::lock_guard<std::mutex> lock{SharedAccountGetterMutex()};
+    ReplaceSharedAccountGetterIfRequired(CreateSharedAccountGetter);
+    account_getter_future = SharedAccountGetter();
+  }
+  while (account_getter_future.wait_for(kCancellationPollInterval) != std::future_status::ready)
+    cancellation_token.ThrowIfCancelled();
+  return account_getter_future.get();
+}
+
+void AccountGetter::ReleaseShared() {
+  SharedAccountGetterFuture account_getter_future;
+  {
+    std::lock_guard<std::mutex> lock{SharedAccountGetterMutex()};
+    std::swap(account_getter_future, SharedAccountGetter());
+  }
+  // Allow 'account_getter_future' to be destroyed outside the lock, since this may block while
+  // the instance is still being created.
 }
 
-AccountGetter::AccountGetter()
+void AccountGetter::CancelShared() {
+  {
+    std::lock_guard<std::mutex> lock{SharedAccountGetterMutex()};
+    SharedCancellationToken().Cancel();
+  }
+  ReleaseShared();
+}
+
+std::shared_future<std::shared_ptr<AccountGetter>> AccountGetter::CreateSharedAccountGetter(
+    CancellationToken cancellation_token) {
+  return std::async(std::launch::async, [cancellation_token] {
+    return std::shared_ptr<AccountGetter>(new AccountGetter{cancellation_token});
+  }).share();
+}
+
+bool AccountGetter::IsConnected() const {
+#ifdef USE_FAKE_STORE
+  return true;
+#else
+  std::lock_guard<std::mutex> lock{network_health_mutex_};
+  return join_attempts_[winning_attempt_].network_health >= 0;
+#endif
+}
+
+AccountGetter::AccountGetter(const CancellationToken& cancellation_token)
     : network_health_mutex_(),
       network_health_condition_variable_(),
-      network_health_(-1),
 #ifdef ROUTING_AND_NFS_UPDATED
 #ifdef USE_FAKE_STORE
       data_getter_(maidsafe::make_unique<DataGetter>(Launcher::FakeStorePath(),
                                                      Launcher::FakeStoreDiskUsage())),
 #else
-      routing_(maidsafe::make_unique<routing::Routing>()),
-      data_getter_(),  // deferred construction until asio service is created
+      join_attempts_(),
+      winning_attempt_(kNoWinningAttempt),
+      routing_(),      // deferred construction until a join attempt has succeeded
+      data_getter_(),  // deferred construction until a join attempt has succeeded
 #endif
 #else
       data_getter_(maidsafe::make_unique<DataGetter>(
@@ -51,13 +170,27 @@ AccountGetter::AccountGetter()
 #endif
       //      public_pmid_helper_(),
       asio_service_(2) {
+  cancellation_token.ThrowIfCancelled();
 #ifndef USE_FAKE_STORE
-  data_getter_ = maidsafe::make_unique<DataGetter>(asio_service_, *routing_);
-  InitRouting();
+  InitRouting(cancellation_token);
   static_cast<void>(data_getter);
 #endif
 }
 
+std::string AccountGetter::Get(const Data::NameAndTypeId& name_and_type_id,
+                               const CancellationToken& cancellation_token,
+                               std::chrono::steady_clock::time_point deadline) {
+  ThrowIfCancelledOrExpired(cancellation_token, deadline);
+  auto task(std::make_shared<std::packaged_task<std::string()>>([this, name_and_type_id] {
+    return data_getter_->Get(name_and_type_id).string();
+  }));
+  auto future(task->get_future());
+  asio_service_.service().post([task] { (*task)(); });
+  while (future.wait_for(kCancellationPollInterval) != std::future_status::ready)
+    ThrowIfCancelledOrExpired(cancellation_token, deadline);
+  return future.get();
+}
+
 AccountGetter::~AccountGetter() {
 #ifndef USE_FAKE_STORE
   data_getter_->Stop();
@@ -67,40 +200,131 @@ AccountGetter::~AccountGetter() {
 
 #ifndef USE_FAKE_STORE
 
-void AccountGetter::InitRouting() {
-  routing::Functors functors(InitialiseRoutingCallbacks());
-  routing_->Join(functors);
-  // FIXME BEFORE_RELEASE discuss: parallel attempts, max no. of endpoints to try,
-  // prioritise live ports. To reduce the blocking duration in case of no network connectivity
-  std::unique_lock<std::mutex> lock{network_health_mutex_};
-  network_health_condition_variable_.wait(
-      lock, [this] { return (network_health_ == 100) || (network_health_ < -300000); });
-  if (network_health_ < 0)
+void AccountGetter::InitRouting(const CancellationToken& cancellation_token) {
+  // Race joins via several bootstrap endpoints at once, favouring those which have been quickest
+  // previously, and keep whichever succeeds first.  This bounds the blocking duration by the
+  // fastest reachable endpoint rather than by the sum of the timeouts of all unreachable ones.
+  BootstrapCache bootstrap_cache{GetUserAppDir() / "bootstrap_cache"};
+  std::vector<routing::BootstrapContacts> candidate_contacts;
+  for (const auto& endpoint : bootstrap_cache.GetPrioritised(kMaxParallelJoins - 1))
+    candidate_contacts.emplace_back(1, endpoint);
+  // Routing's default contacts are always tried too, in case none of the cached ones are reachable.
+  candidate_contacts.emplace_back();
+
+  join_attempts_.resize(candidate_contacts.size());
+  for (std::size_t i(0); i < join_attempts_.size(); ++i) {
+    join_attempts_[i].routing = maidsafe::make_unique<routing::Routing>();
+    join_attempts_[i].bootstrap_contacts = std::move(candidate_contacts[i]);
+    join_attempts_[i].network_health = -1;
+  }
+
+  const auto join_start(std::chrono::steady_clock::now());
+  for (std::size_t i(0); i < join_attempts_.size(); ++i) {
+    routing::Functors functors(InitialiseRoutingCallbacks(i, join_attempts_[i].routing->kNodeId()));
+    join_attempts_[i].routing->Join(functors, join_attempts_[i].bootstrap_contacts);
+  }
+
+  // Wake the wait below if the join is cancelled.
+  auto cancellation_handler_id(cancellation_token.AddHandler([this] {
+    std::lock_guard<std::mutex> lock{network_health_mutex_};
+    network_health_condition_variable_.notify_all();
+  }));
+  on_scope_exit remove_cancellation_handler{
+      [&] { cancellation_token.RemoveHandler(cancellation_handler_id); }};
+
+  std::size_t winning_attempt(kNoWinningAttempt);
+  std::vector<std::size_t> failed_attempts;
+  routing::BootstrapContacts reported_contacts;
+  {
+    std::unique_lock<std::mutex> lock{network_health_mutex_};
+    network_health_condition_variable_.wait_until(lock, join_start + kJoinTimeout, [&] {
+      if (cancellation_token.IsCancelled())
+        return true;
+      failed_attempts.clear();
+      for (std::size_t i(0); i < join_attempts_.size(); ++i) {
+        if (join_attempts_[i].network_health == 100) {
+          winning_attempt = i;
+          return true;
+        }
+        if (join_attempts_[i].network_health < -300000)
+          failed_attempts.push_back(i);
+      }
+      return failed_attempts.size() == join_attempts_.size();
+    });
+    if (winning_attempt != kNoWinningAttempt)
+      reported_contacts = join_attempts_[winning_attempt].reported_contacts;
+  }
+  const auto join_duration(std::chrono::steady_clock::now() - join_start);
+
+  for (auto failed_attempt : failed_attempts) {
+    if (!join_attempts_[failed_attempt].bootstrap_contacts.empty())
+      bootstrap_cache.RecordFailure(join_attempts_[failed_attempt].bootstrap_contacts.front());
+  }
+  // A default join still records the endpoints it bootstrapped via, so that cached endpoints are
+  // raced from the next join onwards.
+  if (winning_attempt != kNoWinningAttempt) {
+    bootstrap_cache.RecordJoinSuccess(join_attempts_[winning_attempt].bootstrap_contacts,
+                                      reported_contacts, join_duration);
+  }
+  try {
+    bootstrap_cache.Save();
+  } catch (const std::exception& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+  }
+
+  // Destroy the losing attempts.  Their entries in 'join_attempts_' are kept, since their
+  // 'network_status' functors fire on destruction.
+  for (std::size_t i(0); i < join_attempts_.size(); ++i) {
+    if (i != winning_attempt)
+      join_attempts_[i].routing.reset();
+  }
+  if (winning_attempt == kNoWinningAttempt) {
+    ThrowIfCancelledOrExpired(cancellation_token, join_start + kJoinTimeout);
     BOOST_THROW_EXCEPTION(MakeError(RoutingErrors::not_connected));
+  }
+
+  routing_ = std::move(join_attempts_[winning_attempt].routing);
+  data_getter_ = maidsafe::make_unique<DataGetter>(asio_service_, *routing_);
+  winning_attempt_ = winning_attempt;
 }
 
-routing::Functors AccountGetter::InitialiseRoutingCallbacks() {
+routing::Functors AccountGetter::InitialiseRoutingCallbacks(std::size_t attempt_index,
+                                                           const NodeId& this_node_id) {
+  // Messages are only handled once this attempt has won the race, since 'data_getter_' doesn't
+  // exist until then and is bound to the winning attempt's routing object.
   routing::Functors functors;
-  functors.typed_message_and_caching.group_to_single.message_received = [this](
-      const routing::GroupToSingleMessage& message) { data_getter_->HandleMessage(message); };
+  functors.typed_message_and_caching.group_to_single.message_received =
+      [this, attempt_index](const routing::GroupToSingleMessage& message) {
+        if (IsWinningAttempt(attempt_index))
+          data_getter_->HandleMessage(message);
+      };
   // Copying routing node id as routing object on destruction fires network_status functor.
   // As we take it in account getter's asio thread, it tries to re-enter routing after destruction
-  auto this_node_id = routing_->kNodeId();
-  functors.network_status = [this, this_node_id](const int& network_health) {
-    OnNetworkStatusChange(network_health, this_node_id);
+  functors.network_status = [this, attempt_index, this_node_id](const int& network_health) {
+    OnNetworkStatusChange(network_health, attempt_index, this_node_id);
   };
   functors.close_nodes_change =
       [this](std::shared_ptr<routing::CloseNodesChange> /*close_nodes_change*/) {};
-  functors.request_public_key =
-      [this](const NodeId& node_id, const routing::GivePublicKeyFunctor& give_key) {
+  functors.new_bootstrap_contact =
+      [this, attempt_index](const routing::BootstrapContact& bootstrap_contact) {
+        std::lock_guard<std::mutex> lock{network_health_mutex_};
+        join_attempts_[attempt_index].reported_contacts.push_back(bootstrap_contact);
+      };
+  functors.request_public_key = [this, attempt_index](
+      const NodeId& node_id, const routing::GivePublicKeyFunctor& give_key) {
+        if (!IsWinningAttempt(attempt_index))
+          return;
         auto future_key(data_getter_->Get(passport::PublicPmid::Name{Identity{node_id.string()}},
                                           std::chrono::seconds(10)));
         public_pmid_helper_.AddEntry(std::move(future_key), give_key);
       };
 
   // Required to pick cached messages
-  functors.typed_message_and_caching.single_to_single.message_received = [this](
-      const routing::SingleToSingleMessage& message) { data_getter_->HandleMessage(message); };
+  functors.typed_message_and_caching.single_to_single.message_received =
+      [this, attempt_index](const routing::SingleToSingleMessage& message) {
+        if (IsWinningAttempt(attempt_index))
+          data_getter_->HandleMessage(message);
+      };
 
   // TODO(Prakash) fix routing asserts for clients so private_client need not to provide callbacks
   // for all functors
@@ -120,13 +344,24 @@ routing::Functors AccountGetter::InitialiseRoutingCallbacks() {
   return functors;
 }
 
-void AccountGetter::OnNetworkStatusChange(int updated_network_health, const NodeId& node_id) {
+void AccountGetter::OnNetworkStatusChange(int updated_network_health, std::size_t attempt_index,
+                                          const NodeId& node_id) {
   asio_service_.service().post([=] {
-    routing::UpdateNetworkHealth(updated_network_health, network_health_, network_health_mutex_,
-                                 network_health_condition_variable_, node_id);
+    routing::UpdateNetworkHealth(updated_network_health,
+                                 join_attempts_[attempt_index].network_health,
+                                 network_health_mutex_, network_health_condition_variable_,
+                                 node_id);
+    // If this is the shared instance, it will be replaced on the next call to 'PrewarmShared' or
+    // 'GetShared'.
+    if (updated_network_health < 0 && IsWinningAttempt(attempt_index))
+      LOG(kWarning) << "AccountGetter has lost its connection to the network.";
   });
 }
 
+bool AccountGetter::IsWinningAttempt(std::size_t attempt_index) const {
+  return winning_attempt_ == attempt_index;
+}
+
 #endif
 
 }  // namespace launcher
@@ -19,10 +19,14 @@
 #ifndef MAIDSAFE_LAUNCHER_ACCOUNT_GETTER_H_
 #define MAIDSAFE_LAUNCHER_ACCOUNT_GETTER_H_
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "asio/ip/udp.hpp"
@@ -31,6 +35,7 @@
 #include "maidsafe/common/rsa.h"
 // #include "maidsafe/nfs/public_pmid_helper.h"
 
+#include "maidsafe/launcher/cancellation_token.h"
 #include "maidsafe/launcher/types.h"
 
 namespace maidsafe {
@@ -42,8 +47,9 @@ class AccountHandler;
 // This class is only used to establish and maintain a non-authenticated connection to the network.
 // It can be used during a login attempt to retrieve the encrypted account packet.  It is more
 // efficient to keep a single instance of this class alive until the login has succeeded to avoid
-// the cost or re-connecting to the network with every login attempt.  Other than the static factory
-// function, it has no public functions.  The friend class 'AccountHandler' is the only one
+// the cost or re-connecting to the network with every login attempt.  The static 'GetShared'
+// function provides such a process-wide instance.  Other than the static functions and
+// 'IsConnected', it has no public functions.  The friend class 'AccountHandler' is the only one
 // which makes use of this class.
 class AccountGetter {
  public:
@@ -53,23 +59,82 @@ class AccountGetter {
   AccountGetter& operator=(const AccountGetter&) = delete;
   AccountGetter& operator=(AccountGetter&&) = delete;
 
-  static std::future<std::unique_ptr<AccountGetter>> CreateAccountGetter();
+  // Joins the network on a worker thread.  The future holds 'AsioErrors::operation_aborted' if
+  // 'cancellation_token' is cancelled, or 'AsioErrors::timed_out' if joining takes longer than
+  // 'kJoinTimeout'.
+  static std::future<std::unique_ptr<AccountGetter>> CreateAccountGetter(
+      CancellationToken cancellation_token = CancellationToken());
+
+  // Starts creating the process-wide shared instance on a worker thread if it doesn't already exist
+  // or if it has lost its connection to the network.  Doesn't block.  Threadsafe.
+  static void PrewarmShared();
+
+  // Returns the process-wide shared instance, blocking until it has joined the network.  The same
+  // instance is returned by subsequent calls for as long as it remains connected, so e.g. a login
+  // retry after a mistyped password doesn't need to re-join the network.  Throws on error, in which
+  // case the next call will try to create a new instance.  If 'cancellation_token' is cancelled,
+  // stops waiting and throws 'AsioErrors::operation_aborted', but the shared instance carries on
+  // joining for use by a subsequent call.  Threadsafe.
+  static std::shared_ptr<AccountGetter> GetShared(
+      const CancellationToken& cancellation_token = CancellationToken());
+
+  // Releases the process-wide shared instance, e.g. once a login has succeeded.  The instance is
+  // destroyed once all other holders of it have released it too.  Threadsafe.
+  static void ReleaseShared();
+
+  // As 'ReleaseShared', but if the shared instance is still joining the network, aborts the join
+  // rather than waiting for it to complete, e.g. on application shutdown.  Threadsafe.
+  static void CancelShared();
+
+  // Returns false if the network health has dropped below zero since the network was joined.
+  bool IsConnected() const;
 
   friend class AccountHandler;
 
+  static const std::chrono::steady_clock::duration kJoinTimeout;
+
  private:
-  AccountGetter();
+  explicit AccountGetter(const CancellationToken& cancellation_token);
+  static std::shared_future<std::shared_ptr<AccountGetter>> CreateSharedAccountGetter(
+      CancellationToken cancellation_token);
 #ifndef USE_FAKE_STORE
-  void InitRouting();
-  routing::Functors InitialiseRoutingCallbacks();
-  void OnNetworkStatusChange(int updated_network_health, const NodeId& this_node_id);
+  // A single attempt to join the network.  Several of these are raced against each other, and the
+  // first to succeed is kept.  Each uses a single bootstrap endpoint, except for one which uses the
+  // default bootstrap contacts as a fallback.  'reported_contacts' holds the contacts routing has
+  // reported via its 'new_bootstrap_contact' functor, guarded by 'network_health_mutex_'.
+  struct JoinAttempt {
+    std::unique_ptr<routing::Routing> routing;
+    routing::BootstrapContacts bootstrap_contacts;
+    routing::BootstrapContacts reported_contacts;
+    int network_health;
+  };
+
+  void InitRouting(const CancellationToken& cancellation_token);
+  routing::Functors InitialiseRoutingCallbacks(std::size_t attempt_index,
+                                               const NodeId& this_node_id);
+  void OnNetworkStatusChange(int updated_network_health, std::size_t attempt_index,
+                             const NodeId& this_node_id);
+  bool IsWinningAttempt(std::size_t attempt_index) const;
+
+  static const std::size_t kMaxParallelJoins;
+  static const std::size_t kNoWinningAttempt;
 #endif
   DataGetter& data_getter() { return *data_getter_; }
 
-  std::mutex network_health_mutex_;
+  // Retrieves the chunk identified by 'name_and_type_id' on this instance's threads.  The caller
+  // stops waiting and throws 'AsioErrors::timed_out' if 'deadline' passes, or
+  // 'AsioErrors::operation_aborted' if 'cancellation_token' is cancelled, before the chunk arrives;
+  // the retrieval itself is then abandoned.  Otherwise throws on error.
+  std::string Get(const Data::NameAndTypeId& name_and_type_id,
+                  const CancellationToken& cancellation_token,
+                  std::chrono::steady_clock::time_point deadline);
+
+  mutable std::mutex network_health_mutex_;
   std::condition_variable network_health_condition_variable_;
-  int network_health_;
 #ifndef USE_FAKE_STORE
+  // Sized once in 'InitRouting' and never resized, since routing callbacks index into it.
+  std::vector<JoinAttempt> join_attempts_;
+  std::atomic<std::size_t> winning_attempt_;
   std::unique_ptr<routing::Routing> routing_;
 #endif
   std::unique_ptr<DataGetter> data_getter_;
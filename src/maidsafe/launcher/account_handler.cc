@@ -31,6 +31,7 @@
 #include "maidsafe/common/data_types/mutable_data.h"
 
 #include "maidsafe/launcher/account_getter.h"
+#include "maidsafe/launcher/profiler.h"
 
 namespace maidsafe {
 
@@ -42,27 +43,76 @@ Identity GetAccountLocation(const authentication::UserCredentials::Keyword& keyw
                                                pin.Hash<crypto::SHA512>().string())};
 }
 
-AccountHandler::AccountHandler() : account_(), account_versions_(20, 1), user_credentials_() {}
+DerivedCredentials DeriveCredentials(const authentication::UserCredentials& user_credentials) {
+  Profiler::Scope scope{"crypto", "DeriveCredentials"};
+  return DerivedCredentials{
+      GetAccountLocation(*user_credentials.keyword, *user_credentials.pin),
+      authentication::CreateSecurePassword(user_credentials)};
+}
+
+struct AccountHandler::RetrievedAccount {
+  RetrievedAccount()
+      : versions_value(), account(), base_account_name(), base_app_digests(), delta_count(0),
+        chunks() {}
+
+  NonEmptyString versions_value;
+  std::unique_ptr<Account> account;
+  Identity base_account_name;
+  AppDigests base_app_digests;
+  std::uint32_t delta_count;
+  AccountCache::Chunks chunks;
+};
+
+const std::uint32_t AccountHandler::kMaxDeltaCount(10);
+const std::chrono::steady_clock::duration AccountHandler::kRetrievalTimeout(
+    std::chrono::minutes(1));
+
+AccountHandler::AccountHandler()
+    : account_(),
+      account_versions_(20, 1),
+      user_credentials_(),
+      base_account_name_(),
+      base_app_digests_(),
+      delta_count_(0),
+      derived_credentials_(),
+      account_chunks_(),
+      retrieved_() {}
 
 AccountHandler::AccountHandler(Account&& account,
                                authentication::UserCredentials&& user_credentials,
-                               NetworkClient& network_client)
+                               NetworkClient& network_client,
+                               const CancellationToken& cancellation_token)
     : account_(maidsafe::make_unique<Account>(std::move(account))),
       account_versions_(20, 1),
-      user_credentials_(std::move(user_credentials)) {
+      user_credentials_(std::move(user_credentials)),
+      base_account_name_(),
+      base_app_digests_(),
+      delta_count_(0),
+      derived_credentials_(),
+      account_chunks_(),
+      retrieved_() {
   // throw if private_client & account are not coherent
   // TODO(Prakash) Validate credentials
   Identity account_location{GetAccountLocation(*user_credentials_.keyword, *user_credentials_.pin)};
   ImmutableData encrypted_account{EncryptAccount(user_credentials_, *account_)};
+  // Once storing has started, it's allowed to complete rather than risk leaving a partial account.
+  cancellation_token.ThrowIfCancelled();
   MutableData account_versions_wrapper;
   try {
-    network_client.Store(encrypted_account.NameAndType(),
-                         NonEmptyString(Serialise(encrypted_account)));
+    Profiler::Scope scope{"network", "StoreAccount"};
+    const NonEmptyString serialised_account(Serialise(encrypted_account));
+    network_client.Store(encrypted_account.NameAndType(), serialised_account);
     StructuredDataVersions::VersionName first_version(0, encrypted_account.Name());
     account_versions_.Put(StructuredDataVersions::VersionName(), first_version);
     account_versions_wrapper = MutableData(account_location, account_versions_.Serialise());
-    network_client.Store(account_versions_wrapper.NameAndType(),
-                         NonEmptyString(Serialise(account_versions_wrapper)));
+    const NonEmptyString serialised_versions(Serialise(account_versions_wrapper));
+    network_client.Store(account_versions_wrapper.NameAndType(), serialised_versions);
+    scope.AddBytes(serialised_account.string().size() + serialised_versions.string().size());
+    base_account_name_ = encrypted_account.Name();
+    base_app_digests_ = GetAppDigests(account_->apps);
+    account_->apps.ClearChanged();
+    account_chunks_[account_location] = serialised_versions.string();
+    account_chunks_[encrypted_account.Name()] = serialised_account.string();
   } catch (const std::exception& e) {
     LOG(kError) << "Failed to store account: " << boost::diagnostic_information(e);
     network_client.Delete(encrypted_account.NameAndType());
@@ -72,29 +122,34 @@ AccountHandler::AccountHandler(Account&& account,
   }
 }
 
+AccountHandler::~AccountHandler() {}
+
 void AccountHandler::Login(authentication::UserCredentials&& user_credentials,
-                           AccountGetter& account_getter) {
+                           AccountGetter& account_getter,
+                           const CancellationToken& cancellation_token) {
+  if (account_ && account_->passport)  // already logged in
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  DerivedCredentials derived_credentials{DeriveCredentials(user_credentials)};
+  Login(std::move(user_credentials), derived_credentials, account_getter, cancellation_token);
+}
+
+void AccountHandler::Login(authentication::UserCredentials&& user_credentials,
+                           const DerivedCredentials& derived_credentials,
+                           AccountGetter& account_getter,
+                           const CancellationToken& cancellation_token) {
   if (account_ && account_->passport)  // already logged in
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
 
-  Identity account_location{GetAccountLocation(*user_credentials.keyword, *user_credentials.pin)};
   try {
-    MutableData account_versions_wrapper(
-        Parse<MutableData>(account_getter.data_getter()
-                               .Get(Data::NameAndTypeId(account_location, DataTypeId(1)))
-                               .string()));
-    account_versions_.ApplySerialised(
-        StructuredDataVersions::serialised_type(account_versions_wrapper.Value()));
-    auto versions(account_versions_.Get());
-    assert(versions.size() == 1U);
-    // TODO(Fraser#5#): 2014-04-17 - Get more than just the latest version - possibly just for the
-    // case where the latest one fails.  Or just throw, but add 'int version_number' to this
-    // function's signature where 0 == most recent, 1 == second newest, etc.
-    ImmutableData encrypted_account(
-        Parse<ImmutableData>(account_getter.data_getter()
-                                 .Get(Data::NameAndTypeId(versions.at(0).id, DataTypeId(0)))
-                                 .string()));
-    account_ = maidsafe::make_unique<Account>(encrypted_account, user_credentials);
+    auto retrieved(Retrieve(user_credentials, derived_credentials,
+                            [&](const Identity& name, DataTypeId type_id,
+                                std::chrono::steady_clock::time_point deadline) {
+                              return account_getter.Get(Data::NameAndTypeId(name, type_id),
+                                                        cancellation_token, deadline);
+                            },
+                            cancellation_token));
+    Adopt(std::move(*retrieved));
+    derived_credentials_ = maidsafe::make_unique<DerivedCredentials>(derived_credentials);
     user_credentials_ = std::move(user_credentials);
   } catch (const std::exception& e) {
     LOG(kError) << "Failed to login: " << boost::diagnostic_information(e);
@@ -102,14 +157,162 @@ void AccountHandler::Login(authentication::UserCredentials&& user_credentials,
   }
 }
 
-void AccountHandler::Save(NetworkClient& network_client) {
-  // The only member which is modified in this process is the account timestamp.
+bool AccountHandler::LoginFromCache(authentication::UserCredentials&& user_credentials,
+                                    const DerivedCredentials& derived_credentials,
+                                    const AccountCache& account_cache) {
+  if (account_ && account_->passport)  // already logged in
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+
+  AccountCache::Chunks chunks;
+  {
+    Profiler::Scope scope{"account", "ReadAccountCache"};
+    chunks = account_cache.Get(derived_credentials.account_location,
+                               derived_credentials.secure_password);
+    for (const auto& chunk : chunks)
+      scope.AddBytes(chunk.second.size());
+  }
+  if (chunks.empty())
+    return false;
+  try {
+    auto retrieved(Retrieve(user_credentials, derived_credentials,
+                            [&](const Identity& name, DataTypeId,
+                                std::chrono::steady_clock::time_point) {
+                              auto itr(chunks.find(name));
+                              if (itr == std::end(chunks))
+                                BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+                              return itr->second;
+                            },
+                            CancellationToken()));
+    Adopt(std::move(*retrieved));
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Ignoring unusable account cache: " << boost::diagnostic_information(e);
+    return false;
+  }
+  derived_credentials_ = maidsafe::make_unique<DerivedCredentials>(derived_credentials);
+  user_credentials_ = std::move(user_credentials);
+  return true;
+}
+
+bool AccountHandler::RetrieveLatest(AccountGetter& account_getter,
+                                    const CancellationToken& cancellation_token) {
+  assert(account_ && derived_credentials_);
+  // Only the versions are retrieved unless they show the account has changed.
+  const auto deadline(std::chrono::steady_clock::now() + kRetrievalTimeout);
+  MutableData account_versions_wrapper(Parse<MutableData>(account_getter.Get(
+      Data::NameAndTypeId(derived_credentials_->account_location, DataTypeId(1)),
+      cancellation_token, deadline)));
+  StructuredDataVersions latest_versions(20, 1);
+  latest_versions.ApplySerialised(
+      StructuredDataVersions::serialised_type(account_versions_wrapper.Value()));
+  const auto latest_version(latest_versions.Get().at(0));
+  const auto current_version(account_versions_.Get().at(0));
+  if (latest_version.index == current_version.index && latest_version.id == current_version.id) {
+    retrieved_.reset();
+    return false;
+  }
+
+  LOG(kInfo) << "Account has changed since it was cached; retrieving latest version.";
+  retrieved_ = Retrieve(user_credentials_, *derived_credentials_,
+                        [&](const Identity& name, DataTypeId type_id,
+                            std::chrono::steady_clock::time_point deadline) {
+                          return account_getter.Get(Data::NameAndTypeId(name, type_id),
+                                                    cancellation_token, deadline);
+                        },
+                        cancellation_token);
+  return true;
+}
+
+void AccountHandler::AdoptRetrieved() {
+  assert(retrieved_);
+  auto retrieved(std::move(retrieved_));
+  Adopt(std::move(*retrieved));
+}
+
+void AccountHandler::StoreInCache(const AccountCache& account_cache) {
+  if (!derived_credentials_) {
+    derived_credentials_ =
+        maidsafe::make_unique<DerivedCredentials>(DeriveCredentials(user_credentials_));
+  }
+  account_cache.Put(derived_credentials_->account_location, derived_credentials_->secure_password,
+                    account_chunks_);
+}
+
+std::unique_ptr<AccountHandler::RetrievedAccount> AccountHandler::Retrieve(
+    const authentication::UserCredentials& user_credentials,
+    const DerivedCredentials& derived_credentials, const ChunkGetter& get_chunk,
+    const CancellationToken& cancellation_token) const {
+  const auto deadline(std::chrono::steady_clock::now() + kRetrievalTimeout);
+  auto retrieved(maidsafe::make_unique<RetrievedAccount>());
+  // Records each chunk as it's retrieved, so that the account can be cached.
+  auto get([&](const Identity& name, DataTypeId type_id) -> const std::string & {
+    ThrowIfCancelledOrExpired(cancellation_token, deadline);
+    Profiler::Scope scope{"account", "GetAccountChunk"};
+    const std::string& chunk(retrieved->chunks[name] = get_chunk(name, type_id, deadline));
+    scope.AddBytes(chunk.size());
+    return chunk;
+  });
+
+  MutableData account_versions_wrapper(
+      Parse<MutableData>(get(derived_credentials.account_location, DataTypeId(1))));
+  retrieved->versions_value = account_versions_wrapper.Value();
+  StructuredDataVersions versions_parser(20, 1);
+  versions_parser.ApplySerialised(
+      StructuredDataVersions::serialised_type(retrieved->versions_value));
+  auto versions(versions_parser.Get());
+  assert(versions.size() == 1U);
+  // TODO(Fraser#5#): 2014-04-17 - Get more than just the latest version - possibly just for the
+  // case where the latest one fails.  Or just throw, but add 'int version_number' to this
+  // function's signature where 0 == most recent, 1 == second newest, etc.
+  ImmutableData encrypted_account(Parse<ImmutableData>(get(versions.at(0).id, DataTypeId(0))));
+  // If the latest version is a delta, the full account it was chained from is also required.
+  std::unique_ptr<AccountDelta> delta;
+  retrieved->base_account_name = encrypted_account.Name();
+  if (IsAccountDelta(encrypted_account)) {
+    delta = maidsafe::make_unique<AccountDelta>(encrypted_account, user_credentials,
+                                                derived_credentials.secure_password);
+    retrieved->base_account_name = delta->base_account_name;
+    encrypted_account =
+        Parse<ImmutableData>(get(retrieved->base_account_name, DataTypeId(0)));
+  }
+  retrieved->account = maidsafe::make_unique<Account>(encrypted_account, user_credentials,
+                                                      derived_credentials.secure_password);
+  retrieved->base_app_digests = GetAppDigests(retrieved->account->apps);
+  retrieved->delta_count = delta ? delta->index : 0;
+  if (delta)
+    ApplyAccountDelta(std::move(*delta), *retrieved->account);
+  return retrieved;
+}
+
+void AccountHandler::Adopt(RetrievedAccount&& retrieved) {
+  account_versions_.ApplySerialised(
+      StructuredDataVersions::serialised_type(retrieved.versions_value));
+  if (account_)
+    swap(*account_, *retrieved.account);
+  else
+    account_ = std::move(retrieved.account);
+  base_account_name_ = std::move(retrieved.base_account_name);
+  base_app_digests_ = std::move(retrieved.base_app_digests);
+  delta_count_ = retrieved.delta_count;
+  account_chunks_ = std::move(retrieved.chunks);
+}
+
+void AccountHandler::Save(NetworkClient& network_client, bool force_full_save) {
+  // The only member which is modified in this process before the save succeeds is the account
+  // timestamp.
   on_scope_exit strong_guarantee{on_scope_exit::RevertValue(account_->timestamp)};
 
-  ImmutableData encrypted_account(EncryptAccount(user_credentials_, *account_));
+  const bool full_save{force_full_save || !base_account_name_.IsInitialised() ||
+                       delta_count_ >= kMaxDeltaCount};
+  ImmutableData encrypted_account(
+      full_save ? EncryptAccount(user_credentials_, *account_)
+                : EncryptAccountDelta(user_credentials_, base_account_name_, base_app_digests_,
+                                      delta_count_ + 1, *account_));
+  AppDigests new_base_app_digests;
+  if (full_save)
+    new_base_app_digests = GetAppDigests(account_->apps);
   try {
-    network_client.Store(encrypted_account.NameAndType(),
-                         NonEmptyString(Serialise(encrypted_account)));
+    const NonEmptyString serialised_account(Serialise(encrypted_account));
+    network_client.Store(encrypted_account.NameAndType(), serialised_account);
     // Get current tip-of-tree and create new version
     auto versions(account_versions_.Get());
     assert(versions.size() == 1U);
@@ -120,9 +323,27 @@ void AccountHandler::Save(NetworkClient& network_client) {
     Identity account_location{
         GetAccountLocation(*user_credentials_.keyword, *user_credentials_.pin)};
     MutableData account_versions_wrapper(account_location, account_versions_.Serialise());
-    network_client.Store(account_versions_wrapper.NameAndType(),
-                         NonEmptyString(Serialise(account_versions_wrapper)));
+    const NonEmptyString serialised_versions(Serialise(account_versions_wrapper));
+    network_client.Store(account_versions_wrapper.NameAndType(), serialised_versions);
 
+    // A delta needs the full account it's chained from to be cached alongside it.
+    AccountCache::Chunks account_chunks;
+    account_chunks[account_location] = serialised_versions.string();
+    account_chunks[encrypted_account.Name()] = serialised_account.string();
+    if (!full_save) {
+      auto base_chunk(account_chunks_.find(base_account_name_));
+      if (base_chunk != std::end(account_chunks_))
+        account_chunks.insert(*base_chunk);
+    }
+    if (full_save) {
+      base_account_name_ = encrypted_account.Name();
+      base_app_digests_ = std::move(new_base_app_digests);
+      delta_count_ = 0;
+      account_->apps.ClearChanged();
+    } else {
+      ++delta_count_;
+    }
+    account_chunks_ = std::move(account_chunks);
     strong_guarantee.Release();
   } catch (const std::exception& e) {
     LOG(kError) << boost::diagnostic_information(e);
@@ -19,14 +19,21 @@
 #ifndef MAIDSAFE_LAUNCHER_ACCOUNT_HANDLER_H_
 #define MAIDSAFE_LAUNCHER_ACCOUNT_HANDLER_H_
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "maidsafe/common/config.h"
+#include "maidsafe/common/crypto.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/authentication/user_credentials.h"
 #include "maidsafe/common/data_types/structured_data_versions.h"
 
 #include "maidsafe/launcher/account.h"
+#include "maidsafe/launcher/account_cache.h"
+#include "maidsafe/launcher/cancellation_token.h"
 #include "maidsafe/launcher/types.h"
 
 namespace maidsafe {
@@ -35,6 +42,22 @@ namespace launcher {
 
 class AccountGetter;
 
+// The values derived from a user's credentials which are needed to locate and decrypt the account.
+// Deriving the secure password is deliberately expensive, so these are independent of the network
+// connection to allow them to be derived while the connection is still being established.
+struct DerivedCredentials {
+  Identity account_location;
+  crypto::SecurePassword secure_password;
+};
+
+// Returns the name of the chunk holding the versions of the account identified by 'keyword' and
+// 'pin'.
+Identity GetAccountLocation(const authentication::UserCredentials::Keyword& keyword,
+                            const authentication::UserCredentials::Pin& pin);
+
+// Throws on error.
+DerivedCredentials DeriveCredentials(const authentication::UserCredentials& user_credentials);
+
 // This class is not threadsafe.
 class AccountHandler {
  public:
@@ -44,9 +67,13 @@ class AccountHandler {
 
   // This constructor should be used when creating a new account, i.e. where a account has never
   // been put to the network.  'network_client' should already be joined to the network.  Internally
-  // saves the first account after creating the new account.  Throws on error.
+  // saves the first account after creating the new account.  Throws on error, including
+  // 'AsioErrors::operation_aborted' if 'cancellation_token' is cancelled before saving starts.
   AccountHandler(Account&& account, authentication::UserCredentials&& user_credentials,
-                 NetworkClient& network_client);
+                 NetworkClient& network_client,
+                 const CancellationToken& cancellation_token = CancellationToken());
+
+  ~AccountHandler();
 
   AccountHandler(const AccountHandler&) = delete;
   AccountHandler(AccountHandler&& other) = delete;
@@ -56,18 +83,78 @@ class AccountHandler {
   // Retrieves and decrypts account info when logging in to an existing account.  'account_getter'
   // should already be joined to the network.  Throws on error, including already having logged in.
   // Provides strong exception guarantee.
-  void Login(authentication::UserCredentials&& user_credentials, AccountGetter& account_getter);
+  //
+  // 'cancellation_token' and 'kRetrievalTimeout' also bound the wait for each chunk, so throws
+  // 'AsioErrors::operation_aborted' if cancelled, or 'AsioErrors::timed_out' if retrieval takes
+  // longer than 'kRetrievalTimeout', even while a chunk is still outstanding.
+  void Login(authentication::UserCredentials&& user_credentials, AccountGetter& account_getter,
+             const CancellationToken& cancellation_token = CancellationToken());
+
+  // As above, but using the previously-derived 'derived_credentials', which must have been created
+  // from 'user_credentials'.  As soon as each chunk arrives it is decrypted without any further key
+  // derivation.
+  void Login(authentication::UserCredentials&& user_credentials,
+             const DerivedCredentials& derived_credentials, AccountGetter& account_getter,
+             const CancellationToken& cancellation_token = CancellationToken());
+
+  // As above, but using the chunks held in 'account_cache' rather than retrieving them from the
+  // network, so no network connection is needed.  The cached account may be stale, so
+  // 'RetrieveLatest' should be called once connected.  Returns false without logging in if the
+  // cache holds no usable copy of the account.  Throws if already logged in.
+  bool LoginFromCache(authentication::UserCredentials&& user_credentials,
+                      const DerivedCredentials& derived_credentials,
+                      const AccountCache& account_cache);
+
+  // Retrieves the latest version of the account from the network.  Returns true if it differs from
+  // the version currently held, in which case it's kept until 'AdoptRetrieved' is called.  This
+  // doesn't modify the account, so it may run while the account is in use elsewhere, but not
+  // concurrently with 'Save'.  Throws as 'Login'.
+  bool RetrieveLatest(AccountGetter& account_getter,
+                      const CancellationToken& cancellation_token = CancellationToken());
+
+  // Replaces the account with the one held by the last 'RetrieveLatest' which returned true.  The
+  // existing 'account_' object is updated in place, so pointers to it remain valid.
+  void AdoptRetrieved();
+
+  // Writes the chunks of the current version of the account to 'account_cache'.  Throws on error.
+  void StoreInCache(const AccountCache& account_cache);
 
   // Saves account on the network using 'network_client', which should already be joined to the
-  // network.  Throws on error, with strong exception guarantee.
-  void Save(NetworkClient& network_client);
+  // network.  Unless 'force_full_save' is true, only the changes since the last full save are
+  // stored (see 'EncryptAccountDelta'), with every 'kMaxDeltaCount'th save being a full one to
+  // compact the chain of deltas.  Throws on error, with strong exception guarantee.
+  void Save(NetworkClient& network_client, bool force_full_save = false);
+
+  static const std::uint32_t kMaxDeltaCount;
+  static const std::chrono::steady_clock::duration kRetrievalTimeout;
 
   // Give full access to the account
   std::unique_ptr<Account> account_;
 
  private:
+  struct RetrievedAccount;
+  // Returns the serialised chunk with the given name and type, giving up at 'deadline'.
+  using ChunkGetter = std::function<std::string(const Identity& name, DataTypeId type_id,
+                                                std::chrono::steady_clock::time_point deadline)>;
+
+  std::unique_ptr<RetrievedAccount> Retrieve(
+      const authentication::UserCredentials& user_credentials,
+      const DerivedCredentials& derived_credentials, const ChunkGetter& get_chunk,
+      const CancellationToken& cancellation_token) const;
+  void Adopt(RetrievedAccount&& retrieved);
+
   StructuredDataVersions account_versions_;
   authentication::UserCredentials user_credentials_;
+  // The name of the most recently saved full account chunk, and digests of its apps.  Deltas are
+  // always made relative to this, so at most two chunks are required to retrieve the account.
+  Identity base_account_name_;
+  AppDigests base_app_digests_;
+  std::uint32_t delta_count_;
+  // Only derived when first needed if this instance created the account.
+  std::unique_ptr<DerivedCredentials> derived_credentials_;
+  // The serialised chunks which make up the current version of the account, for caching.
+  AccountCache::Chunks account_chunks_;
+  std::unique_ptr<RetrievedAccount> retrieved_;
 };
 
 }  // namespace launcher
@@ -0,0 +1,117 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/app_change.h"
+
+#include <utility>
+
+namespace maidsafe {
+
+namespace launcher {
+
+AppChange::AppChange(Type type_in, AppName app_name_in)
+    : type(type_in),
+      app_name(std::move(app_name_in)),
+      new_name(),
+      path(),
+      args(),
+      access_rights(DirectoryInfo::AccessRights::kNone),
+      icon(),
+      auto_start(false) {}
+
+AppChange AppChange::AddApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
+                            SerialisedData app_icon, bool auto_start) {
+  AppChange change{Type::kAddApp, std::move(app_name)};
+  change.path = std::move(app_path);
+  change.args = std::move(app_args);
+  change.icon = std::move(app_icon);
+  change.auto_start = auto_start;
+  return change;
+}
+
+AppChange AppChange::LinkApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
+                             bool auto_start) {
+  AppChange change{Type::kLinkApp, std::move(app_name)};
+  change.path = std::move(app_path);
+  change.args = std::move(app_args);
+  change.auto_start = auto_start;
+  return change;
+}
+
+AppChange AppChange::UpdateAppName(AppName app_name, AppName new_name) {
+  AppChange change{Type::kUpdateAppName, std::move(app_name)};
+  change.new_name = std::move(new_name);
+  return change;
+}
+
+AppChange AppChange::UpdateAppPath(AppName app_name, boost::filesystem::path new_path) {
+  AppChange change{Type::kUpdateAppPath, std::move(app_name)};
+  change.path = std::move(new_path);
+  return change;
+}
+
+AppChange AppChange::UpdateAppArgs(AppName app_name, AppArgs new_args) {
+  AppChange change{Type::kUpdateAppArgs, std::move(app_name)};
+  change.args = std::move(new_args);
+  return change;
+}
+
+AppChange AppChange::UpdateAppSafeDriveAccess(AppName app_name,
+                                              DirectoryInfo::AccessRights new_rights) {
+  AppChange change{Type::kUpdateAppSafeDriveAccess, std::move(app_name)};
+  change.access_rights = new_rights;
+  return change;
+}
+
+AppChange AppChange::UpdateAppIcon(AppName app_name, SerialisedData new_icon) {
+  AppChange change{Type::kUpdateAppIcon, std::move(app_name)};
+  change.icon = std::move(new_icon);
+  return change;
+}
+
+AppChange AppChange::UpdateAppAutoStart(AppName app_name, bool new_auto_start_value) {
+  AppChange change{Type::kUpdateAppAutoStart, std::move(app_name)};
+  change.auto_start = new_auto_start_value;
+  return change;
+}
+
+AppChange AppChange::RemoveAppLocally(AppName app_name) {
+  return AppChange{Type::kRemoveAppLocally, std::move(app_name)};
+}
+
+AppChange AppChange::RemoveAppFromNetwork(AppName app_name) {
+  return AppChange{Type::kRemoveAppFromNetwork, std::move(app_name)};
+}
+
+bool AppChange::AffectsAccount() const {
+  // App paths, args and auto_start values and the local set of apps are only held in the local
+  // config file.
+  switch (type) {
+    case Type::kUpdateAppPath:
+    case Type::kUpdateAppArgs:
+    case Type::kUpdateAppAutoStart:
+    case Type::kRemoveAppLocally:
+      return false;
+    default:
+      return true;
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,85 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_APP_CHANGE_H_
+#define MAIDSAFE_LAUNCHER_APP_CHANGE_H_
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/directory_info.h"
+
+#include "maidsafe/launcher/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// A single change to an app, to be applied as part of a batch via 'Launcher::ApplyChanges'.  Each
+// of the static functions creates a change equivalent to calling the Launcher function of the same
+// name.  Only the fields relevant to 'type' are used.
+struct AppChange {
+  enum class Type {
+    kAddApp,
+    kLinkApp,
+    kUpdateAppName,
+    kUpdateAppPath,
+    kUpdateAppArgs,
+    kUpdateAppSafeDriveAccess,
+    kUpdateAppIcon,
+    kUpdateAppAutoStart,
+    kRemoveAppLocally,
+    kRemoveAppFromNetwork
+  };
+
+  static AppChange AddApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
+                          SerialisedData app_icon, bool auto_start);
+  static AppChange LinkApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
+                           bool auto_start);
+  static AppChange UpdateAppName(AppName app_name, AppName new_name);
+  static AppChange UpdateAppPath(AppName app_name, boost::filesystem::path new_path);
+  static AppChange UpdateAppArgs(AppName app_name, AppArgs new_args);
+  static AppChange UpdateAppSafeDriveAccess(AppName app_name,
+                                            DirectoryInfo::AccessRights new_rights);
+  static AppChange UpdateAppIcon(AppName app_name, SerialisedData new_icon);
+  static AppChange UpdateAppAutoStart(AppName app_name, bool new_auto_start_value);
+  static AppChange RemoveAppLocally(AppName app_name);
+  static AppChange RemoveAppFromNetwork(AppName app_name);
+
+  // Returns true if this change affects the account, and so needs to be reverted by
+  // 'Launcher::RevertToLastSavedSession'.
+  bool AffectsAccount() const;
+
+  Type type;
+  AppName app_name;
+  AppName new_name;
+  boost::filesystem::path path;
+  AppArgs args;
+  DirectoryInfo::AccessRights access_rights;
+  SerialisedData icon;
+  bool auto_start;
+
+ private:
+  AppChange(Type type_in, AppName app_name_in);
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_APP_CHANGE_H_
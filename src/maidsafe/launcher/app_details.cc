@@ -18,13 +18,28 @@
 
 #include "maidsafe/launcher/app_details.h"
 
+#include <string>
 #include <utility>
 
 namespace maidsafe {
 
 namespace launcher {
 
-AppDetails::AppDetails() : name(), path(), args(), permitted_dirs(), icon(), auto_start(false) {}
+namespace {
+
+crypto::AES256KeyAndIV GetIconKeyAndIV(const crypto::AES256KeyAndIV& account_key_and_iv) {
+  const std::string hash{
+      crypto::Hash<crypto::SHA512>(std::string(account_key_and_iv.string().begin(),
+                                               account_key_and_iv.string().end()) +
+                                   "icons").string()};
+  return crypto::AES256KeyAndIV{
+      SerialisedData(hash.begin(), hash.begin() + crypto::AES256_KeySize + crypto::AES256_IVSize)};
+}
+
+}  // unnamed namespace
+
+AppDetails::AppDetails()
+    : name(), path(), args(), permitted_dirs(), icon(), icon_id(), auto_start(false) {}
 
 AppDetails::AppDetails(AppDetails&& other) MAIDSAFE_NOEXCEPT
     : name(std::move(other.name)),
@@ -32,6 +47,7 @@ AppDetails::AppDetails(AppDetails&& other) MAIDSAFE_NOEXCEPT
       args(std::move(other.args)),
       permitted_dirs(std::move(other.permitted_dirs)),
       icon(std::move(other.icon)),
+      icon_id(std::move(other.icon_id)),
       auto_start(std::move(other.auto_start)) {}
 
 AppDetails& AppDetails::operator=(AppDetails&& other) MAIDSAFE_NOEXCEPT {
@@ -40,6 +56,7 @@ AppDetails& AppDetails::operator=(AppDetails&& other) MAIDSAFE_NOEXCEPT {
   args = std::move(other.args);
   permitted_dirs = std::move(other.permitted_dirs);
   icon = std::move(other.icon);
+  icon_id = std::move(other.icon_id);
   auto_start = std::move(other.auto_start);
   return *this;
 }
@@ -51,11 +68,25 @@ void swap(AppDetails& lhs, AppDetails& rhs) MAIDSAFE_NOEXCEPT {
   swap(lhs.args, rhs.args);
   swap(lhs.permitted_dirs, rhs.permitted_dirs);
   swap(lhs.icon, rhs.icon);
+  swap(lhs.icon_id, rhs.icon_id);
   swap(lhs.auto_start, rhs.auto_start);
 }
 
 bool operator<(const AppDetails& lhs, const AppDetails& rhs) { return lhs.name < rhs.name; }
 
+ImmutableData MakeIconChunk(const SerialisedData& icon,
+                            const crypto::AES256KeyAndIV& account_key_and_iv) {
+  const crypto::PlainText plain_icon{NonEmptyString{std::string(icon.begin(), icon.end())}};
+  return ImmutableData{crypto::SymmEncrypt(plain_icon, GetIconKeyAndIV(account_key_and_iv))};
+}
+
+SerialisedData ParseIconChunk(const ImmutableData& icon_chunk,
+                              const crypto::AES256KeyAndIV& account_key_and_iv) {
+  const crypto::PlainText icon{crypto::SymmDecrypt(crypto::CipherText{icon_chunk.Value()},
+                                                   GetIconKeyAndIV(account_key_and_iv))};
+  return SerialisedData(icon->string().begin(), icon->string().end());
+}
+
 }  // namespace launcher
 
 }  // namespace maidsafe
@@ -25,6 +25,9 @@
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/config.h"
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/data_types/immutable_data.h"
 #include "maidsafe/common/serialisation/serialisation.h"
 #include "maidsafe/directory_info.h"
 
@@ -46,12 +49,28 @@ struct AppDetails {
   boost::filesystem::path path;
   AppArgs args;
   std::set<DirectoryInfo> permitted_dirs;
+  // The icon isn't serialised as part of the account; it's stored as a separate chunk named
+  // 'icon_id' (uninitialised if the app has no icon).  After logging in, 'icon' is empty until
+  // explicitly retrieved, e.g. via 'Launcher::GetAppIcons'.
   SerialisedData icon;
+  Identity icon_id;
   bool auto_start;
 };
 
 void swap(AppDetails& lhs, AppDetails& rhs) MAIDSAFE_NOEXCEPT;
 
+// Returns 'icon' as the content-addressed chunk which is stored on the network.  The icon is
+// encrypted with a key derived from 'account_key_and_iv' (the account's config file key), so the
+// chunk is only readable by the account's owner, and only identical icons of the same account share
+// a chunk.  Throws if 'icon' is empty.
+ImmutableData MakeIconChunk(const SerialisedData& icon,
+                            const crypto::AES256KeyAndIV& account_key_and_iv);
+
+// Returns the icon held in 'icon_chunk', which must have been created by 'MakeIconChunk' using the
+// same 'account_key_and_iv'.  Throws on error.
+SerialisedData ParseIconChunk(const ImmutableData& icon_chunk,
+                              const crypto::AES256KeyAndIV& account_key_and_iv);
+
 bool operator<(const AppDetails& lhs, const AppDetails& rhs);
 
 }  // namespace launcher
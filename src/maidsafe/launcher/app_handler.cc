@@ -20,21 +20,27 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <set>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "boost/filesystem/operations.hpp"
 #include "cereal/types/string.hpp"
-#include "cereal/types/set.hpp"
 
-#include "maidsafe/common/convert.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
 #include "maidsafe/common/serialisation/types/boost_filesystem.h"
 
 #include "maidsafe/launcher/account.h"
 #include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/binary_encoding.h"
 
 namespace fs = boost::filesystem;
 
@@ -47,7 +53,7 @@ namespace {
 void UpdateAppDetails(AppDetails& app, const AppName* const new_name,
                       const boost::filesystem::path* const new_path, const AppArgs* const new_args,
                       const DirectoryInfo* const new_dir, const SerialisedData* const new_icon,
-                      const bool* const new_auto_start_value) {
+                      const Identity& new_icon_id, const bool* const new_auto_start_value) {
   // Check exactly one of the six pointers is non-null.
   assert(int(!!new_name) + int(!!new_path) + int(!!new_args) + int(!!new_dir) + int(!!new_icon) +
              int(!!new_auto_start_value) ==
@@ -65,23 +71,135 @@ void UpdateAppDetails(AppDetails& app, const AppName* const new_name,
       app.permitted_dirs.insert(*new_dir);
   } else if (new_icon) {
     app.icon = *new_icon;
+    app.icon_id = new_icon_id;
   } else {
     app.auto_start = *new_auto_start_value;
   }
 }
 
+// The config file's records hold only the fields of local apps which aren't held in the Account,
+// encoded as described in binary_encoding.h.  Each starts with its type.  A compacted config file
+// holds a 'kReset' record, which replaces all local apps with those it holds, followed by
+// 'kResetContinuation' records holding the rest of the local apps.  The others each hold a single
+// change.
+enum class ConfigRecordType : std::uint8_t { kReset, kPut, kRemove, kResetContinuation };
+
+// Each record is decrypted and decompressed as a whole when the config file is read, so a compacted
+// config file is split into records of about this many bytes of apps.
+const std::size_t kMaxResetRecordSize(32 * 1024);
+
+void AppendConfigApp(const AppDetails& app, std::string& record) {
+  AppendString(app.name, record);
+  AppendString(app.path.string(), record);
+  AppendString(app.args, record);
+  AppendUint8(app.auto_start ? 1 : 0, record);
+}
+
+AppDetails ReadConfigApp(BinaryReader& reader) {
+  AppDetails app;
+  app.name = reader.ReadString();
+  app.path = reader.ReadString();
+  app.args = reader.ReadString();
+  app.auto_start = reader.ReadUint8() != 0;
+  return app;
+}
+
+std::vector<std::string> MakeResetRecords(const AppRegistry& local_apps) {
+  std::vector<std::string> records;
+  std::string apps;
+  std::uint32_t app_count(0);
+  auto add_record([&] {
+    std::string record;
+    AppendUint8(static_cast<std::uint8_t>(records.empty() ? ConfigRecordType::kReset
+                                                          : ConfigRecordType::kResetContinuation),
+                record);
+    AppendUint32(app_count, record);
+    records.push_back(record + apps);
+    apps.clear();
+    app_count = 0;
+  });
+  for (const auto& app : local_apps) {
+    AppendConfigApp(app, apps);
+    ++app_count;
+    if (apps.size() >= kMaxResetRecordSize)
+      add_record();
+  }
+  if (app_count != 0 || records.empty())
+    add_record();
+  return records;
+}
+
+std::string MakePutRecord(const AppDetails& app) {
+  std::string record;
+  AppendUint8(static_cast<std::uint8_t>(ConfigRecordType::kPut), record);
+  AppendConfigApp(app, record);
+  return record;
+}
+
+std::string MakeRemoveRecord(const AppName& app_name) {
+  std::string record;
+  AppendUint8(static_cast<std::uint8_t>(ConfigRecordType::kRemove), record);
+  AppendString(app_name, record);
+  return record;
+}
+
+// Applies 'record' to 'local_apps', and returns its type.
+ConfigRecordType ApplyConfigRecord(const std::string& record, AppRegistry& local_apps) {
+  BinaryReader reader{record};
+  const auto type(static_cast<ConfigRecordType>(reader.ReadUint8()));
+  switch (type) {
+    case ConfigRecordType::kReset:
+    case ConfigRecordType::kResetContinuation: {
+      if (type == ConfigRecordType::kReset)
+        local_apps.Clear();
+      const std::uint32_t app_count(reader.ReadUint32());
+      for (std::uint32_t i{0}; i < app_count; ++i)
+        local_apps.Insert(ReadConfigApp(reader));
+      break;
+    }
+    case ConfigRecordType::kPut:
+      local_apps.InsertOrReplace(ReadConfigApp(reader));
+      break;
+    case ConfigRecordType::kRemove:
+      local_apps.Erase(reader.ReadString());
+      break;
+    default:
+      LOG(kError) << "Unknown config record type.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  return type;
+}
+
+// Parses a legacy config file's contents, which hold every local app serialised via cereal.
+void ApplyLegacyConfig(const std::string& contents, AppRegistry& local_apps) {
+  std::stringstream str_stream{contents};
+  const std::size_t app_count(ConvertFromStream<std::size_t>(str_stream));
+  for (std::size_t i{0}; i < app_count; ++i) {
+    AppDetails app;
+    ConvertFromStream(str_stream, app.name, app.path, app.args, app.auto_start);
+    local_apps.InsertOrReplace(std::move(app));
+  }
+}
+
 }  // unnamed namespace
 
 AppHandler::AppHandler()
     : account_(nullptr),
       account_mutex_(nullptr),
       config_file_path_(),
+      config_journal_(),
+      compacted_record_count_(0),
       local_apps_(),
       non_local_apps_(),
+      undo_log_(),
+      undo_log_end_(0),
+      snapshot_positions_(),
+      batch_open_(false),
+      pending_config_records_(),
       mutex_() {}
 
-void AppHandler::Initialise(fs::path config_file_path, Account* account,
-                            std::mutex* account_mutex) {
+void AppHandler::Initialise(fs::path config_file_path, Account* account, std::mutex* account_mutex,
+                            ConfigJournal::Codec config_codec) {
   // Check 'Initialise' hasn't already been called.
   assert(!account_ && !account_mutex_);
 
@@ -93,6 +211,8 @@ void AppHandler::Initialise(fs::path config_file_path, Account* account,
   account_ = account;
   account_mutex_ = account_mutex;
   config_file_path_ = std::move(config_file_path);
+  config_journal_ = maidsafe::make_unique<ConfigJournal>(
+      config_file_path_, account_->config_file_aes_key_and_iv, config_codec);
 
   // Initialise the non-local apps from the account and the local ones from the config file
   non_local_apps_ = account_->apps;
@@ -100,86 +220,138 @@ void AppHandler::Initialise(fs::path config_file_path, Account* account,
     fs::create_directories(config_file_path_.parent_path());
   else
     ReadConfigFile();
+  MergeLocalAndNonLocalApps();
+}
 
-  // Iterate through each set of apps.  For any app which appears as local *and* non-local, its info
-  // is merged to the copy in the local set and it is removed from the non-local set.  Any app which
-  // appears as local only is removed.
-  auto local_itr(local_apps_.begin());
-  auto non_local_itr(non_local_apps_.begin());
-  while (local_itr != local_apps_.end() && non_local_itr != non_local_apps_.end()) {
-    if (*local_itr < *non_local_itr) {  // local only
-      local_itr = local_apps_.erase(local_itr);
-    } else if (*non_local_itr < *local_itr) {  // non-local only
-      ++non_local_itr;
-    } else {  // both local and non-local
-      AppDetails local(*local_itr);
-      local.permitted_dirs = non_local_itr->permitted_dirs;
-      local_itr = local_apps_.erase(local_itr);
-      local_apps_.insert(std::move(local));
-      non_local_itr = non_local_apps_.erase(non_local_itr);
+void AppHandler::MergeLocalAndNonLocalApps() {
+  // For any app which appears as local *and* non-local, its info is merged to the copy in the local
+  // registry and it is removed from the non-local registry.  Any app which appears as local only is
+  // removed.
+  std::vector<AppName> local_app_names;
+  for (const auto& local_app : local_apps_)
+    local_app_names.push_back(local_app.name);
+  for (const auto& app_name : local_app_names) {
+    const AppDetails* const non_local_app{non_local_apps_.Find(app_name)};
+    if (!non_local_app) {  // local only
+      local_apps_.Erase(app_name);
+      continue;
     }
+    // both local and non-local
+    local_apps_.Modify(app_name, [non_local_app](AppDetails& local_app) {
+      local_app.permitted_dirs = non_local_app->permitted_dirs;
+      local_app.icon = non_local_app->icon;
+      local_app.icon_id = non_local_app->icon_id;
+    });
+    non_local_apps_.Erase(app_name);
   }
 }
 
 AppHandler::Snapshot AppHandler::GetSnapshot() const {
   Snapshot snapshot;
   std::lock_guard<std::mutex> lock{mutex_};
-  snapshot.local_apps = local_apps_;
-  snapshot.non_local_apps = non_local_apps_;
-  try {
-    // Set up copy of config file.  Path is held in a shared_ptr with a custom deleter which also
-    // tries to remove the copied file as well as deleting the path pointer.
-    snapshot.config_file.reset(
-        new fs::path(config_file_path_.parent_path() / RandomAlphaNumericString(10)),
-        [](fs::path* delete_path) {
-          if (!delete_path->empty() && fs::exists(*delete_path)) {
-            boost::system::error_code ec;
-            if (!fs::remove(*delete_path, ec))
-              LOG(kWarning) << "Failed to remove " << *delete_path;
-            if (ec)
-              LOG(kWarning) << "Error removing " << *delete_path << "  " << ec.message();
-          }
-          delete delete_path;
-        });
-    if (fs::exists(config_file_path_))
-      fs::copy_file(config_file_path_, *snapshot.config_file);
-  } catch (const std::exception& e) {
-    LOG(kError) << "Failed to copy config file from " << config_file_path_ << " to "
-                << *snapshot.config_file << ": " << e.what();
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
-  }
+  PruneUndoLog();
+  snapshot.undo_position = std::make_shared<const std::uint64_t>(undo_log_end_);
+  snapshot_positions_.push_back(snapshot.undo_position);
+  snapshot.config_file_exists = fs::exists(config_file_path_);
   return snapshot;
 }
 
+std::set<AppName> AppHandler::ChangedAppsSince(const Snapshot& snapshot) const {
+  assert(snapshot.undo_position);
+  std::set<AppName> changed_apps;
+  std::lock_guard<std::mutex> lock{mutex_};
+  const std::uint64_t undo_log_begin(undo_log_end_ - undo_log_.size());
+  if (*snapshot.undo_position >= undo_log_end_)
+    return changed_apps;
+  assert(*snapshot.undo_position >= undo_log_begin);
+  // The first entry logged for each app since the snapshot holds the app as it was then, so the app
+  // is unchanged if that's still the current instance.  The account holds the same apps as the two
+  // registries, so needn't be checked.
+  std::set<std::pair<Registry, AppName>> logged_apps;
+  const auto first_entry(static_cast<std::ptrdiff_t>(*snapshot.undo_position - undo_log_begin));
+  for (auto itr(undo_log_.begin() + first_entry); itr != undo_log_.end(); ++itr) {
+    if (itr->registry == Registry::kAccount ||
+        !logged_apps.emplace(itr->registry, itr->app_name).second) {
+      continue;
+    }
+    const AppRegistry& apps(itr->registry == Registry::kLocal ? local_apps_ : non_local_apps_);
+    if (apps.Find(itr->app_name) != itr->previous_app.get())
+      changed_apps.insert(itr->app_name);
+  }
+  return changed_apps;
+}
+
 void AppHandler::ApplySnapshot(Snapshot snapshot) {
+  assert(snapshot.undo_position);
   auto locks(AcquireLocks());
 
-  // Reset account
-  account_->apps.clear();
-  std::set_union(snapshot.local_apps.begin(), snapshot.local_apps.end(),
-                 snapshot.non_local_apps.begin(), snapshot.non_local_apps.end(),
-                 std::inserter(account_->apps, account_->apps.end()));
-
-  // Reset app sets
-  local_apps_ = std::move(snapshot.local_apps);
-  non_local_apps_ = std::move(snapshot.non_local_apps);
-
-  // Replace config file
-  try {
-    if (fs::exists(*snapshot.config_file))
-      fs::rename(*snapshot.config_file, config_file_path_);
-    else
-      fs::remove(config_file_path_);
-  } catch (const std::exception& e) {
-    LOG(kError) << "Failed to move config file from " << *snapshot.config_file << " to "
-                << config_file_path_ << ": " << e.what();
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  // Undo the changes to the account and app registries made since the snapshot was taken, most
+  // recent first.  Each undo is itself logged, so that a snapshot taken after this one can still be
+  // applied afterwards.
+  assert(*snapshot.undo_position >= undo_log_end_ - undo_log_.size());
+  for (std::uint64_t position(undo_log_end_); position > *snapshot.undo_position; --position) {
+    // Logging may discard entries from the front of the log, so the index is found afresh.
+    const std::uint64_t undo_log_begin(undo_log_end_ - undo_log_.size());
+    const UndoEntry entry(undo_log_[static_cast<std::size_t>(position - 1 - undo_log_begin)]);
+    LogUndo(entry.registry, entry.app_name);
+    GetRegistry(entry.registry).Restore(entry.app_name, entry.previous_app);
+  }
+
+  // Rewrite config file from the snapshot's local apps.
+  if (snapshot.config_file_exists) {
+    WriteConfigFile();
+  } else {
+    config_journal_->Remove();
+    compacted_record_count_ = 0;
+  }
+}
+
+void AppHandler::ReloadAccount(const std::function<void()>& replace_account) {
+  auto locks(AcquireLocks());
+  // Any live Snapshot must be able to undo the reload, which (unlike other changes) may change
+  // every app, so is logged by comparing each registry with a copy of it from before.
+  const bool log_undo(PruneUndoLog());
+  const AppRegistry old_local_apps(log_undo ? local_apps_ : AppRegistry());
+  const AppRegistry old_non_local_apps(log_undo ? non_local_apps_ : AppRegistry());
+  const AppRegistry old_account_apps(log_undo ? account_->apps : AppRegistry());
+  replace_account();
+  non_local_apps_ = account_->apps;
+  MergeLocalAndNonLocalApps();
+  if (log_undo) {
+    LogReplacedApps(Registry::kLocal, old_local_apps);
+    LogReplacedApps(Registry::kNonLocal, old_non_local_apps);
+    LogReplacedApps(Registry::kAccount, old_account_apps);
   }
 }
 
+void AppHandler::BeginBatch() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  assert(!batch_open_);
+  batch_open_ = true;
+}
+
+void AppHandler::EndBatch(bool commit) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  assert(batch_open_);
+  batch_open_ = false;
+  std::vector<std::string> records;
+  records.swap(pending_config_records_);
+  if (commit && !records.empty())
+    AppendToConfigFile(std::move(records));
+}
+
 std::set<AppDetails> AppHandler::GetApps(bool locally_available) const {
   std::lock_guard<std::mutex> lock{mutex_};
-  return locally_available ? local_apps_ : non_local_apps_;
+  const AppRegistry& apps(locally_available ? local_apps_ : non_local_apps_);
+  return std::set<AppDetails>(apps.begin(), apps.end());
+}
+
+std::vector<AppDetails> AppHandler::GetAutoStartApps() const {
+  std::vector<AppDetails> auto_start_apps;
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& app_name : local_apps_.AutoStartApps())
+    auto_start_apps.push_back(*local_apps_.Find(app_name));
+  return auto_start_apps;
 }
 
 AppDetails AppHandler::AddOrLinkApp(AppName app_name, fs::path app_path, AppArgs app_args,
@@ -191,55 +363,61 @@ AppDetails AppHandler::AddOrLinkApp(AppName app_name, fs::path app_path, AppArgs
   app.auto_start = auto_start;
 
   auto locks(AcquireLocks());
-  auto account_itr(account_->apps.find(app));
 
   // We're linking the app if 'app_icon' is null, otherwise we're adding the app.
   if (app_icon) {
     app.icon = *app_icon;
-    Add(app, account_itr);
+    if (!app.icon.empty())
+      app.icon_id = MakeIconChunk(app.icon, account_->config_file_aes_key_and_iv).Name();
+    Add(app);
   } else {
-    Link(app, account_itr);
+    Link(app);
   }
 
-  WriteConfigFile();
+  AppendToConfigFile({MakePutRecord(app)});
   return app;
 }
 
-void AppHandler::Add(AppDetails& app, std::set<AppDetails>::iterator account_itr) {
+void AppHandler::Add(AppDetails& app) {
   // Adding requires app to not exist in the account
-  if (account_itr != account_->apps.end()) {
+  if (account_->apps.Contains(app.name)) {
     LOG(kError) << "App \"" << app.name << "\" already exists in Account - can't add.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
   }
-  assert(local_apps_.count(app) == 0 && non_local_apps_.count(app) == 0);
+  assert(!local_apps_.Contains(app.name) && !non_local_apps_.Contains(app.name));
 
   app.permitted_dirs.emplace(std::string("/") + app.name, account_->root_parent_id, MakeIdentity(),
                              DirectoryInfo::AccessRights::kReadWrite);
 
-  // Add to account and local set
-  account_->apps.insert(app);
-  local_apps_.insert(app);
+  // Add to account and local registry
+  LogUndo(Registry::kAccount, app.name);
+  account_->apps.Insert(app);
+  LogUndo(Registry::kLocal, app.name);
+  local_apps_.Insert(app);
 }
 
-void AppHandler::Link(AppDetails& app, std::set<AppDetails>::iterator account_itr) {
-  // Linking requires app to exist in non-local set and not exist in local set
-  auto non_local_itr(non_local_apps_.find(app));
-  if (local_apps_.count(app) != 0 || non_local_itr != non_local_apps_.end()) {
+void AppHandler::Link(AppDetails& app) {
+  // Linking requires app to exist in non-local registry and not exist in local registry
+  if (local_apps_.Contains(app.name) || !non_local_apps_.Contains(app.name)) {
     LOG(kError)
         << "App \"" << app.name
         << "\" already exists in local set, or doesn't exist in non-local set - can't link.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
   }
 
-  // If app is in non-local set, it must also be in Account.
-  assert(account_itr != account_->apps.end());
+  // If app is in non-local registry, it must also be in Account.
+  const AppDetails* const account_app{account_->apps.Find(app.name)};
+  assert(account_app);
 
-  app.permitted_dirs = account_itr->permitted_dirs;
-  app.icon = account_itr->icon;
+  app.permitted_dirs = account_app->permitted_dirs;
+  app.icon = account_app->icon;
+  app.icon_id = account_app->icon_id;
 
   // Add to local and remove from non-local
-  local_apps_.insert(app);
-  non_local_apps_.erase(non_local_itr);
+  LogUndo(Registry::kLocal, app.name);
+  local_apps_.Insert(app);
+  LogUndo(Registry::kNonLocal, app.name);
+  non_local_apps_.Erase(app.name);
 }
 
 void AppHandler::UpdateName(const AppName& app_name, const AppName& new_name) {
@@ -267,46 +445,105 @@ void AppHandler::UpdateAutoStart(const AppName& app_name, bool new_auto_start_va
 }
 
 void AppHandler::RemoveLocally(const AppName& app_name) {
-  AppDetails app;
-  app.name = app_name;
   std::lock_guard<std::mutex> lock{mutex_};
-  if (local_apps_.erase(app) != 1U) {
+  if (!local_apps_.Contains(app_name)) {
     LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler's local apps set.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  WriteConfigFile();
+  LogUndo(Registry::kLocal, app_name);
+  local_apps_.Erase(app_name);
+  AppendToConfigFile({MakeRemoveRecord(app_name)});
 }
 
 void AppHandler::RemoveFromNetwork(const AppName& app_name) {
-  AppDetails app;
-  app.name = app_name;
   auto locks(AcquireLocks());
 
-  // Handle non-local set
-  if (non_local_apps_.erase(app) != 1U) {
+  // Handle non-local registry
+  if (!non_local_apps_.Contains(app_name)) {
     LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler's non-local apps set.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
+  LogUndo(Registry::kNonLocal, app_name);
+  non_local_apps_.Erase(app_name);
 
   // Handle Account
-  if (account_->apps.erase(app) != 1U) {
+  LogUndo(Registry::kAccount, app_name);
+  if (!account_->apps.Erase(app_name)) {
     LOG(kError) << "App \"" << app_name << "\" doesn't exist in Account.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-
-  WriteConfigFile();
+  // The config file only holds local apps, so is unaffected.
 }
 
 std::pair<fs::path, AppArgs> AppHandler::GetPathAndArgs(AppName app_name) const {
-  AppDetails app;
-  app.name = app_name;
   std::lock_guard<std::mutex> lock{mutex_};
-  auto itr = local_apps_.find(app);
-  if (itr == local_apps_.end()) {
+  const AppDetails* const app{local_apps_.Find(app_name)};
+  if (!app) {
     LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler's local apps set.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  return std::make_pair(itr->path, itr->args);
+  return std::make_pair(app->path, app->args);
+}
+
+std::set<DirectoryInfo> AppHandler::GetPermittedDirs(const AppName& app_name) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const AppDetails* const app{local_apps_.Find(app_name)};
+  if (!app) {
+    LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler's local apps set.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+  }
+  return app->permitted_dirs;
+}
+
+AppRegistry& AppHandler::GetRegistry(Registry registry) {
+  switch (registry) {
+    case Registry::kLocal:
+      return local_apps_;
+    case Registry::kNonLocal:
+      return non_local_apps_;
+    default:
+      return account_->apps;
+  }
+}
+
+bool AppHandler::PruneUndoLog() const {
+  std::uint64_t oldest_position(undo_log_end_);
+  auto itr(snapshot_positions_.begin());
+  while (itr != snapshot_positions_.end()) {
+    std::shared_ptr<const std::uint64_t> position(itr->lock());
+    if (position) {
+      oldest_position = std::min(oldest_position, *position);
+      ++itr;
+    } else {
+      itr = snapshot_positions_.erase(itr);
+    }
+  }
+  while (!undo_log_.empty() && undo_log_end_ - undo_log_.size() < oldest_position)
+    undo_log_.pop_front();
+  return !snapshot_positions_.empty();
+}
+
+void AppHandler::LogUndo(Registry registry, const AppName& app_name) {
+  if (!PruneUndoLog())
+    return;
+  undo_log_.push_back(UndoEntry{registry, app_name, GetRegistry(registry).FindShared(app_name)});
+  ++undo_log_end_;
+}
+
+void AppHandler::LogReplacedApps(Registry registry, const AppRegistry& before) {
+  const AppRegistry& after(GetRegistry(registry));
+  for (const auto& app : before) {
+    if (after.Find(app.name) != &app) {
+      undo_log_.push_back(UndoEntry{registry, app.name, before.FindShared(app.name)});
+      ++undo_log_end_;
+    }
+  }
+  for (const auto& app : after) {
+    if (!before.Contains(app.name)) {
+      undo_log_.push_back(UndoEntry{registry, app.name, nullptr});
+      ++undo_log_end_;
+    }
+  }
 }
 
 std::pair<AppHandler::LockGuardPtr, AppHandler::LockGuardPtr> AppHandler::AcquireLocks() const {
@@ -317,46 +554,56 @@ std::pair<AppHandler::LockGuardPtr, AppHandler::LockGuardPtr> AppHandler::Acquir
 }
 
 void AppHandler::ReadConfigFile() {
-  if (!fs::exists(config_file_path_))
-    return;
-  assert(fs::is_regular_file(config_file_path_));
-
-  // Read from file.
-  crypto::CipherText encrypted_contents{NonEmptyString{ReadFile(config_file_path_).value()}};
-
-  // Decrypt and uncompress the contents.
-  auto serialised_contents(crypto::Uncompress(crypto::CompressedText(
-      crypto::SymmDecrypt(encrypted_contents, account_->config_file_aes_key_and_iv))));
-
-  // Parse the set of local apps.
-  std::stringstream str_stream{convert::ToString(serialised_contents.string())};
-  std::size_t app_count(ConvertFromStream<std::size_t>(str_stream));
-  for (std::size_t i{0}; i < app_count; ++i) {
-    AppDetails app_details;
-    ConvertFromStream(str_stream, app_details.name, app_details.path, app_details.args,
-                      app_details.auto_start);
-    local_apps_.insert(std::move(app_details));
+  // Replay the committed records; any torn write at the end of the journal is discarded.  A legacy
+  // config file is recovered as a single record holding every local app, and the journal is then
+  // rewritten in the current version before anything is appended to it.  Likewise, a journal
+  // written with a different codec is rewritten so that the chosen codec takes effect.
+  compacted_record_count_ = 0;
+  config_journal_->Recover([this](std::string record) {
+    if (config_journal_->FileVersion() == ConfigJournal::kLegacyVersion) {
+      ApplyLegacyConfig(record, local_apps_);
+      compacted_record_count_ = 1;
+      return;
+    }
+    switch (ApplyConfigRecord(record, local_apps_)) {
+      case ConfigRecordType::kReset:
+        compacted_record_count_ = 1;
+        break;
+      case ConfigRecordType::kResetContinuation:
+        ++compacted_record_count_;
+        break;
+      default:
+        break;
+    }
+  });
+  if (config_journal_->FileVersion() < ConfigJournal::kFormatVersion ||
+      (config_journal_->RecordCount() != 0 &&
+       config_journal_->FileCodec() != config_journal_->PreferredCodec())) {
+    WriteConfigFile();
   }
 }
 
-void AppHandler::WriteConfigFile() const {
-  // Serialise the set of local apps.  Omit their 'permitted_dirs' and 'icon' fields since they're
-  // held in the serialised Account.
-  std::string serialised_contents(ConvertToString(local_apps_.size()));
-  for (const auto& app : local_apps_)
-    serialised_contents += ConvertToString(app.name, app.path, app.args, app.auto_start);
+void AppHandler::AppendToConfigFile(std::vector<std::string> records) {
+  if (batch_open_) {
+    pending_config_records_.insert(pending_config_records_.end(),
+                                   std::make_move_iterator(records.begin()),
+                                   std::make_move_iterator(records.end()));
+    return;
+  }
 
-  // Compress and encrypt the serialised contents.
-  auto encrypted_contents(crypto::SymmEncrypt(
-      crypto::Compress(crypto::UncompressedText(convert::ToByteVector(serialised_contents)), 9)
-          .data,
-      account_->config_file_aes_key_and_iv));
+  // The in-memory apps already reflect 'records', so compacting makes appending them unnecessary.
+  // Only the records appended since the journal was last compacted count towards the limit.
+  if (config_journal_->RecordCount() + records.size() >
+      ConfigJournal::kMaxRecords + compacted_record_count_)
+    WriteConfigFile();
+  else
+    config_journal_->Append(records);
+}
 
-  // Write to file.
-  if (!WriteFile(config_file_path_, encrypted_contents->string())) {
-    LOG(kError) << "Failed to save config file at " << config_file_path_;
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
-  }
+void AppHandler::WriteConfigFile() {
+  const std::vector<std::string> records(MakeResetRecords(local_apps_));
+  config_journal_->Compact(records);
+  compacted_record_count_ = records.size();
 }
 
 void AppHandler::Update(const AppName& app_name, const AppName* const new_name,
@@ -364,39 +611,51 @@ void AppHandler::Update(const AppName& app_name, const AppName* const new_name,
                         const AppArgs* const new_args, const DirectoryInfo* const new_dir,
                         const SerialisedData* const new_icon,
                         const bool* const new_auto_start_value) {
-  AppDetails current_app;
-  current_app.name = app_name;
   auto locks(AcquireLocks());
 
-  // Handle local or non-local set
-  std::set<AppDetails>* app_set{nullptr};
-  auto itr(local_apps_.find(current_app));
-  if (itr == local_apps_.end()) {
-    itr = non_local_apps_.find(current_app);
-    if (itr == non_local_apps_.end()) {
-      LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler sets.";
-      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
-    }
-    app_set = &non_local_apps_;
+  // Handle local or non-local registry
+  Registry registry(Registry::kLocal);
+  if (local_apps_.Contains(app_name)) {
+    registry = Registry::kLocal;
+  } else if (non_local_apps_.Contains(app_name)) {
+    registry = Registry::kNonLocal;
   } else {
-    app_set = &local_apps_;
+    LOG(kError) << "App \"" << app_name << "\" doesn't exist in AppHandler sets.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  AppDetails updated_app{*itr};
-  UpdateAppDetails(updated_app, new_name, new_path, new_args, new_dir, new_icon,
-                   new_auto_start_value);
-  app_set->erase(itr);
-  app_set->insert(updated_app);
-
-  // Handle Account
-  itr = account_->apps.find(current_app);
-  if (itr == account_->apps.end()) {
+  if (!account_->apps.Contains(app_name)) {
     LOG(kError) << "App \"" << app_name << "\" doesn't exist in Account.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  account_->apps.erase(itr);
-  account_->apps.insert(std::move(updated_app));
+  if (new_name && *new_name != app_name && account_->apps.Contains(*new_name)) {
+    LOG(kError) << "Can't rename app \"" << app_name << "\" to existing app \"" << *new_name
+                << "\".";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
 
-  WriteConfigFile();
+  // Modify the app in both registries.  The icon chunk's name is only derived once.
+  Identity new_icon_id;
+  if (new_icon && !new_icon->empty())
+    new_icon_id = MakeIconChunk(*new_icon, account_->config_file_aes_key_and_iv).Name();
+  auto update([&](AppDetails& app) {
+    UpdateAppDetails(app, new_name, new_path, new_args, new_dir, new_icon, new_icon_id,
+                     new_auto_start_value);
+  });
+  for (const Registry modified : {registry, Registry::kAccount}) {
+    LogUndo(modified, app_name);
+    if (new_name && *new_name != app_name)
+      LogUndo(modified, *new_name);
+    GetRegistry(modified).Modify(app_name, update);
+  }
+
+  // The config file only holds the name, path, args and auto-start fields of local apps.
+  if (registry != Registry::kLocal || new_dir || new_icon)
+    return;
+  if (new_name) {
+    AppendToConfigFile({MakeRemoveRecord(app_name), MakePutRecord(*local_apps_.Find(*new_name))});
+  } else {
+    AppendToConfigFile({MakePutRecord(*local_apps_.Find(app_name))});
+  }
 }
 
 }  // namespace launcher
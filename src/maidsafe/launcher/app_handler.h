@@ -20,10 +20,14 @@
 #define MAIDSAFE_LAUNCHER_APP_HANDLER_H_
 
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "boost/filesystem/path.hpp"
 
@@ -31,6 +35,8 @@
 #include "maidsafe/common/serialisation/serialisation.h"
 #include "maidsafe/directory_info.h"
 
+#include "maidsafe/launcher/app_registry.h"
+#include "maidsafe/launcher/config_journal.h"
 #include "maidsafe/launcher/types.h"
 
 namespace maidsafe {
@@ -38,18 +44,23 @@ namespace maidsafe {
 namespace launcher {
 
 struct Account;
-struct AppDetails;
 
 namespace test {
 class AppHandlerTest;
 }  // namespace test
 
+// The fields of local apps which aren't held in the Account are persisted to the config file, which
+// is a ConfigJournal: each change appends a record of just that change, and the journal is
+// compacted once it grows too long, to records of bounded size which together hold all local apps.
+//
 // This class only offers the basic exception safety guarantee, but it allows a snapshot to be taken
-// so that the owning Launcher class can revert this to the snapshot state if required.  The
-// Snapshot struct provides a RAII copy of the config file.  When an instance of a Snaphot is
-// created, a copy of the config file is created and the path to this copy held in a shared_ptr
-// member of the Snapshot instance.  When the final copy of this Snapshot instance is destroyed, the
-// copied file is also removed from disk.
+// so that the owning Launcher class can revert this to the snapshot state if required.  Neither
+// taking a Snapshot nor editing while one is alive depends on the number of apps: a Snapshot only
+// marks a position in an undo log, and while any Snapshot is alive, each change to an app first
+// logs the app's previous instance (apps are immutable and shared, so this copies a pointer).
+// Applying a Snapshot undoes (and logs undoing) the changes logged since it was taken, then
+// rewrites the config file from the local apps (or removes it if it didn't exist when the Snapshot
+// was taken).
 class AppHandler {
  public:
   struct Snapshot {
@@ -57,8 +68,10 @@ class AppHandler {
     friend class test::AppHandlerTest;
 
    private:
-    std::set<AppDetails> local_apps, non_local_apps;
-    std::shared_ptr<boost::filesystem::path> config_file;
+    // The undo log position when the Snapshot was taken.  Shared by copies of the Snapshot, and
+    // watched by the AppHandler so that it only keeps the log entries a live Snapshot may undo.
+    std::shared_ptr<const std::uint64_t> undo_position;
+    bool config_file_exists{false};
   };
 
   AppHandler();
@@ -68,13 +81,36 @@ class AppHandler {
   AppHandler& operator=(const AppHandler&) = delete;
   AppHandler& operator=(AppHandler&&) = delete;
 
+  // 'config_codec' is used to compress the config file, which is rewritten on initialising if it
+  // was written with a different codec.
   void Initialise(boost::filesystem::path config_file_path, Account* account,
-                  std::mutex* account_mutex);
+                  std::mutex* account_mutex,
+                  ConfigJournal::Codec config_codec = ConfigJournal::kDefaultCodec);
 
   Snapshot GetSnapshot() const;
   void ApplySnapshot(Snapshot snapshot);
 
+  // Calls 'replace_account' (which should replace the contents of the account passed to
+  // 'Initialise') while holding both mutexes, then rebuilds the local and non-local apps from the
+  // replaced account as 'Initialise' does.  The local-only fields of local apps which are still in
+  // the account are kept.
+  void ReloadAccount(const std::function<void()>& replace_account);
+
+  // While a batch is open, the functions below only apply changes in memory, and their records are
+  // appended to the config file together by 'EndBatch' rather than after every change.  If 'commit'
+  // is false, the pending records are discarded, and the caller should then apply a snapshot taken
+  // before 'BeginBatch'.
+  // Batches can't be nested.
+  void BeginBatch();
+  void EndBatch(bool commit);
+
+  // Returns the names of the apps which have been added, modified or removed since 'snapshot' was
+  // taken.
+  std::set<AppName> ChangedAppsSince(const Snapshot& snapshot) const;
+
   std::set<AppDetails> GetApps(bool locally_available) const;
+  // Returns the local apps which are set to auto-start.
+  std::vector<AppDetails> GetAutoStartApps() const;
   // Link if 'app_icon' is null, else Add.
   AppDetails AddOrLinkApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
                           const SerialisedData* const app_icon, bool auto_start);
@@ -87,14 +123,39 @@ class AppHandler {
   void RemoveLocally(const AppName& app_name);
   void RemoveFromNetwork(const AppName& app_name);
   std::pair<boost::filesystem::path, AppArgs> GetPathAndArgs(AppName app_name) const;
+  std::set<DirectoryInfo> GetPermittedDirs(const AppName& app_name) const;
 
  private:
+  // The registries whose changes are logged for undoing.
+  enum class Registry { kLocal, kNonLocal, kAccount };
+  struct UndoEntry {
+    Registry registry;
+    AppName app_name;
+    // Null if the app didn't exist.
+    std::shared_ptr<const AppDetails> previous_app;
+  };
+
   using LockGuardPtr = std::unique_ptr<std::lock_guard<std::mutex>>;
   std::pair<LockGuardPtr, LockGuardPtr> AcquireLocks() const;
+  // Merges each local app with its copy in the non-local apps, which is then removed from the
+  // non-local apps.  Local apps which aren't in the account are removed.
+  void MergeLocalAndNonLocalApps();
+  AppRegistry& GetRegistry(Registry registry);
+  // Discards the undo log entries which no live Snapshot needs.  Returns false if there's no live
+  // Snapshot, in which case the log is empty.
+  bool PruneUndoLog() const;
+  // Must be called before changing the app named 'app_name' in 'registry', so that any live
+  // Snapshot can restore it.
+  void LogUndo(Registry registry, const AppName& app_name);
+  // Logs the changes made to 'registry' since it held the same apps as 'before'.
+  void LogReplacedApps(Registry registry, const AppRegistry& before);
   void ReadConfigFile();
-  void WriteConfigFile() const;
-  void Add(AppDetails& app, std::set<AppDetails>::iterator account_itr);
-  void Link(AppDetails& app, std::set<AppDetails>::iterator account_itr);
+  // Appends 'records' to the config file, or compacts it if it's grown too long.
+  void AppendToConfigFile(std::vector<std::string> records);
+  // Compacts the config file to the records holding all local apps.
+  void WriteConfigFile();
+  void Add(AppDetails& app);
+  void Link(AppDetails& app);
   void Update(const AppName& app_name, const AppName* const new_name,
               const boost::filesystem::path* const new_path, const AppArgs* const new_args,
               const DirectoryInfo* const new_dir, const SerialisedData* const new_icon,
@@ -103,7 +164,16 @@ class AppHandler {
   Account* account_;
   mutable std::mutex* account_mutex_;
   boost::filesystem::path config_file_path_;
-  std::set<AppDetails> local_apps_, non_local_apps_;
+  std::unique_ptr<ConfigJournal> config_journal_;
+  // The number of records at the start of the config file which hold its compacted state.
+  std::size_t compacted_record_count_;
+  AppRegistry local_apps_, non_local_apps_;
+  // The entries are numbered consecutively, up to but not including 'undo_log_end_'.
+  mutable std::deque<UndoEntry> undo_log_;
+  std::uint64_t undo_log_end_;
+  mutable std::vector<std::weak_ptr<const std::uint64_t>> snapshot_positions_;
+  bool batch_open_;
+  std::vector<std::string> pending_config_records_;
   mutable std::mutex mutex_;
 };
 
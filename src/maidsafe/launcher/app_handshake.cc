@@ -18,54 +18,110 @@
 
 #include "maidsafe/launcher/app_handshake.h"
 
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "boost/exception/diagnostic_information.hpp"
+#include "cereal/types/set.hpp"
+
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
-#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
 
 namespace maidsafe {
 
 namespace launcher {
 
-AppHandshake::AppHandshake(asio::io_service& io_service, std::set<DirectoryInfo> permitted_dirs)
-    : strand_(io_service),
-      listener_(tcp::Listener::MakeShared(
-          strand_, [this](tcp::ConnectionPtr connection) { OnConnection(connection); },
-          static_cast<tcp::Port>(RandomUint32()))),
-      connection_(),
-      permitted_dirs_(std::move(permitted_dirs)) {}
-
-AppHandshake::~AppHandshake() {}
-
-tcp::Port AppHandshake::ListeningPort() const { return listener_->ListeningPort(); }
-
-// asymm::PublicKey AppHandshake::AppSessionPublicKey() {
-
-// }
-
-void AppHandshake::OnConnection(tcp::ConnectionPtr connection) {
-  connection_ = connection;
-  // try {
-  //  connection_->Start([&](std::string message) { OnMessage(std::move(message)); },
-  //                     [&] { OnConnectionClosed(); });
-  //  tcp_connection->Send(Serialise(std::move(public_key)));
-  //  {
-  //    std::unique_lock<std::mutex> lock{ reply_handler.mutex };
-  //    reply_handler.cond_var.wait(lock, [&] {return reply_handler.reply_received; });
-  //  }
-  //  if (reply_handler.directories.empty())
-  //    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::uninitialised));
-  // }
-  // catch (const std::exception& e) {
-  //  LOG(kError) << boost::diagnostic_information(e);
-  //  throw;
-  // }
-  // return reply_handler.directories;
+AppHandshake::AppHandshake(asio::io_service::strand& strand, tcp::ConnectionPtr connection,
+                           std::chrono::steady_clock::duration step_timeout,
+                           GetPermittedDirs get_permitted_dirs, OnComplete on_complete)
+    : strand_(strand),
+      timer_(strand.get_io_service()),
+      step_(0),
+      connection_(std::move(connection)),
+      step_timeout_(step_timeout),
+      get_permitted_dirs_(std::move(get_permitted_dirs)),
+      on_complete_(std::move(on_complete)),
+      state_(State::kAwaitingSessionKey),
+      timed_out_(false),
+      session_key_received_(false),
+      session_public_key_() {}
+
+void AppHandshake::Start() {
+  assert(strand_.running_in_this_thread());
+  StartStepTimer();
+}
+
+void AppHandshake::OnMessage(tcp::Message message) {
+  assert(strand_.running_in_this_thread());
+  try {
+    switch (state_) {
+      case State::kAwaitingSessionKey:
+        session_public_key_ = asymm::DecodeKey(
+            asymm::EncodedPublicKey(std::string(message.begin(), message.end())));
+        session_key_received_ = true;
+        connection_->Send(Serialise(get_permitted_dirs_()));
+        state_ = State::kAwaitingConfirmation;
+        StartStepTimer();
+        break;
+      case State::kAwaitingConfirmation:
+        Complete(State::kSucceeded);
+        break;
+      default:
+        LOG(kWarning) << "Ignoring message received after handshake completed.";
+        break;
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "App handshake failed: " << boost::diagnostic_information(e);
+    Complete(State::kFailed);
+  }
+}
+
+void AppHandshake::OnConnectionClosed() {
+  assert(strand_.running_in_this_thread());
+  if (state_ == State::kSucceeded || state_ == State::kFailed)
+    return;
+  LOG(kWarning) << "App closed connection before completing handshake.";
+  Complete(State::kFailed);
 }
 
-void AppHandshake::OnConnectionClosed() {}
+asymm::PublicKey AppHandshake::AppSessionPublicKey() const {
+  if (!session_key_received_)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::uninitialised));
+  return session_public_key_;
+}
 
-void AppHandshake::OnMessage(tcp::Message /*message*/) {}
+void AppHandshake::StartStepTimer() {
+  const std::uint32_t step(++step_);
+  asio::error_code ignored;
+  timer_.expires_from_now(step_timeout_, ignored);
+  std::shared_ptr<AppHandshake> self(shared_from_this());
+  timer_.async_wait(strand_.wrap([self, step](const asio::error_code& error) {
+    if (error == asio::error::operation_aborted || step != self->step_ ||
+        self->state_ == State::kSucceeded || self->state_ == State::kFailed) {
+      return;
+    }
+    LOG(kWarning) << "Timed out waiting for app to "
+                  << (self->state_ == State::kAwaitingSessionKey ? "send its session key."
+                                                                 : "confirm its directories.");
+    self->timed_out_ = true;
+    self->Complete(State::kFailed);
+  }));
+}
+
+void AppHandshake::Complete(State final_state) {
+  state_ = final_state;
+  ++step_;
+  asio::error_code ignored;
+  timer_.cancel(ignored);
+  connection_->Close();
+  OnComplete on_complete;
+  std::swap(on_complete, on_complete_);
+  if (on_complete)
+    on_complete(final_state == State::kSucceeded);
+}
 
-}  //  namespace launcher
+}  // namespace launcher
 
-}  //  namespace maidsafe
+}  // namespace maidsafe
@@ -19,42 +19,79 @@
 #ifndef MAIDSAFE_LAUNCHER_APP_HANDSHAKE_H_
 #define MAIDSAFE_LAUNCHER_APP_HANDSHAKE_H_
 
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <mutex>
+#include <memory>
 #include <set>
 
-#include "asio/io_service.hpp"
 #include "asio/io_service_strand.hpp"
+#include "asio/steady_timer.hpp"
 
 #include "maidsafe/directory_info.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/tcp/connection.h"
-#include "maidsafe/common/tcp/listener.h"
 
 namespace maidsafe {
 
 namespace launcher {
 
-class AppHandshake {
+// The Launcher's side of the handshake with a launched app, once the app has connected and sent its
+// launch token:
+//   1. the app sends its encoded session public key
+//   2. the Launcher replies with the serialised set of directories the app may access
+//   3. the app replies to confirm receipt (any message is taken as confirmation)
+// after which the connection is closed.  Each step must complete within 'step_timeout' of the
+// previous one, or the handshake fails.
+//
+// Nothing blocks: 'Start', 'OnMessage' and 'OnConnectionClosed' must be called on 'strand', and
+// the handshake advances as messages and timeouts arrive.  'on_complete' is invoked on 'strand'
+// exactly once, unless 'strand's io_service is stopped first.
+class AppHandshake : public std::enable_shared_from_this<AppHandshake> {
  public:
-  AppHandshake(asio::io_service& io_service, std::set<DirectoryInfo> permitted_dirs);
-  ~AppHandshake();
-  tcp::Port ListeningPort() const;
-  asymm::PublicKey AppSessionPublicKey();
-
- private:
-  void OnConnection(tcp::ConnectionPtr connection);
-  void OnConnectionClosed();
+  enum class State { kAwaitingSessionKey, kAwaitingConfirmation, kSucceeded, kFailed };
+  // Called once the app's session key has been received.  If it throws, the handshake fails.
+  using GetPermittedDirs = std::function<std::set<DirectoryInfo>()>;
+  using OnComplete = std::function<void(bool succeeded)>;
+
+  AppHandshake(asio::io_service::strand& strand, tcp::ConnectionPtr connection,
+               std::chrono::steady_clock::duration step_timeout,
+               GetPermittedDirs get_permitted_dirs, OnComplete on_complete);
+
+  AppHandshake(const AppHandshake&) = delete;
+  AppHandshake(AppHandshake&&) = delete;
+  AppHandshake& operator=(const AppHandshake&) = delete;
+  AppHandshake& operator=(AppHandshake&&) = delete;
+
+  // Starts the timeout for the first step.
+  void Start();
   void OnMessage(tcp::Message message);
+  // Fails the handshake if it's still in progress.
+  void OnConnectionClosed();
+
+  State GetState() const { return state_; }
+  // Whether the handshake failed because a step timed out.
+  bool TimedOut() const { return timed_out_; }
+  // Throws 'CommonErrors::uninitialised' if the key hasn't been received yet.
+  asymm::PublicKey AppSessionPublicKey() const;
 
-  asio::io_service::strand strand_;
-  tcp::ListenerPtr listener_;
+ private:
+  void StartStepTimer();
+  void Complete(State final_state);
+
+  asio::io_service::strand& strand_;
+  asio::steady_timer timer_;
+  // Incremented at each step, so that a timeout handler which was already queued when its wait was
+  // cancelled can tell it's out of date.
+  std::uint32_t step_;
   tcp::ConnectionPtr connection_;
-  std::mutex mutex_;
-  std::condition_variable cond_var_;
-  std::set<DirectoryInfo> permitted_dirs_;
-  bool reply_received_;
+  const std::chrono::steady_clock::duration step_timeout_;
+  GetPermittedDirs get_permitted_dirs_;
+  OnComplete on_complete_;
+  State state_;
+  bool timed_out_;
+  bool session_key_received_;
+  asymm::PublicKey session_public_key_;
 };
 
 }  // namespace launcher
@@ -0,0 +1,194 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/app_registry.h"
+
+#include <cassert>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+AppRegistry::AppRegistry()
+    : apps_(), auto_start_apps_(), apps_by_directory_id_(), changed_apps_() {}
+
+AppRegistry::AppRegistry(AppRegistry&& other) MAIDSAFE_NOEXCEPT
+    : apps_(std::move(other.apps_)),
+      auto_start_apps_(std::move(other.auto_start_apps_)),
+      apps_by_directory_id_(std::move(other.apps_by_directory_id_)),
+      changed_apps_(std::move(other.changed_apps_)) {}
+
+AppRegistry& AppRegistry::operator=(AppRegistry&& other) MAIDSAFE_NOEXCEPT {
+  apps_ = std::move(other.apps_);
+  auto_start_apps_ = std::move(other.auto_start_apps_);
+  apps_by_directory_id_ = std::move(other.apps_by_directory_id_);
+  changed_apps_ = std::move(other.changed_apps_);
+  return *this;
+}
+
+const AppDetails* AppRegistry::Find(const AppName& app_name) const {
+  auto itr(apps_.find(app_name));
+  return itr == apps_.end() ? nullptr : itr->second.get();
+}
+
+std::shared_ptr<const AppDetails> AppRegistry::FindShared(const AppName& app_name) const {
+  auto itr(apps_.find(app_name));
+  return itr == apps_.end() ? nullptr : itr->second;
+}
+
+bool AppRegistry::Insert(AppDetails app) {
+  Apps::iterator itr;
+  if (apps_.empty() || std::prev(apps_.end())->first < app.name) {
+    const AppName app_name(app.name);
+    itr = apps_.emplace_hint(apps_.end(), app_name,
+                             std::make_shared<const AppDetails>(std::move(app)));
+  } else {
+    if (apps_.count(app.name) != 0)
+      return false;
+    const AppName app_name(app.name);
+    itr = apps_.emplace(app_name, std::make_shared<const AppDetails>(std::move(app))).first;
+  }
+  Index(*itr->second);
+  changed_apps_.insert(itr->first);
+  return true;
+}
+
+void AppRegistry::InsertOrReplace(AppDetails app) {
+  auto itr(apps_.find(app.name));
+  if (itr == apps_.end()) {
+    Insert(std::move(app));
+    return;
+  }
+  auto replacement(std::make_shared<const AppDetails>(std::move(app)));
+  Unindex(*itr->second);
+  itr->second = std::move(replacement);
+  Index(*itr->second);
+  changed_apps_.insert(itr->first);
+}
+
+bool AppRegistry::Erase(const AppName& app_name) {
+  auto itr(apps_.find(app_name));
+  if (itr == apps_.end())
+    return false;
+  Unindex(*itr->second);
+  changed_apps_.insert(app_name);
+  apps_.erase(itr);
+  return true;
+}
+
+void AppRegistry::Clear() {
+  for (const auto& app : apps_)
+    changed_apps_.insert(app.first);
+  apps_.clear();
+  auto_start_apps_.clear();
+  apps_by_directory_id_.clear();
+}
+
+void AppRegistry::Modify(const AppName& app_name,
+                         const std::function<void(AppDetails&)>& modifier) {
+  auto itr(apps_.find(app_name));
+  if (itr == apps_.end()) {
+    LOG(kError) << "App \"" << app_name << "\" doesn't exist in registry.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+  }
+
+  // Modify a copy of just this app, so that other registries sharing it are unaffected and so that
+  // this registry is unchanged if 'modifier' throws.
+  AppDetails modified_app(*itr->second);
+  modifier(modified_app);
+  if (modified_app.name != app_name && apps_.count(modified_app.name) != 0) {
+    LOG(kError) << "Can't rename app \"" << app_name << "\" to \"" << modified_app.name
+                << "\" since an app with that name already exists.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+
+  auto replacement(std::make_shared<const AppDetails>(std::move(modified_app)));
+  changed_apps_.insert(app_name);
+  Unindex(*itr->second);
+  if (replacement->name == app_name) {
+    itr->second = std::move(replacement);
+  } else {
+    apps_.erase(itr);
+    const AppName new_name(replacement->name);
+    itr = apps_.emplace(new_name, std::move(replacement)).first;
+    changed_apps_.insert(itr->first);
+  }
+  Index(*itr->second);
+}
+
+void AppRegistry::Restore(const AppName& app_name, std::shared_ptr<const AppDetails> app) {
+  assert(!app || app->name == app_name);
+  auto itr(apps_.find(app_name));
+  if (itr == apps_.end()) {
+    if (!app)
+      return;
+    itr = apps_.emplace(app_name, std::move(app)).first;
+  } else {
+    if (itr->second == app)
+      return;
+    Unindex(*itr->second);
+    if (!app) {
+      changed_apps_.insert(app_name);
+      apps_.erase(itr);
+      return;
+    }
+    itr->second = std::move(app);
+  }
+  Index(*itr->second);
+  changed_apps_.insert(itr->first);
+}
+
+std::set<AppName> AppRegistry::AppsPermittedToAccess(const Identity& directory_id) const {
+  auto itr(apps_by_directory_id_.find(directory_id));
+  return itr == apps_by_directory_id_.end() ? std::set<AppName>() : itr->second;
+}
+
+void AppRegistry::Index(const AppDetails& app) {
+  if (app.auto_start)
+    auto_start_apps_.insert(app.name);
+  for (const auto& dir : app.permitted_dirs)
+    apps_by_directory_id_[dir.directory_id].insert(app.name);
+}
+
+void AppRegistry::Unindex(const AppDetails& app) {
+  auto_start_apps_.erase(app.name);
+  for (const auto& dir : app.permitted_dirs) {
+    auto itr(apps_by_directory_id_.find(dir.directory_id));
+    if (itr == apps_by_directory_id_.end())
+      continue;
+    itr->second.erase(app.name);
+    if (itr->second.empty())
+      apps_by_directory_id_.erase(itr);
+  }
+}
+
+void swap(AppRegistry& lhs, AppRegistry& rhs) MAIDSAFE_NOEXCEPT {
+  using std::swap;
+  swap(lhs.apps_, rhs.apps_);
+  swap(lhs.auto_start_apps_, rhs.auto_start_apps_);
+  swap(lhs.apps_by_directory_id_, rhs.apps_by_directory_id_);
+  swap(lhs.changed_apps_, rhs.changed_apps_);
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
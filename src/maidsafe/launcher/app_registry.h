@@ -0,0 +1,143 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_APP_REGISTRY_H_
+#define MAIDSAFE_LAUNCHER_APP_REGISTRY_H_
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// A collection of apps keyed and ordered by app name.  Apps are looked up by name directly rather
+// than via a temporary 'AppDetails', and are modified via 'Modify' rather than being erased and
+// re-inserted.  Each app is held via a shared_ptr to const which copies of the registry share, so
+// copying a registry doesn't copy the apps (or their icons); modifying an app replaces only that
+// app's pointer in the registry being modified.  'FindShared' and 'Restore' expose these pointers,
+// so that a change to one app can be recorded and later undone in logarithmic time, without
+// copying the registry.  Indexes of the auto-start apps and of the apps
+// permitted to access each directory are kept up to date as apps are inserted, modified and erased,
+// as is the set of apps changed since 'ClearChanged' was last called.
+class AppRegistry {
+ public:
+  using Apps = std::map<AppName, std::shared_ptr<const AppDetails>>;
+
+  // Iterates the apps (not the name/app pairs) in order of name.
+  class const_iterator : public std::iterator<std::bidirectional_iterator_tag, const AppDetails> {
+   public:
+    const_iterator() : itr_() {}
+    explicit const_iterator(Apps::const_iterator itr) : itr_(itr) {}
+    const AppDetails& operator*() const { return *itr_->second; }
+    const AppDetails* operator->() const { return itr_->second.get(); }
+    const_iterator& operator++() {
+      ++itr_;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(itr_++); }
+    const_iterator& operator--() {
+      --itr_;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(itr_--); }
+    bool operator==(const const_iterator& other) const { return itr_ == other.itr_; }
+    bool operator!=(const const_iterator& other) const { return itr_ != other.itr_; }
+
+   private:
+    Apps::const_iterator itr_;
+  };
+
+  AppRegistry();
+
+  AppRegistry(const AppRegistry&) = default;
+  AppRegistry(AppRegistry&& other) MAIDSAFE_NOEXCEPT;
+  AppRegistry& operator=(const AppRegistry&) = default;
+  AppRegistry& operator=(AppRegistry&& other) MAIDSAFE_NOEXCEPT;
+
+  bool empty() const { return apps_.empty(); }
+  std::size_t size() const { return apps_.size(); }
+  const_iterator begin() const { return const_iterator(apps_.begin()); }
+  const_iterator end() const { return const_iterator(apps_.end()); }
+
+  // Returns null if there's no app named 'app_name'.
+  const AppDetails* Find(const AppName& app_name) const;
+  bool Contains(const AppName& app_name) const { return apps_.count(app_name) != 0; }
+  // As 'Find', but returns the shared instance of the app.  Since apps are never modified in place,
+  // passing this to 'Restore' later undoes any changes made to the app in the meantime.
+  std::shared_ptr<const AppDetails> FindShared(const AppName& app_name) const;
+
+  // Returns false without inserting if an app with the same name already exists.  Inserting apps in
+  // order of name (e.g. when parsing) is amortised constant time.
+  bool Insert(AppDetails app);
+  // Inserts 'app', replacing any existing app with the same name.
+  void InsertOrReplace(AppDetails app);
+  // Returns false if there's no app named 'app_name'.
+  bool Erase(const AppName& app_name);
+  void Clear();
+
+  // Applies 'modifier' to a copy of the app named 'app_name' which then replaces the app, and
+  // updates the indexes.  If the modifier renames the app, it's moved to its new key.  Throws
+  // 'CommonErrors::no_such_element' if there's no such app, or
+  // 'CommonErrors::unable_to_handle_request' if the new name is already used.  If this throws (or
+  // 'modifier' throws), the registry is unchanged.
+  void Modify(const AppName& app_name, const std::function<void(AppDetails&)>& modifier);
+
+  // Makes 'app' the app named 'app_name' (which must be its name), or erases the app named
+  // 'app_name' if 'app' is null, and updates the indexes.  Unlike the functions above, 'app' isn't
+  // copied.
+  void Restore(const AppName& app_name, std::shared_ptr<const AppDetails> app);
+
+  const std::set<AppName>& AutoStartApps() const { return auto_start_apps_; }
+  // Returns the names of the apps whose 'permitted_dirs' include the directory 'directory_id'.
+  std::set<AppName> AppsPermittedToAccess(const Identity& directory_id) const;
+
+  // Returns the names of the apps inserted, modified or erased since 'ClearChanged' was last called
+  // (or since construction), e.g. so that only these need be compared when saving.  A renamed app
+  // is included under both its old and new names.  Apps which have since been changed back to their
+  // earlier state are still included.
+  const std::set<AppName>& ChangedApps() const { return changed_apps_; }
+  void ClearChanged() { changed_apps_.clear(); }
+
+  friend void swap(AppRegistry& lhs, AppRegistry& rhs) MAIDSAFE_NOEXCEPT;
+
+ private:
+  void Index(const AppDetails& app);
+  void Unindex(const AppDetails& app);
+
+  Apps apps_;
+  std::set<AppName> auto_start_apps_;
+  std::map<Identity, std::set<AppName>> apps_by_directory_id_;
+  std::set<AppName> changed_apps_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_APP_REGISTRY_H_
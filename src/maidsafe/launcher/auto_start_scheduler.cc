@@ -0,0 +1,128 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/auto_start_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "boost/exception/diagnostic_information.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+AutoStartOptions::AutoStartOptions()
+    : max_concurrent_launches(4), stagger(std::chrono::milliseconds(50)), priority() {}
+
+AutoStartScheduler::AutoStartScheduler(asio::io_service& io_service, Launch launch)
+    : io_service_(io_service),
+      launch_(std::move(launch)),
+      mutex_(),
+      timer_(io_service),
+      timer_pending_(false),
+      options_(),
+      queue_(),
+      in_progress_count_(0),
+      next_launch_time_(),
+      lifetime_guard_() {}
+
+void AutoStartScheduler::Start(std::vector<AppDetails> apps, const AutoStartOptions& options) {
+  std::map<AppName, std::size_t> ranks;
+  for (std::size_t i(0); i < options.priority.size(); ++i)
+    ranks.emplace(options.priority[i], i);
+  auto rank([&](const AppDetails& app) {
+    auto itr(ranks.find(app.name));
+    return itr == ranks.end() ? options.priority.size() : itr->second;
+  });
+  std::sort(apps.begin(), apps.end(), [&](const AppDetails& lhs, const AppDetails& rhs) {
+    const std::size_t lhs_rank(rank(lhs)), rhs_rank(rank(rhs));
+    return lhs_rank == rhs_rank ? lhs.name < rhs.name : lhs_rank < rhs_rank;
+  });
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  options_ = options;
+  for (auto& app : apps)
+    queue_.push_back(std::move(app));
+  LaunchNext();
+}
+
+void AutoStartScheduler::Cancel() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  queue_.clear();
+  timer_.cancel();
+  timer_pending_ = false;
+}
+
+std::size_t AutoStartScheduler::PendingCount() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return queue_.size() + in_progress_count_;
+}
+
+void AutoStartScheduler::LaunchNext() {
+  const std::size_t max_concurrent_launches(std::max<std::size_t>(options_.max_concurrent_launches,
+                                                                  1));
+  while (!queue_.empty() && in_progress_count_ < max_concurrent_launches && !timer_pending_) {
+    const auto now(std::chrono::steady_clock::now());
+    if (now < next_launch_time_) {
+      timer_pending_ = true;
+      timer_.expires_at(next_launch_time_);
+      timer_.async_wait(lifetime_guard_.Wrap([this](const asio::error_code& error) {
+        if (error == asio::error::operation_aborted)
+          return;
+        std::lock_guard<std::mutex> lock{mutex_};
+        timer_pending_ = false;
+        LaunchNext();
+      }));
+      return;
+    }
+    next_launch_time_ = now + options_.stagger;
+    ++in_progress_count_;
+    auto app(std::make_shared<AppDetails>(std::move(queue_.front())));
+    queue_.pop_front();
+    io_service_.post(lifetime_guard_.Wrap([this, app] {
+      auto finished(std::make_shared<std::atomic<bool>>(false));
+      std::function<void()> on_finished(lifetime_guard_.Wrap([this, finished] {
+        if (!finished->exchange(true))
+          Finished();
+      }));
+      try {
+        launch_(*app, on_finished);
+      } catch (const std::exception& e) {
+        LOG(kWarning) << "Failed to auto-start " << app->name << ": "
+                      << boost::diagnostic_information(e);
+        on_finished();
+      }
+    }));
+  }
+}
+
+void AutoStartScheduler::Finished() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  --in_progress_count_;
+  LaunchNext();
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,102 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_AUTO_START_SCHEDULER_H_
+#define MAIDSAFE_LAUNCHER_AUTO_START_SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/steady_timer.hpp"
+
+#include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/executor.h"
+#include "maidsafe/launcher/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+struct AutoStartOptions {
+  AutoStartOptions();
+
+  // The most apps being launched at once (i.e. between being started and finishing their handshake
+  // or failing).  Zero is treated as one.
+  std::size_t max_concurrent_launches;
+  // The minimum interval between starting consecutive launches, to spread the load of app startup.
+  std::chrono::steady_clock::duration stagger;
+  // Apps named here are launched first, in this order.  Other apps follow in order of name.
+  std::vector<AppName> priority;
+};
+
+// Launches a set of apps on 'io_service' in the background, limited by 'AutoStartOptions'.
+// 'launch' is invoked for each app, and must call 'on_finished' once that launch has finished,
+// successfully or not (possibly before returning).  If 'launch' throws, the launch is treated as
+// finished.
+//
+// Handlers left queued on 'io_service' when this is destroyed do nothing, so no further launches
+// are started.  This class is threadsafe.
+class AutoStartScheduler {
+ public:
+  using Launch = std::function<void(const AppDetails& app, std::function<void()> on_finished)>;
+
+  AutoStartScheduler(asio::io_service& io_service, Launch launch);
+
+  AutoStartScheduler(const AutoStartScheduler&) = delete;
+  AutoStartScheduler(AutoStartScheduler&&) = delete;
+  AutoStartScheduler& operator=(const AutoStartScheduler&) = delete;
+  AutoStartScheduler& operator=(AutoStartScheduler&&) = delete;
+
+  // Queues 'apps' to be launched in order of 'options.priority', and returns without waiting for
+  // any launch to start.  'options' replaces those given to any previous call.
+  void Start(std::vector<AppDetails> apps, const AutoStartOptions& options);
+
+  // Discards any apps which haven't yet been launched.  Launches in progress are unaffected.
+  void Cancel();
+
+  // The number of apps queued or being launched.
+  std::size_t PendingCount() const;
+
+ private:
+  // Must be called with 'mutex_' held.
+  void LaunchNext();
+  void Finished();
+
+  asio::io_service& io_service_;
+  const Launch launch_;
+  mutable std::mutex mutex_;
+  asio::steady_timer timer_;
+  bool timer_pending_;
+  AutoStartOptions options_;
+  std::deque<AppDetails> queue_;
+  std::size_t in_progress_count_;
+  std::chrono::steady_clock::time_point next_launch_time_;
+  // Declared last so that it's closed before any other member is destroyed.
+  LifetimeGuard lifetime_guard_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_AUTO_START_SCHEDULER_H_
@@ -0,0 +1,102 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/binary_encoding.h"
+
+#include <limits>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace {
+
+void AppendLittleEndian(std::uint64_t value, std::size_t size, std::string& output) {
+  for (std::size_t i(0); i < size; ++i)
+    output.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+}  // unnamed namespace
+
+void AppendUint8(std::uint8_t value, std::string& output) {
+  output.push_back(static_cast<char>(value));
+}
+
+void AppendUint16(std::uint16_t value, std::string& output) {
+  AppendLittleEndian(value, 2, output);
+}
+
+void AppendUint32(std::uint32_t value, std::string& output) {
+  AppendLittleEndian(value, 4, output);
+}
+
+void AppendString(const std::string& value, std::string& output) {
+  if (value.size() > std::numeric_limits<std::uint32_t>::max()) {
+    LOG(kError) << "String too long to encode.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  AppendUint32(static_cast<std::uint32_t>(value.size()), output);
+  output += value;
+}
+
+BinaryReader::BinaryReader(const std::string& input, std::size_t offset)
+    : input_(input), offset_(offset) {
+  Require(0);
+}
+
+std::uint8_t BinaryReader::ReadUint8() { return static_cast<std::uint8_t>(ReadLittleEndian(1)); }
+
+std::uint16_t BinaryReader::ReadUint16() {
+  return static_cast<std::uint16_t>(ReadLittleEndian(2));
+}
+
+std::uint32_t BinaryReader::ReadUint32() {
+  return static_cast<std::uint32_t>(ReadLittleEndian(4));
+}
+
+std::string BinaryReader::ReadString() { return ReadBytes(ReadUint32()); }
+
+std::string BinaryReader::ReadBytes(std::size_t size) {
+  Require(size);
+  std::string value(input_, offset_, size);
+  offset_ += size;
+  return value;
+}
+
+std::uint64_t BinaryReader::ReadLittleEndian(std::size_t size) {
+  Require(size);
+  std::uint64_t value(0);
+  for (std::size_t i(0); i < size; ++i)
+    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(input_[offset_ + i])) << (8 * i);
+  offset_ += size;
+  return value;
+}
+
+void BinaryReader::Require(std::size_t size) const {
+  if (offset_ > input_.size() || input_.size() - offset_ < size) {
+    LOG(kError) << "Unexpected end of binary data.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_BINARY_ENCODING_H_
+#define MAIDSAFE_LAUNCHER_BINARY_ENCODING_H_
+
+#include <cstdint>
+#include <string>
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Helpers for the launcher's compact local file formats.  Integers are written little-endian and
+// strings are prefixed by their length as a 32-bit integer, so values can be read back without
+// any text formatting or iostreams.
+void AppendUint8(std::uint8_t value, std::string& output);
+void AppendUint16(std::uint16_t value, std::string& output);
+void AppendUint32(std::uint32_t value, std::string& output);
+void AppendString(const std::string& value, std::string& output);
+
+// Reads values written by the functions above from 'input', which must outlive this.  Each 'Read'
+// function throws 'CommonErrors::parsing_error' if 'input' doesn't hold enough remaining bytes.
+class BinaryReader {
+ public:
+  explicit BinaryReader(const std::string& input, std::size_t offset = 0);
+
+  BinaryReader(const BinaryReader&) = delete;
+  BinaryReader(BinaryReader&&) = delete;
+  BinaryReader& operator=(const BinaryReader&) = delete;
+  BinaryReader& operator=(BinaryReader&&) = delete;
+
+  std::uint8_t ReadUint8();
+  std::uint16_t ReadUint16();
+  std::uint32_t ReadUint32();
+  std::string ReadString();
+  // Reads 'size' raw bytes.
+  std::string ReadBytes(std::size_t size);
+
+  std::size_t Offset() const { return offset_; }
+  std::size_t Remaining() const { return input_.size() - offset_; }
+
+ private:
+  std::uint64_t ReadLittleEndian(std::size_t size);
+  void Require(std::size_t size) const;
+
+  const std::string& input_;
+  std::size_t offset_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_BINARY_ENCODING_H_
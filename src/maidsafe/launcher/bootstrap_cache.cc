@@ -0,0 +1,149 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/bootstrap_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/serialisation/types/asio_and_boost_asio.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+const std::size_t BootstrapCache::kMaxEntries = 50;
+
+BootstrapCache::BootstrapCache(boost::filesystem::path file_path)
+    : file_path_(std::move(file_path)), entries_() {
+  boost::system::error_code ec;
+  if (!boost::filesystem::exists(file_path_, ec))
+    return;
+  try {
+    auto contents(ReadFile(file_path_).value());
+    InputVectorStream binary_input_stream{SerialisedData(contents.begin(), contents.end())};
+    BinaryInputArchive input_archive{binary_input_stream};
+    std::uint32_t entry_count;
+    input_archive(entry_count);
+    for (std::uint32_t i(0); i < entry_count; ++i) {
+      asio::ip::address address;
+      std::uint16_t port;
+      std::uint64_t join_duration_ms;
+      Entry entry;
+      input_archive(address, port, join_duration_ms, entry.failure_count);
+      entry.join_duration = std::chrono::milliseconds(join_duration_ms);
+      entries_[asio::ip::udp::endpoint{address, port}] = entry;
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Ignoring corrupt bootstrap cache " << file_path_ << ": "
+                  << boost::diagnostic_information(e);
+    entries_.clear();
+  }
+}
+
+std::vector<asio::ip::udp::endpoint> BootstrapCache::GetPrioritised(std::size_t count) const {
+  std::vector<const Entries::value_type*> sorted;
+  for (const auto& endpoint_and_entry : entries_)
+    sorted.push_back(&endpoint_and_entry);
+  std::sort(std::begin(sorted), std::end(sorted),
+            [](const Entries::value_type* lhs, const Entries::value_type* rhs) {
+              return Precedes(*lhs, *rhs);
+            });
+  std::vector<asio::ip::udp::endpoint> endpoints;
+  for (const auto& endpoint_and_entry : sorted) {
+    if (endpoints.size() == count)
+      break;
+    endpoints.push_back(endpoint_and_entry->first);
+  }
+  return endpoints;
+}
+
+void BootstrapCache::RecordSuccess(const asio::ip::udp::endpoint& endpoint,
+                                   std::chrono::steady_clock::duration join_duration) {
+  auto join_duration_ms(std::chrono::duration_cast<std::chrono::milliseconds>(join_duration));
+  auto itr(entries_.find(endpoint));
+  if (itr == std::end(entries_)) {
+    entries_.emplace(endpoint, Entry{join_duration_ms, 0});
+  } else {
+    // Smooth the recorded duration so that a single slow join doesn't demote a usually-fast
+    // endpoint too far.
+    itr->second.join_duration = (itr->second.join_duration * 3 + join_duration_ms) / 4;
+    itr->second.failure_count = 0;
+  }
+  Trim();
+}
+
+void BootstrapCache::RecordJoinSuccess(
+    const std::vector<asio::ip::udp::endpoint>& bootstrap_contacts,
+    const std::vector<asio::ip::udp::endpoint>& reported_contacts,
+    std::chrono::steady_clock::duration join_duration) {
+  if (!bootstrap_contacts.empty()) {
+    RecordSuccess(bootstrap_contacts.front(), join_duration);
+    return;
+  }
+  for (const auto& endpoint : reported_contacts)
+    RecordSuccess(endpoint, join_duration);
+}
+
+void BootstrapCache::RecordFailure(const asio::ip::udp::endpoint& endpoint) {
+  auto itr(entries_.find(endpoint));
+  if (itr != std::end(entries_))
+    ++itr->second.failure_count;
+}
+
+void BootstrapCache::Save() const {
+  OutputVectorStream binary_output_stream;
+  BinaryOutputArchive output_archive{binary_output_stream};
+  output_archive(static_cast<std::uint32_t>(entries_.size()));
+  for (const auto& endpoint_and_entry : entries_) {
+    output_archive(endpoint_and_entry.first.address(), endpoint_and_entry.first.port(),
+                   static_cast<std::uint64_t>(endpoint_and_entry.second.join_duration.count()),
+                   endpoint_and_entry.second.failure_count);
+  }
+  SerialisedData serialised(binary_output_stream.vector());
+  if (!WriteFile(file_path_, std::string(serialised.begin(), serialised.end()))) {
+    LOG(kError) << "Failed to write bootstrap cache " << file_path_;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+bool BootstrapCache::Precedes(const Entries::value_type& lhs, const Entries::value_type& rhs) {
+  if (lhs.second.failure_count != rhs.second.failure_count)
+    return lhs.second.failure_count < rhs.second.failure_count;
+  if (lhs.second.join_duration != rhs.second.join_duration)
+    return lhs.second.join_duration < rhs.second.join_duration;
+  return lhs.first < rhs.first;
+}
+
+void BootstrapCache::Trim() {
+  while (entries_.size() > kMaxEntries) {
+    auto worst(std::max_element(std::begin(entries_), std::end(entries_), Precedes));
+    entries_.erase(worst);
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
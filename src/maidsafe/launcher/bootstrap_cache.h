@@ -0,0 +1,88 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_BOOTSTRAP_CACHE_H_
+#define MAIDSAFE_LAUNCHER_BOOTSTRAP_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "asio/ip/udp.hpp"
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Records how quickly a connection to the network has previously been established via each
+// bootstrap endpoint, so that the fastest endpoints can be tried first next time.  The records are
+// held in the file at 'file_path'.  This class is not threadsafe.
+class BootstrapCache {
+ public:
+  // Reads the file if it exists.  A missing or corrupt file is treated as an empty cache.
+  explicit BootstrapCache(boost::filesystem::path file_path);
+
+  BootstrapCache(const BootstrapCache&) = delete;
+  BootstrapCache(BootstrapCache&&) = delete;
+  BootstrapCache& operator=(const BootstrapCache&) = delete;
+  BootstrapCache& operator=(BootstrapCache&&) = delete;
+
+  // Returns up to 'count' endpoints, with those which have most recently succeeded first, ordered
+  // fastest first.  Endpoints which have failed since they last succeeded are ordered last.
+  std::vector<asio::ip::udp::endpoint> GetPrioritised(std::size_t count) const;
+
+  void RecordSuccess(const asio::ip::udp::endpoint& endpoint,
+                     std::chrono::steady_clock::duration join_duration);
+  void RecordFailure(const asio::ip::udp::endpoint& endpoint);
+
+  // Records a successful join by an attempt which was started with 'bootstrap_contacts'.  If these
+  // are empty, i.e. the attempt used routing's default contacts (which aren't known here), the
+  // contacts which routing reported while joining are recorded instead, so that a default join
+  // still populates the cache for next time.
+  void RecordJoinSuccess(const std::vector<asio::ip::udp::endpoint>& bootstrap_contacts,
+                         const std::vector<asio::ip::udp::endpoint>& reported_contacts,
+                         std::chrono::steady_clock::duration join_duration);
+
+  // Writes the records to the file.  Throws on error.
+  void Save() const;
+
+  static const std::size_t kMaxEntries;
+
+ private:
+  struct Entry {
+    std::chrono::milliseconds join_duration;
+    std::uint32_t failure_count;
+  };
+
+  using Entries = std::map<asio::ip::udp::endpoint, Entry>;
+
+  // Returns true if 'lhs' should be tried before 'rhs'.
+  static bool Precedes(const Entries::value_type& lhs, const Entries::value_type& rhs);
+  void Trim();
+
+  const boost::filesystem::path file_path_;
+  Entries entries_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_BOOTSTRAP_CACHE_H_
@@ -0,0 +1,76 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/cancellation_token.h"
+
+#include <utility>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+CancellationToken::CancellationToken() : state_(std::make_shared<State>()) {}
+
+void CancellationToken::Cancel() {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  if (state_->cancelled.exchange(true))
+    return;
+  // Handlers are invoked under the lock so that none can run after a concurrent 'RemoveHandler'
+  // has returned.
+  for (const auto& handler : state_->handlers)
+    handler.second();
+}
+
+bool CancellationToken::IsCancelled() const { return state_->cancelled; }
+
+void CancellationToken::ThrowIfCancelled() const {
+  if (IsCancelled()) {
+    LOG(kInfo) << "Operation cancelled.";
+    BOOST_THROW_EXCEPTION(MakeError(AsioErrors::operation_aborted));
+  }
+}
+
+CancellationToken::HandlerId CancellationToken::AddHandler(std::function<void()> handler) {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  if (state_->cancelled)
+    handler();
+  HandlerId handler_id{state_->next_handler_id++};
+  state_->handlers.emplace(handler_id, std::move(handler));
+  return handler_id;
+}
+
+void CancellationToken::RemoveHandler(HandlerId handler_id) {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  state_->handlers.erase(handler_id);
+}
+
+void ThrowIfCancelledOrExpired(const CancellationToken& cancellation_token,
+                               std::chrono::steady_clock::time_point deadline) {
+  cancellation_token.ThrowIfCancelled();
+  if (std::chrono::steady_clock::now() >= deadline) {
+    LOG(kWarning) << "Operation timed out.";
+    BOOST_THROW_EXCEPTION(MakeError(AsioErrors::timed_out));
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
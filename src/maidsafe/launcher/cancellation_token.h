@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_CANCELLATION_TOKEN_H_
+#define MAIDSAFE_LAUNCHER_CANCELLATION_TOKEN_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Allows a long-running operation to be aborted from another thread.  Copies share the same state,
+// so the initiator of an operation keeps one copy and passes another to the operation, which checks
+// it between phases and while blocked.  This class is threadsafe.
+class CancellationToken {
+ public:
+  using HandlerId = std::uint64_t;
+
+  CancellationToken();
+
+  // Cancels the operation and invokes any registered handlers.  Subsequent calls are no-ops.
+  void Cancel();
+
+  bool IsCancelled() const;
+
+  // Throws 'AsioErrors::operation_aborted' if 'Cancel' has been called.
+  void ThrowIfCancelled() const;
+
+  // Registers 'handler' to be invoked on the cancelling thread when 'Cancel' is called, e.g. to
+  // wake a thread which is waiting on a condition variable.  If already cancelled, 'handler' is
+  // invoked immediately.  'handler' mustn't call into this token.  'RemoveHandler' must be called
+  // before anything referred to by 'handler' is destroyed.
+  HandlerId AddHandler(std::function<void()> handler);
+  void RemoveHandler(HandlerId handler_id);
+
+ private:
+  struct State {
+    State() : cancelled(false), mutex(), next_handler_id(0), handlers() {}
+    std::atomic<bool> cancelled;
+    std::mutex mutex;
+    HandlerId next_handler_id;
+    std::map<HandlerId, std::function<void()>> handlers;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+// Throws 'AsioErrors::timed_out' if 'deadline' has passed, or 'AsioErrors::operation_aborted' if
+// 'cancellation_token' has been cancelled.
+void ThrowIfCancelledOrExpired(const CancellationToken& cancellation_token,
+                               std::chrono::steady_clock::time_point deadline);
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_CANCELLATION_TOKEN_H_
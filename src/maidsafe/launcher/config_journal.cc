@@ -0,0 +1,369 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/config_journal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <istream>
+#include <utility>
+
+#ifdef MAIDSAFE_WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "boost/filesystem/fstream.hpp"
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/convert.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/binary_encoding.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace {
+
+#ifndef MAIDSAFE_LAUNCHER_CONFIG_CODEC
+#define MAIDSAFE_LAUNCHER_CONFIG_CODEC kNone
+#endif
+
+const std::string kFileMagic("MSCJ");
+// Version 1 headers hold the magic, version and features.  Version 2 added the codec.
+const std::size_t kHeaderSizeV1(4 + 2 + 4);
+const std::uint32_t kCommitMarker(0x4d434a31);  // "MCJ1"
+const std::size_t kLengthSize(4);
+const std::size_t kChecksumSize(8);
+const std::size_t kMarkerSize(4 + kChecksumSize);
+
+std::string Checksum(const std::string& encrypted_record) {
+  return crypto::Hash<crypto::SHA512>(encrypted_record).string().substr(0, kChecksumSize);
+}
+
+std::FILE* OpenFile(const fs::path& file_path, bool append) {
+#ifdef MAIDSAFE_WIN32
+  return _wfopen(file_path.c_str(), append ? L"ab" : L"wb");
+#else
+  return std::fopen(file_path.c_str(), append ? "ab" : "wb");
+#endif
+}
+
+bool SyncToDisk(std::FILE* file) {
+#ifdef MAIDSAFE_WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Writes 'contents' to 'file_path', either appending or replacing any existing contents, and only
+// returns once they've been flushed to disk.
+void WriteAndSync(const fs::path& file_path, const std::string& contents, bool append) {
+  std::FILE* file(OpenFile(file_path, append));
+  if (!file) {
+    LOG(kError) << "Failed to open " << file_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  on_scope_exit close_file{[file] { std::fclose(file); }};
+  if (std::fwrite(contents.data(), 1, contents.size(), file) != contents.size() ||
+      std::fflush(file) != 0 || !SyncToDisk(file)) {
+    LOG(kError) << "Failed to write " << file_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+// Reads exactly 'size' bytes from 'stream' into 'buffer', reusing its storage.  Returns false if
+// the stream ends first.
+bool ReadExactly(std::istream& stream, std::size_t size, std::string& buffer) {
+  buffer.resize(size);
+  return size == 0 || static_cast<bool>(stream.read(&buffer[0], size));
+}
+
+// Flushes the directory entry of a renamed file to disk.  Windows has no equivalent, but there
+// 'MoveFileEx' (used by 'rename') is documented as durable once it returns.
+void SyncDirectory(const fs::path& directory) {
+#ifndef MAIDSAFE_WIN32
+  int descriptor(open(directory.c_str(), O_RDONLY));
+  if (descriptor == -1)
+    return;
+  if (fsync(descriptor) != 0)
+    LOG(kWarning) << "Failed to sync directory " << directory;
+  close(descriptor);
+#else
+  static_cast<void>(directory);
+#endif
+}
+
+}  // unnamed namespace
+
+const std::size_t ConfigJournal::kMaxRecords = 100;
+const std::uint16_t ConfigJournal::kFormatVersion = 2;
+const std::uint16_t ConfigJournal::kLegacyVersion = 0;
+const std::uint32_t ConfigJournal::kKnownFeatures = 0;
+const ConfigJournal::Codec ConfigJournal::kDefaultCodec = Codec::MAIDSAFE_LAUNCHER_CONFIG_CODEC;
+
+ConfigJournal::ConfigJournal(fs::path file_path, crypto::AES256KeyAndIV key_and_iv, Codec codec)
+    : file_path_(std::move(file_path)),
+      key_and_iv_(std::move(key_and_iv)),
+      record_count_(0),
+      file_version_(kFormatVersion),
+      codec_(codec),
+      file_codec_(codec) {}
+
+std::vector<std::string> ConfigJournal::Recover() {
+  std::vector<std::string> records;
+  Recover([&](std::string record) { records.push_back(std::move(record)); });
+  return records;
+}
+
+void ConfigJournal::Recover(const std::function<void(std::string)>& apply) {
+  record_count_ = 0;
+  file_version_ = kFormatVersion;
+  file_codec_ = codec_;
+  if (!fs::exists(file_path_) || fs::is_empty(file_path_))
+    return;
+
+  const std::uintmax_t file_size(fs::file_size(file_path_));
+  std::uintmax_t committed_size(0);
+  {
+    fs::ifstream file(file_path_, std::ios::binary);
+    if (!file) {
+      LOG(kError) << "Failed to open " << file_path_;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    }
+    committed_size = ReadHeader(file, file_size);
+    if (file_version_ == kLegacyVersion) {
+      RecoverLegacyFile(file, file_size, apply);
+      return;
+    }
+    if (committed_size != 0)
+      file.seekg(static_cast<std::streamoff>(committed_size));
+
+    // Only one record is held in memory at a time, and the buffers are reused between records.
+    std::string buffer, encrypted_record;
+    while (committed_size != 0 && file_size - committed_size >= kLengthSize + kMarkerSize) {
+      if (!ReadExactly(file, kLengthSize, buffer))
+        break;
+      const std::size_t length(BinaryReader{buffer}.ReadUint32());
+      if (length == 0 || file_size - committed_size - kLengthSize - kMarkerSize < length ||
+          !ReadExactly(file, length, encrypted_record) ||
+          !ReadExactly(file, kMarkerSize, buffer)) {
+        break;
+      }
+      BinaryReader marker{buffer};
+      if (marker.ReadUint32() != kCommitMarker ||
+          marker.ReadBytes(kChecksumSize) != Checksum(encrypted_record)) {
+        break;
+      }
+      // The record is intact, so failing to decrypt it isn't a torn write and mustn't truncate it.
+      std::string record;
+      try {
+        record = DecodeRecord(encrypted_record);
+      } catch (const std::exception& e) {
+        LOG(kError) << "Failed to decrypt config record in " << file_path_ << ": "
+                    << boost::diagnostic_information(e);
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+      }
+      apply(std::move(record));
+      ++record_count_;
+      committed_size += kLengthSize + length + kMarkerSize;
+    }
+  }
+
+  if (committed_size != file_size) {
+    LOG(kWarning) << "Discarding " << file_size - committed_size << " uncommitted bytes from "
+                  << file_path_;
+    boost::system::error_code ec;
+    fs::resize_file(file_path_, committed_size, ec);
+    if (ec) {
+      LOG(kError) << "Failed to truncate " << file_path_ << ": " << ec.message();
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    }
+  }
+}
+
+void ConfigJournal::Append(const std::vector<std::string>& records) {
+  // If the write fails, remove whatever part of it reached the file, since recovery stops at the
+  // first uncommitted record and would otherwise ignore any records appended after it.
+  boost::system::error_code ec;
+  const std::uintmax_t committed_size(fs::exists(file_path_, ec) ? fs::file_size(file_path_, ec)
+                                                                   : 0);
+  std::string entries;
+  if (committed_size == 0) {
+    file_version_ = kFormatVersion;
+    file_codec_ = codec_;
+    entries = MakeHeader();
+  }
+  for (const auto& record : records)
+    entries += MakeEntry(record);
+  try {
+    WriteAndSync(file_path_, entries, true);
+  } catch (const std::exception&) {
+    if (!ec)
+      fs::resize_file(file_path_, committed_size, ec);
+    throw;
+  }
+  record_count_ += records.size();
+}
+
+void ConfigJournal::Compact(const std::vector<std::string>& records) {
+  fs::path temp_path(file_path_);
+  temp_path += ".tmp";
+  const Codec previous_codec(file_codec_);
+  file_codec_ = codec_;
+  try {
+    std::string contents(MakeHeader());
+    for (const auto& record : records)
+      contents += MakeEntry(record);
+    WriteAndSync(temp_path, contents, false);
+  } catch (const std::exception&) {
+    file_codec_ = previous_codec;
+    throw;
+  }
+  boost::system::error_code ec;
+  fs::rename(temp_path, file_path_, ec);
+  if (ec) {
+    LOG(kError) << "Failed to replace " << file_path_ << ": " << ec.message();
+    file_codec_ = previous_codec;
+    fs::remove(temp_path, ec);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  SyncDirectory(file_path_.parent_path());
+  record_count_ = records.size();
+  file_version_ = kFormatVersion;
+}
+
+void ConfigJournal::Remove() {
+  boost::system::error_code ec;
+  fs::remove(file_path_, ec);
+  if (ec) {
+    LOG(kError) << "Failed to remove " << file_path_ << ": " << ec.message();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  record_count_ = 0;
+}
+
+std::uintmax_t ConfigJournal::ReadHeader(std::istream& file, std::uintmax_t file_size) {
+  // Read enough for the largest header; any excess is re-read as part of the first record.
+  const std::uintmax_t header_size(std::min<std::uintmax_t>(file_size, kHeaderSizeV1 + 1));
+  std::string header;
+  if (!ReadExactly(file, static_cast<std::size_t>(header_size), header))
+    return 0;
+  // A file which doesn't start with (a prefix of) the magic number is a legacy file rather than a
+  // journal with a torn header.
+  if (header.compare(0, kFileMagic.size(), kFileMagic, 0, header.size()) != 0) {
+    file_version_ = kLegacyVersion;
+    return 0;
+  }
+  BinaryReader reader{header};
+  if (reader.Remaining() < kHeaderSizeV1 || reader.ReadBytes(kFileMagic.size()) != kFileMagic)
+    return 0;
+  const std::uint16_t version(reader.ReadUint16());
+  const std::uint32_t features(reader.ReadUint32());
+  if (version > kFormatVersion || (features & ~kKnownFeatures) != 0) {
+    LOG(kError) << file_path_ << " has version " << version << " and features " << features
+                << ", which this version of the launcher can't read.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  Codec codec(Codec::kNone);
+  if (version >= 2) {
+    if (reader.Remaining() == 0)
+      return 0;
+    codec = static_cast<Codec>(reader.ReadUint8());
+    if (codec > Codec::kMax) {
+      LOG(kError) << file_path_ << " uses unknown codec " << static_cast<int>(codec);
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    }
+  }
+  file_version_ = version;
+  file_codec_ = codec;
+  return reader.Offset();
+}
+
+void ConfigJournal::RecoverLegacyFile(std::istream& file, std::uintmax_t file_size,
+                                      const std::function<void(std::string)>& apply) {
+  // Legacy files were compressed using the highest level.
+  file_codec_ = Codec::kMax;
+  std::string contents, record;
+  file.clear();
+  file.seekg(0);
+  if (!ReadExactly(file, static_cast<std::size_t>(file_size), contents)) {
+    LOG(kError) << "Failed to read " << file_path_;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  try {
+    record = DecodeRecord(contents);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to decrypt legacy config file " << file_path_ << ": "
+                << boost::diagnostic_information(e);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  apply(std::move(record));
+  record_count_ = 1;
+}
+
+std::string ConfigJournal::MakeHeader() const {
+  std::string header(kFileMagic);
+  AppendUint16(kFormatVersion, header);
+  AppendUint32(0, header);  // no optional features are used yet
+  AppendUint8(static_cast<std::uint8_t>(file_codec_), header);
+  return header;
+}
+
+std::string ConfigJournal::MakeEntry(const std::string& record) const {
+  std::string encrypted_record;
+  if (file_codec_ == Codec::kNone) {
+    encrypted_record =
+        crypto::SymmEncrypt(crypto::PlainText{NonEmptyString{record}}, key_and_iv_)->string();
+  } else {
+    const std::uint16_t level(file_codec_ == Codec::kFast ? 1 : 9);
+    encrypted_record =
+        crypto::SymmEncrypt(
+            crypto::Compress(crypto::UncompressedText(convert::ToByteVector(record)), level).data,
+            key_and_iv_)->string();
+  }
+  std::string entry;
+  entry.reserve(kLengthSize + encrypted_record.size() + kMarkerSize);
+  AppendUint32(static_cast<std::uint32_t>(encrypted_record.size()), entry);
+  entry += encrypted_record;
+  AppendUint32(kCommitMarker, entry);
+  entry += Checksum(encrypted_record);
+  return entry;
+}
+
+std::string ConfigJournal::DecodeRecord(const std::string& encrypted_record) const {
+  auto decrypted(
+      crypto::SymmDecrypt(crypto::CipherText{NonEmptyString{encrypted_record}}, key_and_iv_));
+  if (file_codec_ == Codec::kNone)
+    return decrypted.string();
+  return convert::ToString(crypto::Uncompress(crypto::CompressedText(decrypted)).string());
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
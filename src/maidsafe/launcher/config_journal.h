@@ -0,0 +1,140 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_CONFIG_JOURNAL_H_
+#define MAIDSAFE_LAUNCHER_CONFIG_JOURNAL_H_
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/crypto.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// An append-only file of individually-encrypted records, used to hold the local config.  The file
+// starts with a header holding a magic number, the format version, a set of feature flags and the
+// codec used to compress every record in the file before it's encrypted.  Each record is written as
+// its length, the encrypted record, then a commit marker holding a checksum of
+// the encrypted record, and the file is flushed to disk before 'Append' returns.  A record is only
+// considered committed once its marker is intact, so a crash part way through writing can only
+// lose the records being written, never earlier ones.
+//
+// 'Compact' replaces the whole file with the given records by writing a temporary file and renaming
+// it over the journal, so the journal is never seen partially replaced.  Since each record is
+// decrypted and decompressed as a whole when read, the owner should split a large compacted state
+// into several records of bounded size.  A new codec only takes
+// effect when a new file is started, i.e. on compacting or appending to a missing or empty file.
+//
+// A legacy config file, written before the journal was introduced, has no header: the whole file is
+// a single compressed and encrypted record.  It's recovered as a single record with version
+// 'kLegacyVersion', and the owner should then compact it.
+//
+// All functions throw on error.
+class ConfigJournal {
+ public:
+  // Once a journal holds more records than this, the owner should compact it.
+  static const std::size_t kMaxRecords;
+
+  // The version written to new files.  Files with an older version can be read, and should then be
+  // compacted so that records appended afterwards aren't mixed with records of the older version.
+  // Files with a newer version can't be read.
+  static const std::uint16_t kFormatVersion;
+
+  // The version reported by 'FileVersion' for a legacy config file.
+  static const std::uint16_t kLegacyVersion;
+
+  // The header's feature flags indicate optional features used by the file.  A file using any
+  // feature not in 'kKnownFeatures' can't be read.
+  static const std::uint32_t kKnownFeatures;
+
+  // 'kFast' and 'kMax' use the lowest and highest compression levels respectively.  Records are
+  // usually small, so compression only tends to pay off for compacted journals of many apps.
+  enum class Codec : std::uint8_t { kNone, kFast, kMax };
+
+  // Chosen at build time via the 'MAIDSAFE_LAUNCHER_CONFIG_CODEC' definition (e.g. 'kFast'), or
+  // 'kNone' if that's not defined.
+  static const Codec kDefaultCodec;
+
+  ConfigJournal(boost::filesystem::path file_path, crypto::AES256KeyAndIV key_and_iv,
+                Codec codec = kDefaultCodec);
+
+  ConfigJournal(const ConfigJournal&) = delete;
+  ConfigJournal(ConfigJournal&&) = delete;
+  ConfigJournal& operator=(const ConfigJournal&) = delete;
+  ConfigJournal& operator=(ConfigJournal&&) = delete;
+
+  // Returns the decrypted committed records in the order they were appended.  Anything following
+  // the last committed record (i.e. a torn write) is truncated from the file, as is the whole file
+  // if its header is torn.  Returns an empty vector if the file doesn't exist.  Throws
+  // 'CommonErrors::parsing_error' without modifying the file if it has a newer version or uses
+  // unknown features, or if a committed record (or a legacy file) can't be decrypted, e.g. since
+  // the file was written using a different key.
+  std::vector<std::string> Recover();
+  // As above, but passes each record to 'apply' as it's read rather than collecting them.  The file
+  // is streamed, so only one record is held in memory at a time.  'FileVersion' already reflects
+  // the file being recovered when 'apply' is called.
+  void Recover(const std::function<void(std::string)>& apply);
+
+  // Appends 'records' (which must each be non-empty) and flushes them to disk.
+  void Append(const std::vector<std::string>& records);
+
+  // Atomically replaces the journal with one holding only 'records' (which must each be non-empty).
+  void Compact(const std::vector<std::string>& records);
+
+  // Removes the file, if it exists.
+  void Remove();
+
+  std::size_t RecordCount() const { return record_count_; }
+  // The version of the file as last recovered, or 'kFormatVersion' if it's been written since.
+  std::uint16_t FileVersion() const { return file_version_; }
+
+  // The codec used from the next time a new file is started.
+  Codec PreferredCodec() const { return codec_; }
+  void SetCodec(Codec codec) { codec_ = codec; }
+  // The codec of the file as last recovered or written.
+  Codec FileCodec() const { return file_codec_; }
+
+ private:
+  // Parses the header, returning its size, or 0 if it's torn or if this is a legacy file (in which
+  // case 'file_version_' is set to 'kLegacyVersion').
+  std::uintmax_t ReadHeader(std::istream& file, std::uintmax_t file_size);
+  void RecoverLegacyFile(std::istream& file, std::uintmax_t file_size,
+                         const std::function<void(std::string)>& apply);
+  std::string MakeHeader() const;
+  std::string MakeEntry(const std::string& record) const;
+  std::string DecodeRecord(const std::string& encrypted_record) const;
+
+  const boost::filesystem::path file_path_;
+  const crypto::AES256KeyAndIV key_and_iv_;
+  std::size_t record_count_;
+  std::uint16_t file_version_;
+  Codec codec_, file_codec_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_CONFIG_JOURNAL_H_
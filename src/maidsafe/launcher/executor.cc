@@ -0,0 +1,149 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/executor.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(MAIDSAFE_LINUX) || defined(MAIDSAFE_APPLE)
+#include <pthread.h>
+#endif
+#ifdef MAIDSAFE_LINUX
+#include <sched.h>
+#endif
+
+#include "boost/exception/diagnostic_information.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace {
+
+void NameThisThread(const std::string& name) {
+#if defined(MAIDSAFE_LINUX)
+  pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(MAIDSAFE_APPLE)
+  pthread_setname_np(name.substr(0, 63).c_str());
+#else
+  static_cast<void>(name);
+#endif
+}
+
+void PinThisThread(std::size_t core) {
+#ifdef MAIDSAFE_LINUX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core, &cpu_set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+    LOG(kWarning) << "Failed to pin executor thread to core " << core;
+#else
+  static_cast<void>(core);
+#endif
+}
+
+std::mutex& SharedExecutorMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+ExecutorOptions& SharedExecutorOptions() {
+  static ExecutorOptions options;
+  return options;
+}
+
+}  // unnamed namespace
+
+ExecutorOptions::ExecutorOptions()
+    : thread_count(0), blocking_thread_count(4), thread_name("launcher"), pin_threads(false) {}
+
+Executor::Executor(ExecutorOptions options)
+    : io_service_(),
+      blocking_io_service_(),
+      work_(new asio::io_service::work(io_service_)),
+      blocking_work_(new asio::io_service::work(blocking_io_service_)),
+      threads_(),
+      blocking_threads_(),
+      stop_mutex_() {
+  const std::size_t core_count(std::max(std::thread::hardware_concurrency(), 1U));
+  threads_ = StartThreads(io_service_,
+                          options.thread_count != 0 ? options.thread_count : core_count,
+                          options.thread_name + "-", options.pin_threads);
+  blocking_threads_ =
+      StartThreads(blocking_io_service_, std::max<std::size_t>(options.blocking_thread_count, 1),
+                   options.thread_name + "-b", false);
+}
+
+std::vector<std::thread> Executor::StartThreads(asio::io_service& io_service,
+                                                std::size_t thread_count,
+                                                const std::string& name_prefix, bool pin_threads) {
+  const std::size_t core_count(std::max(std::thread::hardware_concurrency(), 1U));
+  std::vector<std::thread> threads;
+  for (std::size_t i(0); i < thread_count; ++i) {
+    threads.emplace_back([&io_service, i, core_count, name_prefix, pin_threads] {
+      NameThisThread(name_prefix + std::to_string(i));
+      if (pin_threads)
+        PinThisThread(i % core_count);
+      for (;;) {
+        try {
+          io_service.run();
+          return;
+        } catch (const std::exception& e) {
+          LOG(kError) << "Unhandled exception on executor thread: "
+                      << boost::diagnostic_information(e);
+        }
+      }
+    });
+  }
+  return threads;
+}
+
+Executor::~Executor() { Stop(); }
+
+void Executor::Stop() {
+  std::lock_guard<std::mutex> lock{stop_mutex_};
+  work_.reset();
+  blocking_work_.reset();
+  io_service_.stop();
+  blocking_io_service_.stop();
+  for (auto* threads : {&threads_, &blocking_threads_}) {
+    for (auto& thread : *threads) {
+      assert(thread.get_id() != std::this_thread::get_id());
+      if (thread.joinable())
+        thread.join();
+    }
+  }
+}
+
+std::shared_ptr<Executor> Executor::Shared() {
+  std::lock_guard<std::mutex> lock{SharedExecutorMutex()};
+  static std::shared_ptr<Executor> executor(std::make_shared<Executor>(SharedExecutorOptions()));
+  return executor;
+}
+
+void Executor::ConfigureShared(ExecutorOptions options) {
+  std::lock_guard<std::mutex> lock{SharedExecutorMutex()};
+  SharedExecutorOptions() = std::move(options);
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,179 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_EXECUTOR_H_
+#define MAIDSAFE_LAUNCHER_EXECUTOR_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+namespace maidsafe {
+
+namespace launcher {
+
+struct ExecutorOptions {
+  ExecutorOptions();
+
+  // The number of threads running 'Executor::service'.  Zero means one thread per core.
+  std::size_t thread_count;
+  // The number of threads running 'Executor::blocking_service', which bounds how many blocking
+  // tasks run at once.  At least one is started.
+  std::size_t blocking_thread_count;
+  // Threads are named "<thread_name>-<index>", or "<thread_name>-b<index>" for the blocking
+  // threads, where supported (truncated to the platform's limit).
+  std::string thread_name;
+  // If true, thread i of 'service' is pinned to core (i % cores).  Only supported on Linux; ignored
+  // elsewhere.
+  bool pin_threads;
+};
+
+// A pool of threads running a single io_service, shared by the Launchers in this process, the
+// static async Launcher functions and everything they own, so that logging in doesn't start
+// several thread pools.  Tasks which block for a long time (e.g. waiting to join the network, or
+// saving the account) are run on a separate, small pool via 'blocking_service' instead, so that
+// however many are queued, they can't starve the timers and strands on 'service'.  The threads are
+// started on construction and stopped on destruction (or 'Stop').  Anything using the io_services
+// must stop doing so before this is destroyed, or guard its handlers via a 'LifetimeGuard' if it
+// may be destroyed first.
+class Executor {
+ public:
+  explicit Executor(ExecutorOptions options = ExecutorOptions());
+  ~Executor();
+
+  Executor(const Executor&) = delete;
+  Executor(Executor&&) = delete;
+  Executor& operator=(const Executor&) = delete;
+  Executor& operator=(Executor&&) = delete;
+
+  asio::io_service& service() { return io_service_; }
+  asio::io_service& blocking_service() { return blocking_io_service_; }
+  std::size_t ThreadCount() const { return threads_.size(); }
+  std::size_t BlockingThreadCount() const { return blocking_threads_.size(); }
+  // Joins the threads, abandoning any queued handlers.  Must not be called from one of the threads.
+  void Stop();
+
+  // Returns the process-wide instance, creating it on first use with the options most recently
+  // passed to 'ConfigureShared' (or the defaults).
+  static std::shared_ptr<Executor> Shared();
+  // Only affects 'Shared' if called before its first use.
+  static void ConfigureShared(ExecutorOptions options);
+
+ private:
+  // Starts 'thread_count' threads running 'io_service', named "<name_prefix><index>".
+  static std::vector<std::thread> StartThreads(asio::io_service& io_service,
+                                               std::size_t thread_count,
+                                               const std::string& name_prefix, bool pin_threads);
+
+  asio::io_service io_service_, blocking_io_service_;
+  std::unique_ptr<asio::io_service::work> work_, blocking_work_;
+  std::vector<std::thread> threads_, blocking_threads_;
+  std::mutex stop_mutex_;
+};
+
+// Lets an object safely post handlers to an executor which may outlive it.  Each handler wrapped
+// via 'Wrap' does nothing if it's run after 'Close', and 'Close' blocks until any wrapped handlers
+// which are already running have returned.  An object should call 'Close' at the start of its
+// destructor, before any of its members are destroyed.  If 'Close' is called from inside a wrapped
+// handler (e.g. a callback which destroys the object), that handler isn't waited for.
+//
+// Wrap the innermost handler, e.g. 'strand.wrap(guard.Wrap(handler))', so that it's the handler
+// itself rather than its dispatch which is guarded.
+class LifetimeGuard {
+  struct State {
+    State() : mutex(), condition(), closed(false), running() {}
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool closed;
+    // The threads running wrapped handlers (with repeats for nested handlers).
+    std::vector<std::thread::id> running;
+  };
+
+ public:
+  template <typename Handler>
+  class Wrapped {
+   public:
+    Wrapped(std::shared_ptr<State> state, Handler handler)
+        : state_(std::move(state)), handler_(std::move(handler)) {}
+
+    template <typename... Args>
+    void operator()(Args&&... args) {
+      {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        if (state_->closed)
+          return;
+        state_->running.push_back(std::this_thread::get_id());
+      }
+      struct Exit {
+        ~Exit() {
+          std::lock_guard<std::mutex> lock{state->mutex};
+          state->running.erase(std::find(state->running.begin(), state->running.end(),
+                                         std::this_thread::get_id()));
+          state->condition.notify_all();
+        }
+        State* state;
+      } exit{state_.get()};
+      handler_(std::forward<Args>(args)...);
+    }
+
+   private:
+    std::shared_ptr<State> state_;
+    Handler handler_;
+  };
+
+  LifetimeGuard() : state_(std::make_shared<State>()) {}
+  ~LifetimeGuard() { Close(); }
+
+  LifetimeGuard(const LifetimeGuard&) = delete;
+  LifetimeGuard(LifetimeGuard&&) = delete;
+  LifetimeGuard& operator=(const LifetimeGuard&) = delete;
+  LifetimeGuard& operator=(LifetimeGuard&&) = delete;
+
+  template <typename Handler>
+  Wrapped<typename std::decay<Handler>::type> Wrap(Handler&& handler) const {
+    return Wrapped<typename std::decay<Handler>::type>(state_, std::forward<Handler>(handler));
+  }
+
+  void Close() {
+    std::unique_lock<std::mutex> lock{state_->mutex};
+    state_->closed = true;
+    const std::thread::id this_thread(std::this_thread::get_id());
+    state_->condition.wait(lock, [&] {
+      return std::all_of(state_->running.begin(), state_->running.end(),
+                         [&](const std::thread::id& id) { return id == this_thread; });
+    });
+  }
+
+ private:
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_EXECUTOR_H_
@@ -20,15 +20,21 @@
 #define MAIDSAFE_LAUNCHER_LAUNCH_H_
 
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 
+#include "asio/io_service.hpp"
 #include "asio/io_service_strand.hpp"
 #include "asio/steady_timer.hpp"
 
-#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/tcp/connection.h"
-#include "maidsafe/common/tcp/listener.h"
 
+#include "maidsafe/launcher/app_handshake.h"
+#include "maidsafe/launcher/launch_trace.h"
+#include "maidsafe/launcher/process_supervisor.h"
 #include "maidsafe/launcher/types.h"
 
 namespace maidsafe {
@@ -36,12 +42,18 @@ namespace maidsafe {
 namespace launcher {
 
 struct Launch {
-  Launch(AppName name_in, AsioService& asio_service,
+  Launch(AppName name_in, asio::io_service& io_service,
          const std::chrono::steady_clock::duration& expiry_time)
       : name(std::move(name_in)),
-        strand(asio_service.service()),
-        timer(asio_service.service(), expiry_time),
-        connection() {}
+        strand(io_service),
+        timer(io_service, expiry_time),
+        token(),
+        process_id(0),
+        connection(),
+        handshake(),
+        on_finished(),
+        trace_mutex(),
+        trace(name) {}
   Launch() = delete;
   ~Launch() = default;
   Launch(const Launch&) = delete;
@@ -52,8 +64,20 @@ struct Launch {
   AppName name;
   asio::io_service::strand strand;
   asio::steady_timer timer;
+  // Passed to the app on its command line, and sent back by the app as its first message so that
+  // its connection to the Launcher's shared listener can be matched to this launch.
+  std::string token;
+  // Zero until the app's process has been spawned.
+  ProcessSupervisor::ProcessId process_id;
   tcp::ConnectionPtr connection;
-  tcp::ListenerPtr listener;
+  // Null until the app has connected and sent its token.
+  std::shared_ptr<AppHandshake> handshake;
+  // Invoked once the launch has succeeded or failed.
+  std::function<void()> on_finished;
+  // Unlike the other members, 'trace' may be updated off 'strand' (e.g. as 'LaunchApp' returns), so
+  // is guarded by 'trace_mutex'.
+  std::mutex trace_mutex;
+  LaunchTrace trace;
 };
 
 }  // namespace launcher
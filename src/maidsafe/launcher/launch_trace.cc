@@ -0,0 +1,254 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/launch_trace.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/json.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace {
+
+std::int64_t ToMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void WriteSummary(const LaunchStats::Summary& summary, std::ostream& output) {
+  output << "{\"count\": " << summary.count << ", \"p50_us\": " << summary.p50.count()
+         << ", \"p95_us\": " << summary.p95.count() << ", \"p99_us\": " << summary.p99.count()
+         << ", \"max_us\": " << summary.max.count() << "}";
+}
+
+LaunchStats::Summary Summarise(const LatencyHistogram& histogram) {
+  return LaunchStats::Summary{histogram.Count(), histogram.Percentile(50),
+                              histogram.Percentile(95), histogram.Percentile(99),
+                              histogram.Max()};
+}
+
+}  // unnamed namespace
+
+std::string ToString(LaunchPhase phase) {
+  switch (phase) {
+    case LaunchPhase::kListen:
+      return "listen";
+    case LaunchPhase::kSpawn:
+      return "spawn";
+    case LaunchPhase::kConnect:
+      return "connect";
+    case LaunchPhase::kSessionKey:
+      return "session_key";
+    case LaunchPhase::kConfirmation:
+      return "confirmation";
+    default:
+      return "unknown";
+  }
+}
+
+std::string ToString(LaunchTrace::Outcome outcome) {
+  switch (outcome) {
+    case LaunchTrace::Outcome::kInProgress:
+      return "in_progress";
+    case LaunchTrace::Outcome::kSucceeded:
+      return "succeeded";
+    case LaunchTrace::Outcome::kTimedOut:
+      return "timed_out";
+    case LaunchTrace::Outcome::kFailed:
+      return "failed";
+    default:
+      return "unknown";
+  }
+}
+
+LaunchTrace::LaunchTrace(AppName app_name)
+    : app_name_(std::move(app_name)),
+      outcome_(Outcome::kInProgress),
+      spans_(1, Span{LaunchPhase::kListen, std::chrono::steady_clock::now(),
+                     std::chrono::steady_clock::time_point()}) {}
+
+void LaunchTrace::BeginPhase(LaunchPhase phase) {
+  if (outcome_ != Outcome::kInProgress)
+    return;
+  const auto now(std::chrono::steady_clock::now());
+  spans_.back().end = now;
+  spans_.push_back(Span{phase, now, std::chrono::steady_clock::time_point()});
+}
+
+bool LaunchTrace::Finish(Outcome outcome) {
+  assert(outcome != Outcome::kInProgress);
+  if (outcome_ != Outcome::kInProgress)
+    return false;
+  spans_.back().end = std::chrono::steady_clock::now();
+  outcome_ = outcome;
+  return true;
+}
+
+std::chrono::steady_clock::duration LaunchTrace::Duration() const {
+  if (outcome_ == Outcome::kInProgress)
+    return std::chrono::steady_clock::duration(0);
+  return spans_.back().end - spans_.front().begin;
+}
+
+LatencyHistogram::LatencyHistogram() : buckets_(), count_(0), max_(0) { buckets_.fill(0); }
+
+void LatencyHistogram::Add(std::chrono::steady_clock::duration latency) {
+  const auto microseconds(std::max(std::chrono::duration_cast<std::chrono::microseconds>(latency),
+                                   std::chrono::microseconds(0)));
+  ++buckets_[BucketIndex(microseconds)];
+  ++count_;
+  max_ = std::max(max_, microseconds);
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0)
+    return std::chrono::microseconds(0);
+  const auto rank(std::max(static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count_)),
+                           std::uint64_t(1)));
+  std::uint64_t cumulative_count(0);
+  for (std::size_t i(0); i < kBucketCount; ++i) {
+    cumulative_count += buckets_[i];
+    if (cumulative_count >= rank)
+      return i == kBucketCount - 1 ? max_ : std::min(BucketUpperBound(i), max_);
+  }
+  return max_;
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::chrono::microseconds latency) {
+  if (latency.count() <= 1)
+    return 0;
+  const auto index(static_cast<std::size_t>(std::ceil(4.0 * std::log2(latency.count()))));
+  return std::min(index, kBucketCount - 1);
+}
+
+std::chrono::microseconds LatencyHistogram::BucketUpperBound(std::size_t index) {
+  return std::chrono::microseconds(std::llround(std::pow(2.0, index / 4.0)));
+}
+
+const std::size_t LaunchStats::kMaxRecentTraces(100);
+
+LaunchStats::Histograms::Histograms()
+    : succeeded(0), timed_out(0), failed(0), total(), phases() {}
+
+LaunchStats::LaunchStats() : mutex_(), histograms_(), recent_traces_() {}
+
+void LaunchStats::Record(LaunchTrace trace) {
+  assert(trace.GetOutcome() != LaunchTrace::Outcome::kInProgress);
+  std::lock_guard<std::mutex> lock{mutex_};
+  Histograms& histograms(histograms_[trace.GetAppName()]);
+  const auto& spans(trace.Spans());
+  auto completed_spans_end(spans.end());
+  switch (trace.GetOutcome()) {
+    case LaunchTrace::Outcome::kSucceeded:
+      ++histograms.succeeded;
+      histograms.total.Add(trace.Duration());
+      break;
+    case LaunchTrace::Outcome::kTimedOut:
+      ++histograms.timed_out;
+      --completed_spans_end;
+      break;
+    default:
+      ++histograms.failed;
+      --completed_spans_end;
+      break;
+  }
+  for (auto itr(spans.begin()); itr != completed_spans_end; ++itr)
+    histograms.phases[static_cast<std::size_t>(itr->phase)].Add(itr->end - itr->begin);
+
+  recent_traces_.push_back(std::move(trace));
+  if (recent_traces_.size() > kMaxRecentTraces)
+    recent_traces_.pop_front();
+}
+
+std::map<AppName, LaunchStats::AppStats> LaunchStats::GetAppStats() const {
+  std::map<AppName, AppStats> app_stats;
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& app_and_histograms : histograms_) {
+    const Histograms& histograms(app_and_histograms.second);
+    AppStats stats{histograms.succeeded, histograms.timed_out, histograms.failed,
+                   Summarise(histograms.total), std::map<LaunchPhase, Summary>()};
+    for (std::size_t i(0); i < kLaunchPhaseCount; ++i) {
+      if (histograms.phases[i].Count() != 0)
+        stats.phases.emplace(static_cast<LaunchPhase>(i), Summarise(histograms.phases[i]));
+    }
+    app_stats.emplace(app_and_histograms.first, std::move(stats));
+  }
+  return app_stats;
+}
+
+std::vector<LaunchTrace> LaunchStats::GetRecentTraces() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return std::vector<LaunchTrace>(recent_traces_.begin(), recent_traces_.end());
+}
+
+void LaunchStats::WriteToFile(const boost::filesystem::path& path) const {
+  const std::map<AppName, AppStats> app_stats(GetAppStats());
+  const std::vector<LaunchTrace> recent_traces(GetRecentTraces());
+
+  std::ostringstream output;
+  output << "{\n  \"apps\": [";
+  for (auto itr(app_stats.begin()); itr != app_stats.end(); ++itr) {
+    output << (itr == app_stats.begin() ? "\n" : ",\n") << "    {\"name\": "
+           << JsonString(itr->first) << ", \"succeeded\": " << itr->second.succeeded
+           << ", \"timed_out\": " << itr->second.timed_out << ", \"failed\": "
+           << itr->second.failed << ",\n     \"total\": ";
+    WriteSummary(itr->second.total, output);
+    output << ",\n     \"phases\": {";
+    for (auto phase_itr(itr->second.phases.begin()); phase_itr != itr->second.phases.end();
+         ++phase_itr) {
+      output << (phase_itr == itr->second.phases.begin() ? "\n" : ",\n") << "       "
+             << JsonString(ToString(phase_itr->first)) << ": ";
+      WriteSummary(phase_itr->second, output);
+    }
+    output << "}}";
+  }
+  output << "],\n  \"recent_launches\": [";
+  for (auto itr(recent_traces.begin()); itr != recent_traces.end(); ++itr) {
+    output << (itr == recent_traces.begin() ? "\n" : ",\n") << "    {\"app\": "
+           << JsonString(itr->GetAppName()) << ", \"outcome\": "
+           << JsonString(ToString(itr->GetOutcome())) << ", \"begin_us\": "
+           << ToMicroseconds(itr->Begin().time_since_epoch()) << ", \"spans\": [";
+    for (auto span_itr(itr->Spans().begin()); span_itr != itr->Spans().end(); ++span_itr) {
+      output << (span_itr == itr->Spans().begin() ? "" : ", ") << "{\"phase\": "
+             << JsonString(ToString(span_itr->phase)) << ", \"begin_us\": "
+             << ToMicroseconds(span_itr->begin - itr->Begin()) << ", \"end_us\": "
+             << ToMicroseconds(span_itr->end - itr->Begin()) << "}";
+    }
+    output << "]}";
+  }
+  output << "]\n}\n";
+
+  if (!WriteFile(path, output.str())) {
+    LOG(kError) << "Failed to write launch stats to " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,170 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_LAUNCH_TRACE_H_
+#define MAIDSAFE_LAUNCHER_LAUNCH_TRACE_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/launcher/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// The phases of a launch, in the order they happen.
+enum class LaunchPhase : std::uint8_t {
+  kListen,        // creating (or reusing) the shared listener and registering the launch
+  kSpawn,         // starting the app's process
+  kConnect,       // waiting for the app to connect and send its launch token
+  kSessionKey,    // waiting for the app to send its session key
+  kConfirmation   // sending the app its directories and waiting for it to confirm receipt
+};
+
+const std::size_t kLaunchPhaseCount(5);
+
+// E.g. "session_key".
+std::string ToString(LaunchPhase phase);
+
+// The timeline of a single launch as a series of consecutive phases, with monotonic timestamps.
+// This class isn't threadsafe.
+class LaunchTrace {
+ public:
+  enum class Outcome { kInProgress, kSucceeded, kTimedOut, kFailed };
+  struct Span {
+    LaunchPhase phase;
+    std::chrono::steady_clock::time_point begin, end;
+  };
+
+  // Begins the 'kListen' phase.
+  explicit LaunchTrace(AppName app_name);
+
+  // Ends the current phase and begins 'phase'.  Does nothing once the trace is finished.
+  void BeginPhase(LaunchPhase phase);
+  // Ends the current phase.  Returns false (and does nothing) if the trace is already finished.
+  // Unless 'outcome' is 'kSucceeded', the last span is the phase in which the launch failed.
+  bool Finish(Outcome outcome);
+
+  const AppName& GetAppName() const { return app_name_; }
+  Outcome GetOutcome() const { return outcome_; }
+  // The end of the last span is unset while the trace is in progress.
+  const std::vector<Span>& Spans() const { return spans_; }
+  std::chrono::steady_clock::time_point Begin() const { return spans_.front().begin; }
+  // Zero while the trace is in progress.
+  std::chrono::steady_clock::duration Duration() const;
+
+ private:
+  AppName app_name_;
+  Outcome outcome_;
+  std::vector<Span> spans_;
+};
+
+std::string ToString(LaunchTrace::Outcome outcome);
+
+// Counts latencies in buckets whose bounds grow exponentially (by a factor of 2^(1/4), i.e. about
+// 19%) from 1 microsecond up to about an hour, with a final bucket for anything longer.  Memory is
+// constant however many latencies are added, and each percentile is accurate to within one bucket.
+// This class isn't threadsafe.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void Add(std::chrono::steady_clock::duration latency);
+
+  std::uint64_t Count() const { return count_; }
+  // Returns the upper bound of the bucket holding 'percentile' (in the range (0, 100]), capped at
+  // the largest latency added, or zero if none have been added.
+  std::chrono::microseconds Percentile(double percentile) const;
+  std::chrono::microseconds Max() const { return max_; }
+
+ private:
+  static const std::size_t kBucketCount = 128;
+  static std::size_t BucketIndex(std::chrono::microseconds latency);
+  static std::chrono::microseconds BucketUpperBound(std::size_t index);
+
+  std::array<std::uint64_t, kBucketCount> buckets_;
+  std::uint64_t count_;
+  std::chrono::microseconds max_;
+};
+
+// Aggregates finished launch traces into per-app, per-phase latency histograms, and keeps the most
+// recent traces.  Phases in which a launch failed (e.g. timed out) aren't added to the histograms,
+// and the whole launch's duration is only added if it succeeded, so that a few timeouts don't mask
+// the normal latencies.  This class is threadsafe.
+class LaunchStats {
+ public:
+  struct Summary {
+    std::uint64_t count;
+    std::chrono::microseconds p50, p95, p99, max;
+  };
+  struct AppStats {
+    std::uint64_t succeeded, timed_out, failed;
+    // Successful launches only.
+    Summary total;
+    // Only holds the phases which have completed at least once.
+    std::map<LaunchPhase, Summary> phases;
+  };
+
+  static const std::size_t kMaxRecentTraces;
+
+  LaunchStats();
+
+  LaunchStats(const LaunchStats&) = delete;
+  LaunchStats(LaunchStats&&) = delete;
+  LaunchStats& operator=(const LaunchStats&) = delete;
+  LaunchStats& operator=(LaunchStats&&) = delete;
+
+  // 'trace' must be finished.
+  void Record(LaunchTrace trace);
+
+  std::map<AppName, AppStats> GetAppStats() const;
+  // Oldest first.
+  std::vector<LaunchTrace> GetRecentTraces() const;
+
+  // Writes the stats and recent traces as JSON to 'path', replacing any existing file.  Times are
+  // in microseconds.  Each trace's 'begin_us' is the time since the steady clock's epoch, and its
+  // spans' times are relative to that.  Throws on error.
+  void WriteToFile(const boost::filesystem::path& path) const;
+
+ private:
+  struct Histograms {
+    Histograms();
+    std::uint64_t succeeded, timed_out, failed;
+    LatencyHistogram total;
+    std::array<LatencyHistogram, kLaunchPhaseCount> phases;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<AppName, Histograms> histograms_;
+  std::deque<LaunchTrace> recent_traces_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_LAUNCH_TRACE_H_
@@ -18,12 +18,23 @@
 
 #include "maidsafe/launcher/launcher.h"
 
+#include <atomic>
+#include <exception>
+#include <future>
+#include <set>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "asio/io_service_strand.hpp"
 #include "asio/dispatch.hpp"
+#include "asio/steady_timer.hpp"
+#include "boost/filesystem/operations.hpp"
 
 #include "maidsafe/common/application_support_directories.h"
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/encode.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #ifdef TESTING
@@ -33,7 +44,9 @@
 
 #include "maidsafe/launcher/account.h"
 #include "maidsafe/launcher/account_getter.h"
+#include "maidsafe/launcher/config_journal.h"
 #include "maidsafe/launcher/launch.h"
+#include "maidsafe/launcher/profiler.h"
 
 namespace maidsafe {
 
@@ -41,7 +54,8 @@ namespace launcher {
 
 namespace {
 
-boost::filesystem::path GetConfigFilePath() {
+// The config file which, before each account had its own, was shared by all accounts.
+boost::filesystem::path GetSharedConfigFilePath() {
 #if defined(USE_FAKE_STORE)
   return Launcher::FakeStorePath() / "config.txt";
 #elif defined(TESTING)
@@ -53,6 +67,81 @@ boost::filesystem::path GetConfigFilePath() {
 #endif
 }
 
+// Each account's config file is named after a hash of its unique user ID, so that concurrent
+// sessions of different accounts don't share a file and the ID isn't exposed.
+boost::filesystem::path GetConfigFilePath(const Identity& unique_user_id) {
+  const boost::filesystem::path shared_path(GetSharedConfigFilePath());
+  return shared_path.parent_path() /
+         (shared_path.stem().string() + "_" +
+          hex::Encode(crypto::Hash<crypto::SHA512>(unique_user_id.string()).string()) +
+          shared_path.extension().string());
+}
+
+// Moves the shared config file to 'config_file_path' if this account doesn't have its own yet and
+// the shared file can be read using this account's key, i.e. it was written by this account.
+void AdoptSharedConfigFile(const boost::filesystem::path& config_file_path,
+                           const crypto::AES256KeyAndIV& key_and_iv) {
+  const boost::filesystem::path shared_path(GetSharedConfigFilePath());
+  boost::system::error_code ec;
+  if (boost::filesystem::exists(config_file_path, ec) ||
+      !boost::filesystem::exists(shared_path, ec)) {
+    return;
+  }
+  try {
+    ConfigJournal{shared_path, key_and_iv}.Recover([](std::string) {});
+  } catch (const std::exception& e) {
+    LOG(kInfo) << "Not adopting " << shared_path << ": " << boost::diagnostic_information(e);
+    return;
+  }
+  boost::filesystem::rename(shared_path, config_file_path, ec);
+  if (ec) {
+    LOG(kWarning) << "Failed to move " << shared_path << " to " << config_file_path << ": "
+                  << ec.message();
+  }
+}
+
+boost::filesystem::path GetAccountCacheDir() {
+#if defined(USE_FAKE_STORE)
+  return Launcher::FakeStorePath() / "account_cache";
+#elif defined(TESTING)
+  static maidsafe::test::TestPath test_path(
+      maidsafe::test::CreateTestPath("MaidSafe_TestAccountCache"));
+  return *test_path;
+#else
+  return GetUserAppDir() / "account_cache";
+#endif
+}
+
+std::atomic<bool>& AccountCacheEnabled() {
+  static std::atomic<bool> enabled(false);
+  return enabled;
+}
+
+std::mutex& AutoStartOptionsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+AutoStartOptions& GetAutoStartOptions() {
+  static AutoStartOptions options;
+  return options;
+}
+
+std::shared_ptr<NetworkClient> MakeNetworkClient(const Account& account) {
+#ifdef ROUTING_AND_NFS_UPDATED
+#ifdef USE_FAKE_STORE
+  static_cast<void>(account);
+  return std::make_shared<NetworkClient>(Launcher::FakeStorePath(), Launcher::FakeStoreDiskUsage());
+#else
+  return nfs_client::MaidClient::MakeShared(account.passport->GetMaid());
+#endif
+#else
+  static_cast<void>(account);
+  return std::make_shared<NetworkClient>(MemoryUsage(1 << 7), Launcher::FakeStoreDiskUsage(),
+                                         nullptr, Launcher::FakeStorePath());
+#endif
+}
+
 authentication::UserCredentials ConvertToCredentials(Keyword keyword, Pin pin, Password password) {
   authentication::UserCredentials user_credentials;
   user_credentials.keyword =
@@ -64,44 +153,125 @@ authentication::UserCredentials ConvertToCredentials(Keyword keyword, Pin pin, P
   return user_credentials;
 }
 
+// Runs 'functor' on one of 'io_service's threads, returning a future to its result.  'on_ready'
+// (if non-null) is invoked on the same thread once the future is ready.  If 'guard' is non-null
+// and has been closed before the functor runs, neither is invoked and the future will hold a
+// 'broken_promise' error.
+template <typename Functor>
+std::future<typename std::result_of<Functor()>::type> Post(
+    asio::io_service& io_service, Functor functor, std::function<void()> on_ready = nullptr,
+    const LifetimeGuard* guard = nullptr) {
+  using Result = typename std::result_of<Functor()>::type;
+  auto task(std::make_shared<std::packaged_task<Result()>>(std::move(functor)));
+  auto future(task->get_future());
+  auto run([task, on_ready] {
+    (*task)();
+    if (on_ready)
+      on_ready();
+  });
+  if (guard)
+    io_service.post(guard->Wrap(std::move(run)));
+  else
+    io_service.post(std::move(run));
+  return future;
+}
+
 }  // unnamed namespace
 
 const std::chrono::steady_clock::duration Launcher::connect_timeout_(std::chrono::minutes(1));
 const std::chrono::steady_clock::duration Launcher::handshake_timeout_(std::chrono::seconds(5));
 
+Launcher::Launcher(authentication::UserCredentials&& user_credentials,
+                   const DerivedCredentials& derived_credentials, AccountGetter& account_getter,
+                   const CancellationToken& cancellation_token,
+                   std::shared_ptr<Executor> executor)
+    : executor_(std::move(executor)),
+      lifetime_guard_(),
+      network_client_(),
+      account_handler_(),
+      account_mutex_(),
+      app_handler_(),
+      rollback_mutex_(),
+      rollback_snapshot_(),
+      reconcile_mutex_(),
+      needs_reconcile_(false),
+      reconcile_cancellation_(),
+      save_scheduler_(executor_->blocking_service(),
+                      lifetime_guard_.Wrap([this] { SaveSession(false); })),
+      icon_cache_mutex_(),
+      icon_cache_(),
+      launch_listener_strand_(executor_->service()),
+      launch_stats_(),
+      launches_mutex_(),
+      launch_listener_(),
+      pending_launches_(),
+      process_supervisor_(executor_->service()),
+      auto_start_scheduler_(
+          executor_->service(),
+          lifetime_guard_.Wrap([this](const AppDetails& app, std::function<void()> on_finished) {
+            LaunchApp(app.name, app.path, app.args, std::move(on_finished));
+          })) {
+  account_handler_.Login(std::move(user_credentials), derived_credentials, account_getter,
+                         cancellation_token);
+  network_client_ = MakeNetworkClient(*account_handler_.account_);
+  MigrateLegacyIcons();
+  InitialiseAppHandler();
+  UpdateAccountCache();
+  LaunchAutoStartApps();
+}
 
-
-Launcher::Launcher(Keyword keyword, Pin pin, Password password, AccountGetter& account_getter)
-    : asio_service_(5),
+Launcher::Launcher(authentication::UserCredentials&& user_credentials,
+                   const DerivedCredentials& derived_credentials,
+                   const AccountCache& account_cache, std::shared_ptr<Executor> executor)
+    : executor_(std::move(executor)),
+      lifetime_guard_(),
       network_client_(),
       account_handler_(),
       account_mutex_(),
       app_handler_(),
-      rollback_snapshot_() {
-  account_handler_.Login(ConvertToCredentials(keyword, pin, password), account_getter);
-#ifdef ROUTING_AND_NFS_UPDATED
-#ifdef USE_FAKE_STORE
-  network_client_ = std::make_shared<NetworkClient>(FakeStorePath(), FakeStoreDiskUsage());
-#else
-  network_client_ =
-      nfs_client::MaidClient::MakeShared(account_handler_.account_->passport->GetMaid());
-#endif
-#else
-  network_client_ = std::make_shared<NetworkClient>(
-      MemoryUsage(1 << 7), Launcher::FakeStoreDiskUsage(), nullptr, Launcher::FakeStorePath());
-#endif
-  app_handler_.Initialise(GetConfigFilePath(), account_handler_.account_.get(), &account_mutex_);
-  // Auto-start any relevant apps
-  std::set<AppDetails> local_apps(app_handler_.GetApps(true));
-  for (const auto& app : local_apps) {
-    if (app.auto_start)
-      LaunchApp(app.name, app.path, std::move(app.args));
+      rollback_mutex_(),
+      rollback_snapshot_(),
+      reconcile_mutex_(),
+      needs_reconcile_(true),
+      reconcile_cancellation_(),
+      save_scheduler_(executor_->blocking_service(),
+                      lifetime_guard_.Wrap([this] { SaveSession(false); })),
+      icon_cache_mutex_(),
+      icon_cache_(),
+      launch_listener_strand_(executor_->service()),
+      launch_stats_(),
+      launches_mutex_(),
+      launch_listener_(),
+      pending_launches_(),
+      process_supervisor_(executor_->service()),
+      auto_start_scheduler_(
+          executor_->service(),
+          lifetime_guard_.Wrap([this](const AppDetails& app, std::function<void()> on_finished) {
+            LaunchApp(app.name, app.path, app.args, std::move(on_finished));
+          })) {
+  if (!account_handler_.LoginFromCache(std::move(user_credentials), derived_credentials,
+                                       account_cache)) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
+  network_client_ = MakeNetworkClient(*account_handler_.account_);
+  MigrateLegacyIcons();
+  InitialiseAppHandler();
+  LaunchAutoStartApps();
+  Post(executor_->blocking_service(), [this] {
+    try {
+      EnsureReconciled();
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to reconcile cached account: " << boost::diagnostic_information(e);
+    }
+  }, nullptr, &lifetime_guard_);
 }
 
 Launcher::Launcher(Keyword keyword, Pin pin, Password password,
-                   passport::MaidAndSigner&& maid_and_signer)
-    : asio_service_(1),
+                   passport::MaidAndSigner&& maid_and_signer,
+                   const CancellationToken& cancellation_token,
+                   std::shared_ptr<Executor> executor)
+    : executor_(std::move(executor)),
+      lifetime_guard_(),
 #ifdef ROUTING_AND_NFS_UPDATED
 #ifdef USE_FAKE_STORE
       network_client_(std::make_shared<NetworkClient>(FakeStorePath(), FakeStoreDiskUsage())),
@@ -113,27 +283,132 @@ Launcher::Launcher(Keyword keyword, Pin pin, Password password,
           MemoryUsage(1 << 7), Launcher::FakeStoreDiskUsage(), nullptr, Launcher::FakeStorePath())),
 #endif
       account_handler_(Account{std::move(maid_and_signer)},
-                       ConvertToCredentials(keyword, pin, password), *network_client_),
+                       ConvertToCredentials(keyword, pin, password), *network_client_,
+                       cancellation_token),
       account_mutex_(),
       app_handler_(),
-      rollback_snapshot_() {
-  app_handler_.Initialise(GetConfigFilePath(), account_handler_.account_.get(), &account_mutex_);
+      rollback_mutex_(),
+      rollback_snapshot_(),
+      reconcile_mutex_(),
+      needs_reconcile_(false),
+      reconcile_cancellation_(),
+      save_scheduler_(executor_->blocking_service(),
+                      lifetime_guard_.Wrap([this] { SaveSession(false); })),
+      icon_cache_mutex_(),
+      icon_cache_(),
+      launch_listener_strand_(executor_->service()),
+      launch_stats_(),
+      launches_mutex_(),
+      launch_listener_(),
+      pending_launches_(),
+      process_supervisor_(executor_->service()),
+      auto_start_scheduler_(
+          executor_->service(),
+          lifetime_guard_.Wrap([this](const AppDetails& app, std::function<void()> on_finished) {
+            LaunchApp(app.name, app.path, app.args, std::move(on_finished));
+          })) {
+  InitialiseAppHandler();
+  UpdateAccountCache();
 }
 
-std::unique_ptr<Launcher> Launcher::Login(Keyword keyword, Pin pin, Password password) {
-  std::unique_ptr<AccountGetter> account_getter{AccountGetter::CreateAccountGetter().get()};
+Launcher::~Launcher() {
+  // Stop starting new work, then wait for any handlers referring to this instance to finish before
+  // any members are destroyed.  Handlers still queued on the executor will do nothing.
+  reconcile_cancellation_.Cancel();
+  auto_start_scheduler_.Cancel();
+  {
+    std::lock_guard<std::mutex> lock{launches_mutex_};
+    if (launch_listener_)
+      launch_listener_->StopListening();
+  }
+  lifetime_guard_.Close();
+}
+
+std::unique_ptr<Launcher> Launcher::Login(Keyword keyword, Pin pin, Password password,
+                                          const CancellationToken& cancellation_token) {
+  Profiler::Scope scope{"launcher", "Login"};
+  // Start joining the network on a worker thread (unless already joined by a previous attempt or by
+  // 'PrepareForLogin'), and meanwhile derive the account location and secure password on this one,
+  // so that login takes roughly the longer of these rather than both.
+  AccountGetter::PrewarmShared();
+  auto user_credentials(ConvertToCredentials(keyword, pin, password));
+  DerivedCredentials derived_credentials{DeriveCredentials(user_credentials)};
+  cancellation_token.ThrowIfCancelled();
+  if (AccountCacheEnabled()) {
+    // The shared AccountGetter carries on joining the network for the background reconcile.
+    try {
+      std::unique_ptr<Launcher> launcher(
+          new Launcher{std::move(user_credentials), derived_credentials,
+                       AccountCache{GetAccountCacheDir()}, Executor::Shared()});
+      return std::move(launcher);
+    } catch (const std::exception& e) {
+      LOG(kInfo) << "Not logging in from account cache: " << boost::diagnostic_information(e);
+      user_credentials = ConvertToCredentials(keyword, pin, password);
+    }
+  }
+  std::shared_ptr<AccountGetter> account_getter;
+  {
+    Profiler::Scope join_scope{"network", "JoinNetwork"};
+    account_getter = AccountGetter::GetShared(cancellation_token);
+  }
   // Can't use make_unique since Launcher's c'tor is private.
-  return std::move(
-      std::unique_ptr<Launcher>(new Launcher{keyword, pin, password, *account_getter}));
+  std::unique_ptr<Launcher> launcher(new Launcher{std::move(user_credentials), derived_credentials,
+                                                  *account_getter, cancellation_token,
+                                                  Executor::Shared()});
+  // The connection is no longer required once logged in.
+  AccountGetter::ReleaseShared();
+  return std::move(launcher);
+}
+
+std::future<std::unique_ptr<Launcher>> Launcher::LoginAsync(
+    Keyword keyword, Pin pin, Password password, std::function<void()> on_ready,
+    CancellationToken cancellation_token) {
+  return Post(Executor::Shared()->blocking_service(),
+              [=] { return Login(keyword, pin, password, cancellation_token); },
+              std::move(on_ready));
 }
 
-std::unique_ptr<Launcher> Launcher::CreateAccount(Keyword keyword, Pin pin, Password password) {
+void Launcher::EnableAccountCache(bool enable) { AccountCacheEnabled() = enable; }
+
+void Launcher::EnableProfiling(bool enable) { Profiler::Enable(enable); }
+
+void Launcher::WriteProfile(const boost::filesystem::path& path) {
+  Profiler::WriteChromeTrace(path);
+}
+
+void Launcher::SetAutoStartOptions(AutoStartOptions options) {
+  std::lock_guard<std::mutex> lock{AutoStartOptionsMutex()};
+  GetAutoStartOptions() = std::move(options);
+}
+
+void Launcher::PrepareForLogin() { AccountGetter::PrewarmShared(); }
+
+void Launcher::CancelPrepareForLogin() { AccountGetter::CancelShared(); }
+
+std::unique_ptr<Launcher> Launcher::CreateAccount(Keyword keyword, Pin pin, Password password,
+                                                  const CancellationToken& cancellation_token) {
+  Profiler::Scope scope{"launcher", "CreateAccount"};
+  cancellation_token.ThrowIfCancelled();
+  auto maid_and_signer([] {
+    Profiler::Scope keys_scope{"crypto", "CreateMaidAndSigner"};
+    return passport::CreateMaidAndSigner();
+  }());
+  cancellation_token.ThrowIfCancelled();
   // Can't use make_unique since Launcher's c'tor is private.
   return std::move(std::unique_ptr<Launcher>(
-      new Launcher{keyword, pin, password, passport::CreateMaidAndSigner()}));
+      new Launcher{keyword, pin, password, std::move(maid_and_signer), cancellation_token,
+                   Executor::Shared()}));
   // TODO(Fraser#5#): 2015-01-16 - create safe drive folder
 }
 
+std::future<std::unique_ptr<Launcher>> Launcher::CreateAccountAsync(
+    Keyword keyword, Pin pin, Password password, std::function<void()> on_ready,
+    CancellationToken cancellation_token) {
+  return Post(Executor::Shared()->blocking_service(),
+              [=] { return CreateAccount(keyword, pin, password, cancellation_token); },
+              std::move(on_ready));
+}
+
 #ifdef USE_FAKE_STORE
 
 boost::filesystem::path Launcher::FakeStorePath(const boost::filesystem::path* const disk_path) {
@@ -165,12 +440,111 @@ DiskUsage Launcher::FakeStoreDiskUsage(const DiskUsage* const disk_usage) {
 #endif
 
 void Launcher::LogoutAndStop() {
-  SaveSession(true);
+  if (needs_reconcile_) {
+    // Saving would first have to join the network to reconcile, which could block for up to the
+    // join timeout.
+    {
+      std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
+      if (rollback_snapshot_) {
+        LOG(kError) << "Can't save unsaved changes before the cached account is reconciled.";
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+      }
+    }
+    // Nothing needs saving, so stop any reconcile still waiting for the network.
+    reconcile_cancellation_.Cancel();
+  } else {
+    SaveSession(true);
+  }
 #ifndef USE_FAKE_STORE
   network_client_->Stop();
 #endif
 }
 
+std::set<AppDetails> Launcher::GetApps(bool locally_available) const {
+  return app_handler_.GetApps(locally_available);
+}
+
+std::map<AppName, SerialisedData> Launcher::GetAppIcons(const std::set<AppName>& app_names) {
+  const std::map<AppName, Identity> icon_ids{GetIconIds(app_names)};
+  // Uncached icons are retrieved on this thread rather than posted to the executor, since blocking
+  // on those here would starve or deadlock the executor if this were one of its threads.
+  for (const auto& icon_id : icon_ids) {
+    if (icon_id.second.IsInitialised() && !IsIconCached(icon_id.second))
+      RetrieveIcon(icon_id.second);
+  }
+  return GetCachedIcons(icon_ids);
+}
+
+std::future<std::map<AppName, SerialisedData>> Launcher::GetAppIconsAsync(
+    const std::set<AppName>& app_names, std::function<void()> on_ready) {
+  // Shared by the retrieval tasks; the last one to finish fulfils the promise.  If this instance is
+  // destroyed first, the remaining tasks don't run and the promise is broken.
+  struct Retrieval {
+    std::mutex mutex;
+    std::map<AppName, Identity> icon_ids;
+    std::size_t remaining;
+    std::exception_ptr error;
+    std::promise<std::map<AppName, SerialisedData>> promise;
+    std::function<void()> on_ready;
+  };
+  auto retrieval(std::make_shared<Retrieval>());
+  retrieval->remaining = 0;
+  retrieval->on_ready = std::move(on_ready);
+  auto future(retrieval->promise.get_future());
+
+  auto finish([this, retrieval] {
+    if (retrieval->error) {
+      retrieval->promise.set_exception(retrieval->error);
+    } else {
+      try {
+        retrieval->promise.set_value(GetCachedIcons(retrieval->icon_ids));
+      } catch (const std::exception&) {
+        retrieval->promise.set_exception(std::current_exception());
+      }
+    }
+    if (retrieval->on_ready)
+      retrieval->on_ready();
+  });
+
+  executor_->service().post(lifetime_guard_.Wrap([this, app_names, retrieval, finish] {
+    std::set<Identity> uncached_icon_ids;
+    try {
+      retrieval->icon_ids = GetIconIds(app_names);
+      for (const auto& icon_id : retrieval->icon_ids) {
+        if (icon_id.second.IsInitialised() && !IsIconCached(icon_id.second))
+          uncached_icon_ids.insert(icon_id.second);
+      }
+    } catch (const std::exception&) {
+      retrieval->error = std::current_exception();
+    }
+    if (uncached_icon_ids.empty()) {
+      finish();
+      return;
+    }
+
+    retrieval->remaining = uncached_icon_ids.size();
+    for (const auto& icon_id : uncached_icon_ids) {
+      executor_->blocking_service().post(lifetime_guard_.Wrap([this, icon_id, retrieval, finish] {
+        std::exception_ptr error;
+        try {
+          RetrieveIcon(icon_id);
+        } catch (const std::exception&) {
+          error = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> lock{retrieval->mutex};
+          if (error && !retrieval->error)
+            retrieval->error = error;
+          if (--retrieval->remaining != 0)
+            return;
+        }
+        finish();
+      }));
+    }
+  }));
+  return future;
+}
+
 void Launcher::AddApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
                       SerialisedData app_icon, bool auto_start) {
   AddOrLinkApp(std::move(app_name), std::move(app_path), std::move(app_args), &app_icon,
@@ -184,6 +558,9 @@ void Launcher::LinkApp(AppName app_name, boost::filesystem::path app_path, AppAr
 
 void Launcher::AddOrLinkApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
                             const SerialisedData* const app_icon, bool auto_start) {
+  if (app_icon && !app_icon->empty())
+    StoreIcon(*app_icon);
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   auto snapshot(app_handler_.GetSnapshot());
   on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
   AppDetails app{app_handler_.AddOrLinkApp(std::move(app_name), std::move(app_path),
@@ -191,17 +568,16 @@ void Launcher::AddOrLinkApp(AppName app_name, boost::filesystem::path app_path,
   if (app_icon) {  // we're adding the app
                    // TODO(Fraser#5#): 2015-01-23 - Add the app.dir to network_client_
   }
-  if (!rollback_snapshot_)
-    rollback_snapshot_ = snapshot;
+  MarkUnsaved(snapshot);
   strong_guarantee.Release();
 }
 
 void Launcher::UpdateAppName(const AppName& app_name, const AppName& new_name) {
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   auto snapshot(app_handler_.GetSnapshot());
   on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
   app_handler_.UpdateName(app_name, new_name);
-  if (!rollback_snapshot_)
-    rollback_snapshot_ = snapshot;
+  MarkUnsaved(snapshot);
   strong_guarantee.Release();
 }
 
@@ -223,28 +599,22 @@ void Launcher::UpdateAppArgs(const AppName& app_name, const AppArgs& new_args) {
 
 void Launcher::UpdateAppSafeDriveAccess(const AppName& app_name,
                                         DirectoryInfo::AccessRights new_rights) {
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   auto snapshot(app_handler_.GetSnapshot());
   on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
-  // TODO(Fraser#5#): 2015-01-20 - Replace "SafeDrive" string with constant defined... where?
-  DirectoryInfo safe_dir("SafeDrive", Identity{}, Identity{}, new_rights);
-  {
-    std::lock_guard<std::mutex> lock{account_mutex_};
-    // TODO(Fraser#5#): 2015-01-20 - Confirm with Lee if these IDs should be used.
-    safe_dir.parent_id = Identity{account_handler_.account_->unique_user_id};
-    safe_dir.directory_id = account_handler_.account_->root_parent_id;
-  }
-  app_handler_.UpdatePermittedDirs(app_name, safe_dir);
-  if (!rollback_snapshot_)
-    rollback_snapshot_ = snapshot;
+  app_handler_.UpdatePermittedDirs(app_name, GetSafeDriveDir(new_rights));
+  MarkUnsaved(snapshot);
   strong_guarantee.Release();
 }
 
 void Launcher::UpdateAppIcon(const AppName& app_name, const SerialisedData& new_icon) {
+  if (!new_icon.empty())
+    StoreIcon(new_icon);
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   auto snapshot(app_handler_.GetSnapshot());
   on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
   app_handler_.UpdateIcon(app_name, new_icon);
-  if (!rollback_snapshot_)
-    rollback_snapshot_ = snapshot;
+  MarkUnsaved(snapshot);
   strong_guarantee.Release();
 }
 
@@ -266,58 +636,243 @@ void Launcher::RemoveAppLocally(const AppName& app_name) {
 }
 
 void Launcher::RemoveAppFromNetwork(const AppName& app_name) {
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   auto snapshot(app_handler_.GetSnapshot());
   on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
   app_handler_.RemoveFromNetwork(app_name);
-  if (!rollback_snapshot_)
-    rollback_snapshot_ = snapshot;
+  MarkUnsaved(snapshot);
   strong_guarantee.Release();
 }
 
+void Launcher::ApplyChanges(const std::vector<AppChange>& changes) {
+  bool affects_account(false);
+  for (const auto& change : changes) {
+    const bool has_icon{change.type == AppChange::Type::kAddApp ||
+                        change.type == AppChange::Type::kUpdateAppIcon};
+    if (has_icon && !change.icon.empty())
+      StoreIcon(change.icon);
+    affects_account |= change.AffectsAccount();
+  }
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
+  auto snapshot(app_handler_.GetSnapshot());
+  on_scope_exit strong_guarantee{[&] { RevertAppHandler(std::move(snapshot)); }};
+  app_handler_.BeginBatch();
+  {
+    on_scope_exit abandon_batch{[&] { app_handler_.EndBatch(false); }};
+    for (const auto& change : changes)
+      ApplyChange(change);
+    abandon_batch.Release();
+  }
+  app_handler_.EndBatch(true);
+  if (affects_account)
+    MarkUnsaved(snapshot);
+  strong_guarantee.Release();
+}
+
+void Launcher::ApplyChange(const AppChange& change) {
+  switch (change.type) {
+    case AppChange::Type::kAddApp:
+      app_handler_.AddOrLinkApp(change.app_name, change.path, change.args, &change.icon,
+                                change.auto_start);
+      break;
+    case AppChange::Type::kLinkApp:
+      app_handler_.AddOrLinkApp(change.app_name, change.path, change.args, nullptr,
+                                change.auto_start);
+      break;
+    case AppChange::Type::kUpdateAppName:
+      app_handler_.UpdateName(change.app_name, change.new_name);
+      break;
+    case AppChange::Type::kUpdateAppPath:
+      app_handler_.UpdatePath(change.app_name, change.path);
+      break;
+    case AppChange::Type::kUpdateAppArgs:
+      app_handler_.UpdateArgs(change.app_name, change.args);
+      break;
+    case AppChange::Type::kUpdateAppSafeDriveAccess:
+      app_handler_.UpdatePermittedDirs(change.app_name, GetSafeDriveDir(change.access_rights));
+      break;
+    case AppChange::Type::kUpdateAppIcon:
+      app_handler_.UpdateIcon(change.app_name, change.icon);
+      break;
+    case AppChange::Type::kUpdateAppAutoStart:
+      app_handler_.UpdateAutoStart(change.app_name, change.auto_start);
+      break;
+    case AppChange::Type::kRemoveAppLocally:
+      app_handler_.RemoveLocally(change.app_name);
+      break;
+    case AppChange::Type::kRemoveAppFromNetwork:
+      app_handler_.RemoveFromNetwork(change.app_name);
+      break;
+    default:
+      LOG(kError) << "Invalid AppChange type.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+}
+
+DirectoryInfo Launcher::GetSafeDriveDir(DirectoryInfo::AccessRights access_rights) const {
+  // TODO(Fraser#5#): 2015-01-20 - Replace "SafeDrive" string with constant defined... where?
+  DirectoryInfo safe_dir("SafeDrive", Identity{}, Identity{}, access_rights);
+  std::lock_guard<std::mutex> lock{account_mutex_};
+  // TODO(Fraser#5#): 2015-01-20 - Confirm with Lee if these IDs should be used.
+  safe_dir.parent_id = Identity{account_handler_.account_->unique_user_id};
+  safe_dir.directory_id = account_handler_.account_->root_parent_id;
+  return safe_dir;
+}
+
 void Launcher::LaunchApp(const AppName& app_name) {
   auto path_and_args(app_handler_.GetPathAndArgs(app_name));
   LaunchApp(app_name, path_and_args.first, std::move(path_and_args.second));
 }
 
-void Launcher::LaunchApp(const AppName& app_name, const boost::filesystem::path& /*path*/,
-                         AppArgs args) {
+void Launcher::LaunchAutoStartApps() {
+  AutoStartOptions options;
+  {
+    std::lock_guard<std::mutex> lock{AutoStartOptionsMutex()};
+    options = GetAutoStartOptions();
+  }
+  auto_start_scheduler_.Start(app_handler_.GetAutoStartApps(), options);
+}
+
+std::future<void> Launcher::LaunchAppAsync(const AppName& app_name,
+                                           std::function<void()> on_ready) {
+  return Post(executor_->service(), [=] { LaunchApp(app_name); }, std::move(on_ready),
+              &lifetime_guard_);
+}
+
+void Launcher::LaunchApp(const AppName& app_name, const boost::filesystem::path& path,
+                         AppArgs args, std::function<void()> on_finished) {
   // Set up struct to hold launch information
-  auto launch(std::make_shared<Launch>(app_name, asio_service_, connect_timeout_));
+  auto launch(std::make_shared<Launch>(app_name, executor_->service(), connect_timeout_));
+  launch->token = RandomAlphaNumericString(32);
+  launch->on_finished = std::move(on_finished);
 
-  // Start listening
-  launch->listener = tcp::Listener::MakeShared(launch->strand, [=](tcp::ConnectionPtr connection) {
-    HandleNewConnection(launch, connection);
-  }, static_cast<tcp::Port>((RandomUint32() % 64512) + 1024));
+  // Start listening if this is the first launch, and register this launch with the listener.  The
+  // listener binds port 0 so that the OS picks a free port, which is then read back.
+  tcp::Port port{0};
+  {
+    std::lock_guard<std::mutex> lock{launches_mutex_};
+    if (!launch_listener_) {
+      launch_listener_ = tcp::Listener::MakeShared(
+          launch_listener_strand_,
+          lifetime_guard_.Wrap(
+              [this](tcp::ConnectionPtr connection) { HandleIncomingConnection(connection); }),
+          tcp::Port{0});
+    }
+    port = launch_listener_->ListeningPort();
+    pending_launches_.emplace(launch->token, launch);
+  }
 
   // Set the steady_timer's timeout handler
-  launch->timer.async_wait([=](const asio::error_code& error) {
+  launch->timer.async_wait(lifetime_guard_.Wrap([=](const asio::error_code& error) {
     if (!error || error != asio::error::operation_aborted) {
       LOG(kWarning) << "Error waiting for " << launch->name << " to connect: " << error.message();
-      asio::dispatch(launch->strand, [=] { HandleNewConnection(launch, nullptr); });
+      asio::dispatch(launch->strand, lifetime_guard_.Wrap([=] {
+        FinishLaunchTrace(*launch, error ? LaunchTrace::Outcome::kFailed
+                                         : LaunchTrace::Outcome::kTimedOut);
+        HandleNewConnection(launch, nullptr);
+      }));
     }
-  });
+  }));
+
+  args += (" --launcher_port=" + std::to_string(port) + " --launcher_token=" + launch->token);
+  BeginLaunchPhase(*launch, LaunchPhase::kSpawn);
+  try {
+    launch->process_id = process_supervisor_.Spawn(
+        app_name, path, args,
+        lifetime_guard_.Wrap([=](ProcessSupervisor::ProcessId, int exit_code) {
+          asio::dispatch(launch->strand, lifetime_guard_.Wrap([=] {
+            if (launch->connection)
+              return;
+            LOG(kWarning) << launch->name << " exited with code " << exit_code
+                          << " before connecting.";
+            FinishLaunchTrace(*launch, LaunchTrace::Outcome::kFailed);
+            HandleNewConnection(launch, nullptr);
+            launch->timer.cancel();
+          }));
+        }));
+  } catch (const std::exception&) {
+    ClaimLaunch(launch->token);
+    launch->on_finished = nullptr;
+    launch->timer.cancel();
+    FinishLaunchTrace(*launch, LaunchTrace::Outcome::kFailed);
+    throw;
+  }
+  BeginLaunchPhase(*launch, LaunchPhase::kConnect);
+}
+
+void Launcher::FinishLaunch(const std::shared_ptr<Launch>& launch) {
+  assert(launch->strand.running_in_this_thread());
+  std::function<void()> on_finished;
+  std::swap(on_finished, launch->on_finished);
+  if (on_finished)
+    on_finished();
+}
 
-  tcp::Port port(launch->listener->ListeningPort());
-  args += (" --launcher_port=" + std::to_string(port));
-  // TODO(Fraser#5#): 2015-01-29 - start process
+void Launcher::BeginLaunchPhase(Launch& launch, LaunchPhase phase) {
+  std::lock_guard<std::mutex> lock{launch.trace_mutex};
+  launch.trace.BeginPhase(phase);
+}
+
+void Launcher::FinishLaunchTrace(Launch& launch, LaunchTrace::Outcome outcome) {
+  std::unique_lock<std::mutex> lock{launch.trace_mutex};
+  if (!launch.trace.Finish(outcome))
+    return;
+  LaunchTrace trace(launch.trace);
+  lock.unlock();
+  launch_stats_.Record(std::move(trace));
+}
+
+bool Launcher::IsRunning(const AppName& app_name) const {
+  return process_supervisor_.IsRunning(app_name);
+}
+
+std::map<AppName, LaunchStats::AppStats> Launcher::GetLaunchStats() const {
+  return launch_stats_.GetAppStats();
+}
+
+std::vector<LaunchTrace> Launcher::GetRecentLaunchTraces() const {
+  return launch_stats_.GetRecentTraces();
+}
+
+void Launcher::WriteLaunchStats(const boost::filesystem::path& path) const {
+  launch_stats_.WriteToFile(path);
 }
 
 void Launcher::SaveSession(bool force) {
-  std::lock_guard<std::mutex> lock{account_mutex_};
+  // Saving a stale account would fork the account's versions.
+  EnsureReconciled();
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   if (!force && !rollback_snapshot_)
     return;
+  std::lock_guard<std::mutex> lock{account_mutex_};
   account_handler_.Save(*network_client_);
   rollback_snapshot_ = boost::none;
+  save_scheduler_.MarkSaved();
+  UpdateAccountCache();
+}
+
+std::future<void> Launcher::SaveSessionAsync(bool force, std::function<void()> on_ready) {
+  return Post(executor_->blocking_service(), [=] { SaveSession(force); }, std::move(on_ready),
+              &lifetime_guard_);
 }
 
 void Launcher::RevertToLastSavedSession() {
-  std::lock_guard<std::mutex> lock{account_mutex_};
+  // 'account_mutex_' mustn't be held here, since 'app_handler_' locks it to apply the snapshot.
+  std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
   if (!rollback_snapshot_)
     return;
   RevertAppHandler(*rollback_snapshot_);
   rollback_snapshot_ = boost::none;
+  save_scheduler_.MarkSaved();
 }
 
+void Launcher::SetAutosave(std::chrono::steady_clock::duration delay,
+                           std::chrono::steady_clock::duration max_delay) {
+  save_scheduler_.SetDelay(delay, max_delay);
+}
+
+Launcher::SaveState Launcher::GetSaveState() const { return save_scheduler_.GetState(); }
+
 void Launcher::RevertAppHandler(AppHandler::Snapshot snapshot) {
   try {
     app_handler_.ApplySnapshot(std::move(snapshot));
@@ -327,42 +882,254 @@ void Launcher::RevertAppHandler(AppHandler::Snapshot snapshot) {
   }
 }
 
+void Launcher::MarkUnsaved(const AppHandler::Snapshot& snapshot) {
+  if (!rollback_snapshot_)
+    rollback_snapshot_ = snapshot;
+  save_scheduler_.MarkDirty();
+}
+
+void Launcher::StoreIcon(const SerialisedData& icon) {
+  ImmutableData icon_chunk{MakeIconChunk(icon, GetIconKey())};
+  {
+    std::lock_guard<std::mutex> lock{icon_cache_mutex_};
+    if (icon_cache_.count(icon_chunk.Name()) != 0)
+      return;
+  }
+  try {
+    network_client_->Store(icon_chunk.NameAndType(), NonEmptyString(Serialise(icon_chunk)));
+  } catch (const maidsafe_error& error) {
+    // Icons are content-addressed, so an earlier session may have already stored it.
+    if (error.code() != make_error_code(VaultErrors::data_already_exists))
+      throw;
+  }
+  std::lock_guard<std::mutex> lock{icon_cache_mutex_};
+  icon_cache_.emplace(icon_chunk.Name(), icon);
+}
+
+void Launcher::MigrateLegacyIcons() {
+  Account& account{*account_handler_.account_};
+  std::vector<AppName> migrated_apps;
+  for (const auto& app : account.apps) {
+    if (!app.icon.empty()) {
+      StoreIcon(app.icon);
+      migrated_apps.push_back(app.name);
+    }
+  }
+  for (const auto& app_name : migrated_apps)
+    account.apps.Modify(app_name, [](AppDetails& app) { app.icon.clear(); });
+}
+
+crypto::AES256KeyAndIV Launcher::GetIconKey() const {
+  std::lock_guard<std::mutex> lock{account_mutex_};
+  return account_handler_.account_->config_file_aes_key_and_iv;
+}
+
+std::map<AppName, Identity> Launcher::GetIconIds(const std::set<AppName>& app_names) const {
+  std::map<AppName, Identity> icon_ids;
+  for (bool locally_available : {true, false}) {
+    for (const auto& app : app_handler_.GetApps(locally_available)) {
+      if (app_names.count(app.name) != 0)
+        icon_ids.emplace(app.name, app.icon_id);
+    }
+  }
+  if (icon_ids.size() != app_names.size()) {
+    LOG(kError) << "Not all requested apps exist.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+  }
+  return icon_ids;
+}
+
+bool Launcher::IsIconCached(const Identity& icon_id) {
+  std::lock_guard<std::mutex> lock{icon_cache_mutex_};
+  return icon_cache_.count(icon_id) != 0;
+}
+
+void Launcher::RetrieveIcon(const Identity& icon_id) {
+  ImmutableData icon_chunk(Parse<ImmutableData>(
+      network_client_->Get(Data::NameAndTypeId(icon_id, DataTypeId(0))).string()));
+  SerialisedData icon(ParseIconChunk(icon_chunk, GetIconKey()));
+  std::lock_guard<std::mutex> lock{icon_cache_mutex_};
+  icon_cache_.emplace(icon_id, std::move(icon));
+}
+
+std::map<AppName, SerialisedData> Launcher::GetCachedIcons(
+    const std::map<AppName, Identity>& icon_ids) {
+  std::map<AppName, SerialisedData> icons;
+  std::lock_guard<std::mutex> lock{icon_cache_mutex_};
+  for (const auto& icon_id : icon_ids) {
+    if (icon_id.second.IsInitialised())
+      icons.emplace(icon_id.first, icon_cache_.at(icon_id.second));
+  }
+  return icons;
+}
+
+void Launcher::HandleIncomingConnection(tcp::ConnectionPtr connection) {
+  // Until the token arrives, the connection belongs to no launch.  Once it does, 'launch' is set
+  // (on 'launch_listener_strand_') and all further messages are passed to that launch's strand.
+  auto launch(std::make_shared<std::shared_ptr<Launch>>());
+  auto token_timer(std::make_shared<asio::steady_timer>(executor_->service(),
+                                                          handshake_timeout_));
+  token_timer->async_wait(
+      launch_listener_strand_.wrap(lifetime_guard_.Wrap([=](const asio::error_code& error) {
+        if (error != asio::error::operation_aborted && !*launch) {
+          LOG(kWarning) << "Timed out waiting for launch token.";
+          connection->Close();
+        }
+      })));
+
+  connection->Start(launch_listener_strand_.wrap(lifetime_guard_.Wrap([=](tcp::Message message) {
+    if (*launch) {
+      const std::shared_ptr<Launch> claimed_launch(*launch);
+      asio::dispatch(claimed_launch->strand, lifetime_guard_.Wrap([=]() mutable {
+        HandleMessage(claimed_launch, std::move(message));
+      }));
+      return;
+    }
+    token_timer->cancel();
+    *launch = ClaimLaunch(std::string(message.begin(), message.end()));
+    if (!*launch) {
+      LOG(kWarning) << "Received connection with unknown or expired launch token.";
+      return connection->Close();
+    }
+    const std::shared_ptr<Launch> claimed_launch(*launch);
+    asio::dispatch(claimed_launch->strand,
+                   lifetime_guard_.Wrap([=] { HandleNewConnection(claimed_launch, connection); }));
+  })), launch_listener_strand_.wrap(lifetime_guard_.Wrap([=] {
+    token_timer->cancel();
+    if (!*launch)
+      return;
+    const std::shared_ptr<Launch> claimed_launch(*launch);
+    asio::dispatch(claimed_launch->strand, lifetime_guard_.Wrap([=] {
+      claimed_launch->timer.cancel();
+      if (claimed_launch->handshake)
+        claimed_launch->handshake->OnConnectionClosed();
+      FinishLaunchTrace(*claimed_launch, LaunchTrace::Outcome::kFailed);
+      FinishLaunch(claimed_launch);
+    }));
+  })));
+}
+
+std::shared_ptr<Launch> Launcher::ClaimLaunch(const std::string& token) {
+  std::lock_guard<std::mutex> lock{launches_mutex_};
+  auto itr(pending_launches_.find(token));
+  if (itr == pending_launches_.end())
+    return nullptr;
+  std::shared_ptr<Launch> launch(std::move(itr->second));
+  pending_launches_.erase(itr);
+  return launch;
+}
+
 void Launcher::HandleNewConnection(std::shared_ptr<Launch> launch, tcp::ConnectionPtr connection) {
   assert(launch->strand.running_in_this_thread());
 
-  launch->listener->StopListening();
-  launch->listener.reset();
-
-  if (!connection)  // We've timed out or run into some other error.
+  if (!connection) {  // We've timed out or run into some other error.
+    ClaimLaunch(launch->token);
+    FinishLaunch(launch);
     return;
+  }
 
-  // Try to reset the timer's timeout deadline
+  // Stop the connect timeout.  If it has already expired, the launch has failed.
   asio::error_code error;
-  if (launch->timer.expires_from_now(handshake_timeout_, error) <= 0 || error)  // Failed to cancel
+  if (launch->timer.cancel(error) == 0 || error) {
+    connection->Close();
     return;
-
-  launch->timer.async_wait([=](const asio::error_code& error) {
-    if (!error || error != asio::error::operation_aborted) {
-      LOG(kWarning) << "Error waiting for " << launch->name << " to handshake: " << error.message();
-      asio::dispatch(launch->strand, [=] { connection->Close(); });
-    }
-  });
+  }
 
   launch->connection = connection;
-  connection->Start([=](tcp::Message message) { HandleMessage(launch, std::move(message)); },
-                    [=] { launch->timer.cancel(); });
+  BeginLaunchPhase(*launch, LaunchPhase::kSessionKey);
+  const AppName app_name(launch->name);
+  // The handshake is owned by the launch, so only holds a weak pointer to it here.
+  const std::weak_ptr<Launch> weak_launch(launch);
+  launch->handshake = std::make_shared<AppHandshake>(
+      launch->strand, connection, handshake_timeout_,
+      // Only called from 'OnMessage', which is only called from guarded handlers.
+      [this, app_name, weak_launch] {
+        if (auto locked_launch = weak_launch.lock())
+          BeginLaunchPhase(*locked_launch, LaunchPhase::kConfirmation);
+        return app_handler_.GetPermittedDirs(app_name);
+      },
+      lifetime_guard_.Wrap([=](bool succeeded) {
+        if (succeeded) {
+          LOG(kInfo) << launch->name << " completed its handshake.";
+          // The handshake has already closed the connection, so the app is orphaned and the launch
+          // ends with its confirmation.
+          FinishLaunchTrace(*launch, LaunchTrace::Outcome::kSucceeded);
+          FinishLaunch(launch);
+        } else {
+          LOG(kWarning) << launch->name << " failed to complete its handshake.";
+          FinishLaunchTrace(*launch, launch->handshake->TimedOut()
+                                         ? LaunchTrace::Outcome::kTimedOut
+                                         : LaunchTrace::Outcome::kFailed);
+          FinishLaunch(launch);
+        }
+      }));
+  launch->handshake->Start();
+}
 
+void Launcher::HandleMessage(std::shared_ptr<Launch> launch, tcp::Message message) {
+  assert(launch->strand.running_in_this_thread());
+  if (launch->handshake)
+    launch->handshake->OnMessage(std::move(message));
+}
 
+void Launcher::EnsureReconciled() {
+  std::lock_guard<std::mutex> reconcile_lock{reconcile_mutex_};
+  if (!needs_reconcile_)
+    return;
+  {
+    std::shared_ptr<AccountGetter> account_getter{
+        AccountGetter::GetShared(reconcile_cancellation_)};
+    on_scope_exit release_account_getter{[] { AccountGetter::ReleaseShared(); }};
+    if (account_handler_.RetrieveLatest(*account_getter, reconcile_cancellation_)) {
+      std::lock_guard<std::mutex> rollback_lock{rollback_mutex_};
+      // Any unsaved changes were made to the stale copy of the account, so are discarded with it.
+      if (rollback_snapshot_) {
+        const std::set<AppName> discarded_apps(
+            app_handler_.ChangedAppsSince(*rollback_snapshot_));
+        std::string app_names;
+        for (const auto& app_name : discarded_apps)
+          app_names += (app_names.empty() ? "\"" : ", \"") + app_name + "\"";
+        LOG(kWarning) << "The account was updated elsewhere since it was cached, so unsaved changes"
+                      << " to " << discarded_apps.size() << " app(s) are discarded: " << app_names;
+      }
+      app_handler_.ReloadAccount([this] {
+        account_handler_.AdoptRetrieved();
+        rollback_snapshot_ = boost::none;
+      });
+      save_scheduler_.MarkSaved();
+    }
+  }
+  needs_reconcile_ = false;
+  std::lock_guard<std::mutex> lock{account_mutex_};
+  UpdateAccountCache();
+}
 
-  // receive the app's session key
-  // send it the directory list
-  // wait for connection to drop or timeout
-  // orphan child
+void Launcher::InitialiseAppHandler() {
+  Profiler::Scope scope{"launcher", "InitialiseAppHandler"};
+  boost::filesystem::path config_file_path;
+  std::unique_ptr<crypto::AES256KeyAndIV> config_file_key_and_iv;
+  {
+    std::lock_guard<std::mutex> lock{account_mutex_};
+    config_file_path = GetConfigFilePath(account_handler_.account_->unique_user_id);
+    config_file_key_and_iv = maidsafe::make_unique<crypto::AES256KeyAndIV>(
+        account_handler_.account_->config_file_aes_key_and_iv);
+  }
+  AdoptSharedConfigFile(config_file_path, *config_file_key_and_iv);
+  app_handler_.Initialise(config_file_path, account_handler_.account_.get(), &account_mutex_);
+  boost::system::error_code ignored;
+  const auto config_file_size(boost::filesystem::file_size(config_file_path, ignored));
+  if (!ignored)
+    scope.AddBytes(config_file_size);
 }
 
-void Launcher::HandleMessage(std::shared_ptr<Launch> launch, tcp::Message /*message*/) {
-  assert(launch->strand.running_in_this_thread());
-  static_cast<void>(launch);
+void Launcher::UpdateAccountCache() {
+  if (!AccountCacheEnabled())
+    return;
+  try {
+    account_handler_.StoreInCache(AccountCache{GetAccountCacheDir()});
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to update account cache: " << boost::diagnostic_information(e);
+  }
 }
 
 }  // namespace launcher
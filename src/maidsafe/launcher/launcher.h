@@ -19,24 +19,38 @@
 #ifndef MAIDSAFE_LAUNCHER_LAUNCHER_H_
 #define MAIDSAFE_LAUNCHER_LAUNCHER_H_
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
+#include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/optional.hpp"
 
 #include "maidsafe/directory_info.h"
-#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/launcher/account_handler.h"
+#include "maidsafe/launcher/app_change.h"
 #include "maidsafe/launcher/app_handler.h"
 #include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/auto_start_scheduler.h"
+#include "maidsafe/launcher/cancellation_token.h"
+#include "maidsafe/launcher/executor.h"
+#include "maidsafe/launcher/launch_trace.h"
+#include "maidsafe/launcher/process_supervisor.h"
+#include "maidsafe/launcher/save_scheduler.h"
 #include "maidsafe/launcher/types.h"
 
 namespace maidsafe {
@@ -61,22 +75,99 @@ class Launcher {
   Launcher(Launcher&&) = delete;
   Launcher& operator=(const Launcher&) = delete;
   Launcher& operator=(Launcher&&) = delete;
+  ~Launcher();
 
-  // Retrieves and decrypts account info and starts a new session by logging into the network.
-  static std::unique_ptr<Launcher> Login(Keyword keyword, Pin pin, Password password);
+  // Retrieves and decrypts account info and starts a new session by logging into the network.  The
+  // account location and secure password are derived from the credentials while the connection to
+  // the network is being established, so the account is decrypted as soon as it's retrieved.
+  //
+  // If 'cancellation_token' is cancelled, throws 'AsioErrors::operation_aborted' at the next check;
+  // these are made while waiting for the connection and between each phase.  Each phase is bounded
+  // (see 'AccountGetter::kJoinTimeout' and 'AccountHandler::kRetrievalTimeout') and throws
+  // 'AsioErrors::timed_out' if exceeded.
+  static std::unique_ptr<Launcher> Login(
+      Keyword keyword, Pin pin, Password password,
+      const CancellationToken& cancellation_token = CancellationToken());
+
+  // As above, but runs on a small process-wide pool of threads rather than blocking the caller.
+  // Errors are reported via the returned future.  If 'on_ready' is non-null, it is invoked on the
+  // worker thread once the future is ready, e.g. to notify a UI thread.  The other '...Async'
+  // functions below behave likewise.
+  static std::future<std::unique_ptr<Launcher>> LoginAsync(
+      Keyword keyword, Pin pin, Password password, std::function<void()> on_ready = nullptr,
+      CancellationToken cancellation_token = CancellationToken());
+
+  // Enables or disables the local account cache for subsequent 'Login' and 'CreateAccount' calls in
+  // this process.  It's disabled by default.  While enabled, a copy of the encrypted account is
+  // kept on disk and updated after each login and save.  'Login' then decrypts the cached copy and
+  // returns without waiting for the network, and the copy is reconciled with the network in the
+  // background.  If the network holds a newer version, it replaces the cached one, along with any
+  // changes made to the apps in the meantime.  'SaveSession' waits for reconciling to finish, and
+  // retries it if it failed.
+  static void EnableAccountCache(bool enable);
+
+  // Enables or disables profiling of subsequent 'Login' and 'CreateAccount' calls in this process.
+  // It's disabled by default.  While enabled, the wall time, CPU time and bytes moved of each of
+  // their phases (e.g. joining the network, retrieving and decrypting the account and initialising
+  // the local config) are recorded.  'WriteProfile' writes all phases recorded so far to 'path' in
+  // the Chrome trace event format, and throws on error.
+  static void EnableProfiling(bool enable);
+  static void WriteProfile(const boost::filesystem::path& path);
+
+  // The Launchers in this process, and the async functions above, all run on the shared executor,
+  // which can be configured via 'Executor::ConfigureShared' before the first of these is called.
+
+  // Sets how the auto-start apps are launched by subsequent 'Login' calls in this process.  'Login'
+  // returns without waiting for them, and they're launched in the background on the shared
+  // executor.
+  static void SetAutoStartOptions(AutoStartOptions options);
+
+  // Starts establishing the connection to the network used by 'Login' without blocking, e.g. at
+  // application startup.  The connection is kept alive and reused by subsequent 'Login' calls until
+  // one succeeds, so retrying after e.g. a mistyped password doesn't need to re-join the network.
+  static void PrepareForLogin();
+
+  // Aborts the connection started by 'PrepareForLogin' or 'Login' if it's still being established,
+  // e.g. on application shutdown, so that this doesn't block until the connection attempt ends.
+  static void CancelPrepareForLogin();
 
   // This function should be used when creating a new account, i.e. where an account has never
   // been put to the network.  Creates a new account, encrypts it and puts it to the network.
-  static std::unique_ptr<Launcher> CreateAccount(Keyword keyword, Pin pin, Password password);
+  // 'cancellation_token' is checked before and after generating the account's keys and before
+  // putting the account, as for 'Login'.  Once putting has started, it's allowed to complete.
+  static std::unique_ptr<Launcher> CreateAccount(
+      Keyword keyword, Pin pin, Password password,
+      const CancellationToken& cancellation_token = CancellationToken());
+
+  // As above, but runs on the same pool as 'LoginAsync'.
+  static std::future<std::unique_ptr<Launcher>> CreateAccountAsync(
+      Keyword keyword, Pin pin, Password password, std::function<void()> on_ready = nullptr,
+      CancellationToken cancellation_token = CancellationToken());
 
   // Saves session, and logs out of the network.  After calling, the class should be destructed as
-  // it is no longer connected to the network.
+  // it is no longer connected to the network.  If logged in from the account cache and not yet
+  // reconciled, doesn't wait for the network: the save is skipped if there are no unsaved changes,
+  // otherwise this throws at once and the changes remain unsaved, so that 'SaveSession' can be
+  // retried or the changes reverted.
   void LogoutAndStop();
 
   // Returns the set of apps which have been added; either the locally-available ones or the
   // non-locally-available ones depending on the value of 'locally_available'.
   std::set<AppDetails> GetApps(bool locally_available) const;
 
+  // Returns the icons of the apps indicated by 'app_names'.  Icons are held as separate encrypted
+  // chunks on the network and aren't retrieved when logging in, so any not already held are
+  // retrieved here, one at a time on the calling thread.  Apps with no icon are omitted from the
+  // result.  Throws if any app doesn't exist.
+  std::map<AppName, SerialisedData> GetAppIcons(const std::set<AppName>& app_names);
+
+  // As above, but retrieves the icons in parallel on this instance's threads rather than blocking
+  // the caller.  Errors are reported via the returned future.  'on_ready' (if non-null) is invoked
+  // on one of those threads once the future is ready.  If this instance is destroyed before the
+  // retrieval has finished, the future will hold a 'broken_promise' error.
+  std::future<std::map<AppName, SerialisedData>> GetAppIconsAsync(
+      const std::set<AppName>& app_names, std::function<void()> on_ready = nullptr);
+
   // Adds an instance of 'app_name' to the set of local apps.  Throws if the app has already been
   // added locally or non-locally.  (To add an app which has previously been added non-locally, use
   // the 'LinkApp' function.)
@@ -106,12 +197,33 @@ class Launcher {
   // apps.  Throws if the app isn't in the set.
   void RemoveAppFromNetwork(const AppName& app_name);
 
+  // Applies each of 'changes' in order, as if by calling the corresponding functions above, but
+  // only taking a single snapshot and writing the local config file once, e.g. when importing many
+  // apps.  If any change fails, none are applied.
+  void ApplyChanges(const std::vector<AppChange>& changes);
+
   // Save the account to the network.  If 'force' is false, the account is only saved if there are
   // unsaved changes in the account (e.g. if AddApp has been called).  If 'force' is true, the
   // account is saved unconditionally.  If the functions throws an exception indicating a temporary
   // problem, it is safe to retry SaveSession, otherwise the user probably needs to take action.
   void SaveSession(bool force = false);
 
+  // As above, but runs on this instance's threads rather than blocking the caller.  Errors are
+  // reported via the returned future.  If this instance is destroyed before the save has run, the
+  // future may hold a 'std::future_error' instead.
+  std::future<void> SaveSessionAsync(bool force = false, std::function<void()> on_ready = nullptr);
+
+  // Enables saving the session automatically on this instance's threads once the account has been
+  // left unchanged for 'delay', or at most 'max_delay' after the first unsaved change, so that a
+  // burst of changes costs a single save.  Failed saves are retried with increasing backoff while
+  // there are unsaved changes.  Autosaving is disabled by default, or if 'delay' is zero.
+  void SetAutosave(std::chrono::steady_clock::duration delay,
+                   std::chrono::steady_clock::duration max_delay);
+
+  // Returns whether there are unsaved changes to the account, and whether they're being saved.
+  using SaveState = SaveScheduler::State;
+  SaveState GetSaveState() const;
+
   // Reverts the internal state back to the last successful 'SaveSession' call, or the initial state
   // if there have been no 'SaveSession' calls.
   void RevertToLastSavedSession();
@@ -119,22 +231,45 @@ class Launcher {
   // Launches a new instance of the app indicated by 'app_name' as a detached child.
   //
   // The app will be passed the Launcher's TCP listening port in a command line argument
-  // "--launcher_port=X" where X will be a random port between 1025 and 65535 inclusive.  The app
-  // must then establish a TCP connection to the launcher on the loopback address at this port
-  // within the 'connect_timeout_' duration or the launch attempt fails.
+  // "--launcher_port=X" and a token unique to this launch in "--launcher_token=T".  The port is
+  // chosen by the OS when the first app is launched, and is shared by all launches.  The app must
+  // then establish a TCP connection to the launcher on the loopback address at this port and send
+  // the token as its first message within the 'connect_timeout_' duration or the launch attempt
+  // fails.
   //
-  // Once the connection is established, the app should immediately pass through its session public
+  // Once the token has been sent, the app should immediately pass through its session public
   // key and wait for the Launcher to reply with the set of NFS directories to which it has access.
   // The app should then reply to confirm receipt, at which time the connection is closed and the
   // app is orphaned so that it no longer depends on the Launcher running.
   //
-  // The time from the connection being established until the Launcher receives the final
-  // confirmation from the app must be within the 'handshake_timeout_' duration or the launch fails.
+  // Each of these steps (receiving the key after the token, and receiving the confirmation after
+  // the directories are sent) must take no longer than 'handshake_timeout_' or the launch fails.
   //
   // For apps, there is a blocking function to handle this entire process in the API project named
   // 'RegisterAppSession'.
+  //
+  // Throws if the app's executable doesn't exist or can't be started.
   void LaunchApp(const AppName& app_name);
 
+  // As above, but runs on this instance's threads.  The returned future becomes ready once the app
+  // has been started; the connection and handshake with the app continue asynchronously.
+  std::future<void> LaunchAppAsync(const AppName& app_name,
+                                   std::function<void()> on_ready = nullptr);
+
+  // Returns whether any instance of the app launched by this Launcher is still running.
+  bool IsRunning(const AppName& app_name) const;
+
+  // Each launch by this instance (including of the auto-start apps) is traced through the phases
+  // listed in 'LaunchPhase'.  Once finished, the traces are aggregated per app into latency
+  // percentiles for each phase and for the whole launch, which are returned here.
+  std::map<AppName, LaunchStats::AppStats> GetLaunchStats() const;
+
+  // Returns the most recently finished launch traces (up to 'LaunchStats::kMaxRecentTraces').
+  std::vector<LaunchTrace> GetRecentLaunchTraces() const;
+
+  // Writes the launch stats and recent traces to 'path' as JSON.  Throws on error.
+  void WriteLaunchStats(const boost::filesystem::path& path) const;
+
   static const std::chrono::steady_clock::duration connect_timeout_;
   static const std::chrono::steady_clock::duration handshake_timeout_;
 
@@ -145,29 +280,125 @@ class Launcher {
 #endif
 
  private:
+  // All of these run on 'executor'.
+
   // For already existing accounts.
-  Launcher(Keyword keyword, Pin pin, Password password, AccountGetter& account_getter);
+  Launcher(authentication::UserCredentials&& user_credentials,
+           const DerivedCredentials& derived_credentials, AccountGetter& account_getter,
+           const CancellationToken& cancellation_token, std::shared_ptr<Executor> executor);
+
+  // For existing accounts held in 'account_cache'.  Throws 'CommonErrors::no_such_element' if the
+  // cache holds no usable copy of the account.
+  Launcher(authentication::UserCredentials&& user_credentials,
+           const DerivedCredentials& derived_credentials, const AccountCache& account_cache,
+           std::shared_ptr<Executor> executor);
 
   // For new accounts.  Throws on failure to create account.
-  Launcher(Keyword keyword, Pin pin, Password password, passport::MaidAndSigner&& maid_and_signer);
+  Launcher(Keyword keyword, Pin pin, Password password, passport::MaidAndSigner&& maid_and_signer,
+           const CancellationToken& cancellation_token, std::shared_ptr<Executor> executor);
 
   void AddOrLinkApp(AppName app_name, boost::filesystem::path app_path, AppArgs app_args,
                     const SerialisedData* const app_icon, bool auto_start);
 
   void RevertAppHandler(AppHandler::Snapshot snapshot);
 
-  void LaunchApp(const AppName& app_name, const boost::filesystem::path& path, AppArgs args);
+  // Records that the account has changed since 'snapshot' was taken, for 'SaveSession' and
+  // autosaving.  Must be called with 'rollback_mutex_' held since before 'snapshot' was taken, so
+  // that a save can't include the change without also clearing the rollback snapshot it's recorded
+  // against.
+  void MarkUnsaved(const AppHandler::Snapshot& snapshot);
+
+  // If logged in from the account cache and not yet reconciled, retrieves the latest version of the
+  // account from the network and adopts it if it differs from the cached one.  Throws on error.
+  void EnsureReconciled();
+
+  // Initialises 'app_handler_' from the local config file, for the current account.
+  void InitialiseAppHandler();
+
+  // Writes the current account to the account cache if it's enabled.  Errors are only logged, since
+  // the cache is just an optimisation.  Must be called with 'account_mutex_' held.
+  void UpdateAccountCache();
+
+  void ApplyChange(const AppChange& change);
+
+  DirectoryInfo GetSafeDriveDir(DirectoryInfo::AccessRights access_rights) const;
+
+  // Stores 'icon' on the network as a content-addressed chunk, and caches it.
+  void StoreIcon(const SerialisedData& icon);
+
+  // Stores the inline icons of an account saved before icons were held as separate chunks, then
+  // clears them from the account.  Until the account is next fully saved, this is repeated on each
+  // login, cheaply since the chunks already exist.  Throws on error.
+  void MigrateLegacyIcons();
+
+  // Returns the key of the current account which its icon chunks are encrypted with.
+  crypto::AES256KeyAndIV GetIconKey() const;
+
+  // Returns the icon IDs of the apps indicated by 'app_names'.  Throws if any app doesn't exist.
+  std::map<AppName, Identity> GetIconIds(const std::set<AppName>& app_names) const;
+
+  bool IsIconCached(const Identity& icon_id);
+
+  // Retrieves and decrypts the icon chunk named 'icon_id', and caches the icon.  Throws on error.
+  void RetrieveIcon(const Identity& icon_id);
+
+  // Returns the cached icons for 'icon_ids', omitting uninitialised IDs.
+  std::map<AppName, SerialisedData> GetCachedIcons(const std::map<AppName, Identity>& icon_ids);
+
+  // Queues each of the auto-start apps to be launched in the background.  A failure to launch one
+  // app is only logged, and doesn't prevent the others being launched.
+  void LaunchAutoStartApps();
+
+  // 'on_finished' (if non-null) is invoked once the launch has succeeded or failed, unless this
+  // throws.
+  void LaunchApp(const AppName& app_name, const boost::filesystem::path& path, AppArgs args,
+                 std::function<void()> on_finished = nullptr);
+
+  // Invokes and clears the launch's 'on_finished'.  Must be called on the launch's strand.
+  void FinishLaunch(const std::shared_ptr<Launch>& launch);
+
+  void BeginLaunchPhase(Launch& launch, LaunchPhase phase);
+  // Finishes the launch's trace and records it in 'launch_stats_', unless it's already finished.
+  void FinishLaunchTrace(Launch& launch, LaunchTrace::Outcome outcome);
+
+  // Called by the shared listener.  Waits for the connection's first message (the launch token),
+  // then hands the connection to the matching launch, or closes it if there's no such launch.
+  void HandleIncomingConnection(tcp::ConnectionPtr connection);
+
+  // Removes and returns the pending launch with the given token, or null if there's none.
+  std::shared_ptr<Launch> ClaimLaunch(const std::string& token);
 
   void HandleNewConnection(std::shared_ptr<Launch> launch, tcp::ConnectionPtr connection);
 
   void HandleMessage(std::shared_ptr<Launch> launch, tcp::Message message);
 
-  AsioService asio_service_;
+  std::shared_ptr<Executor> executor_;
+  // Guards the handlers which refer to this instance, since the executor may outlive it.  Closed at
+  // the start of the destructor.
+  LifetimeGuard lifetime_guard_;
   std::shared_ptr<NetworkClient> network_client_;
   AccountHandler account_handler_;
   mutable std::mutex account_mutex_;
   AppHandler app_handler_;
+  // Guards 'rollback_snapshot_'.  Must be locked before 'account_mutex_', since 'app_handler_'
+  // locks that itself.
+  std::mutex rollback_mutex_;
   boost::optional<AppHandler::Snapshot> rollback_snapshot_;
+  std::mutex reconcile_mutex_;
+  // Only set under 'reconcile_mutex_', but atomic so that 'LogoutAndStop' can check it without
+  // waiting for a reconcile in progress.
+  std::atomic<bool> needs_reconcile_;
+  CancellationToken reconcile_cancellation_;
+  SaveScheduler save_scheduler_;
+  std::mutex icon_cache_mutex_;
+  std::map<Identity, SerialisedData> icon_cache_;
+  asio::io_service::strand launch_listener_strand_;
+  LaunchStats launch_stats_;
+  std::mutex launches_mutex_;
+  tcp::ListenerPtr launch_listener_;
+  std::map<std::string, std::shared_ptr<Launch>> pending_launches_;
+  ProcessSupervisor process_supervisor_;
+  AutoStartScheduler auto_start_scheduler_;
 };
 
 }  // namespace launcher
@@ -0,0 +1,275 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/process_supervisor.h"
+
+#include <utility>
+
+#ifdef MAIDSAFE_WIN32
+#include <windows.h>
+#include <codecvt>
+#include <locale>
+#include "asio/windows/object_handle.hpp"
+#else
+#include <signal.h>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+extern "C" char** environ;
+#endif
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+struct ProcessSupervisor::Process {
+  Process(AppName app_name_in, OnExit on_exit_in)
+      : app_name(std::move(app_name_in)), on_exit(std::move(on_exit_in)) {}
+
+  AppName app_name;
+  OnExit on_exit;
+#ifdef MAIDSAFE_WIN32
+  std::unique_ptr<asio::windows::object_handle> handle;
+#endif
+};
+
+std::vector<std::string> SplitArgs(const AppArgs& args) {
+  std::vector<std::string> split_args;
+  std::string arg;
+  bool in_arg(false), in_quotes(false);
+  for (char c : args) {
+    if (c == '"') {
+      in_quotes = !in_quotes;
+      in_arg = true;
+    } else if (!in_quotes && (c == ' ' || c == '\t' || c == '\n' || c == '\r')) {
+      if (in_arg)
+        split_args.push_back(std::move(arg));
+      arg.clear();
+      in_arg = false;
+    } else {
+      arg += c;
+      in_arg = true;
+    }
+  }
+  if (in_arg)
+    split_args.push_back(std::move(arg));
+  return split_args;
+}
+
+ProcessSupervisor::ProcessSupervisor(asio::io_service& io_service)
+    : io_service_(io_service),
+      mutex_(),
+#ifdef MAIDSAFE_WIN32
+      processes_(),
+      lifetime_guard_() {}
+#else
+      processes_(),
+      child_signal_(io_service_, SIGCHLD),
+      lifetime_guard_() {
+  WaitForChildSignal();
+}
+#endif
+
+ProcessSupervisor::~ProcessSupervisor() {
+  lifetime_guard_.Close();
+  std::lock_guard<std::mutex> lock{mutex_};
+#ifndef MAIDSAFE_WIN32
+  asio::error_code ignored;
+  child_signal_.cancel(ignored);
+#endif
+  if (!processes_.empty())
+    LOG(kInfo) << "Leaving " << processes_.size() << " child processes running.";
+}
+
+ProcessSupervisor::ProcessId ProcessSupervisor::Spawn(const AppName& app_name, const fs::path& path,
+                                                      const AppArgs& args, OnExit on_exit) {
+  boost::system::error_code exists_error;
+  if (!fs::exists(path, exists_error)) {
+    LOG(kError) << "Can't start " << app_name << ": " << path << " doesn't exist.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  std::unique_ptr<Process> process(new Process(app_name, std::move(on_exit)));
+
+#ifdef MAIDSAFE_WIN32
+  std::wstring command_line(L"\"" + path.wstring() + L"\"");
+  if (!args.empty())
+    command_line += L" " + std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(args);
+  STARTUPINFOW startup_info;
+  ZeroMemory(&startup_info, sizeof(startup_info));
+  startup_info.cb = sizeof(startup_info);
+  PROCESS_INFORMATION process_info;
+  ZeroMemory(&process_info, sizeof(process_info));
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (!CreateProcessW(path.wstring().c_str(), &command_line[0], nullptr, nullptr, FALSE,
+                      CREATE_NEW_PROCESS_GROUP | DETACHED_PROCESS, nullptr, nullptr, &startup_info,
+                      &process_info)) {
+    LOG(kError) << "Failed to start " << app_name << ": error " << GetLastError();
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+  CloseHandle(process_info.hThread);
+  const ProcessId process_id(process_info.dwProcessId);
+  process->handle.reset(new asio::windows::object_handle(io_service_, process_info.hProcess));
+  WaitForExit(process_id, *process);
+#else
+  const std::string path_string(path.string());
+  std::vector<std::string> split_args(SplitArgs(args));
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(path_string.c_str()));
+  for (auto& arg : split_args)
+    argv.push_back(&arg[0]);
+  argv.push_back(nullptr);
+
+  // Give the child its own process group so that it isn't signalled along with the Launcher (e.g.
+  // on Ctrl+C in a terminal), and restore default handling of signals the Launcher may handle.
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  sigset_t default_signals, no_signals;
+  sigemptyset(&default_signals);
+  for (int signal_number : {SIGCHLD, SIGPIPE, SIGINT, SIGTERM, SIGHUP})
+    sigaddset(&default_signals, signal_number);
+  sigemptyset(&no_signals);
+  posix_spawnattr_setsigdefault(&attributes, &default_signals);
+  posix_spawnattr_setsigmask(&attributes, &no_signals);
+  posix_spawnattr_setpgroup(&attributes, 0);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF |
+                                            POSIX_SPAWN_SETSIGMASK);
+
+  // The lock is held until the child is recorded, so that it can't be reaped before then.
+  std::lock_guard<std::mutex> lock{mutex_};
+  pid_t pid(0);
+  const int result(posix_spawn(&pid, path_string.c_str(), nullptr, &attributes, &argv[0], environ));
+  posix_spawnattr_destroy(&attributes);
+  if (result != 0) {
+    LOG(kError) << "Failed to start " << app_name << ": " << std::strerror(result);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+  const ProcessId process_id(pid);
+#endif
+
+  LOG(kInfo) << "Started " << app_name << " as process " << process_id;
+  processes_.emplace(process_id, std::move(process));
+  return process_id;
+}
+
+bool ProcessSupervisor::IsRunning(const AppName& app_name) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& process : processes_) {
+    if (process.second->app_name == app_name)
+      return true;
+  }
+  return false;
+}
+
+std::vector<ProcessSupervisor::ProcessId> ProcessSupervisor::RunningProcesses(
+    const AppName& app_name) const {
+  std::vector<ProcessId> process_ids;
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& process : processes_) {
+    if (process.second->app_name == app_name)
+      process_ids.push_back(process.first);
+  }
+  return process_ids;
+}
+
+#ifdef MAIDSAFE_WIN32
+
+void ProcessSupervisor::WaitForExit(ProcessId process_id, Process& process) {
+  asio::windows::object_handle& handle(*process.handle);
+  auto on_exit([this, process_id, &handle](const asio::error_code& error) {
+    if (error == asio::error::operation_aborted)
+      return;
+    DWORD exit_code(0);
+    if (error || !GetExitCodeProcess(handle.native_handle(), &exit_code)) {
+      LOG(kWarning) << "Failed to get exit code of process " << process_id;
+      exit_code = static_cast<DWORD>(-1);
+    }
+    HandleExit(process_id, static_cast<int>(exit_code));
+  });
+  handle.async_wait(lifetime_guard_.Wrap(std::move(on_exit)));
+}
+
+#else
+
+void ProcessSupervisor::WaitForChildSignal() {
+  child_signal_.async_wait(
+      lifetime_guard_.Wrap([this](const asio::error_code& error, int /*signal_number*/) {
+        if (error == asio::error::operation_aborted)
+          return;
+        // Signals are merged while pending, so one SIGCHLD may be raised for several children.
+        ReapChildren();
+        WaitForChildSignal();
+      }));
+}
+
+void ProcessSupervisor::ReapChildren() {
+  std::vector<std::pair<ProcessId, int>> exited;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto& process : processes_) {
+      int status(0);
+      pid_t result(0);
+      do {
+        result = waitpid(static_cast<pid_t>(process.first), &status, WNOHANG);
+      } while (result < 0 && errno == EINTR);
+      if (result == 0)
+        continue;  // Still running
+      int exit_code(-1);
+      if (result < 0)
+        LOG(kWarning) << "Failed to reap process " << process.first << ": " << std::strerror(errno);
+      else if (WIFEXITED(status))
+        exit_code = WEXITSTATUS(status);
+      else if (WIFSIGNALED(status))
+        exit_code = 128 + WTERMSIG(status);
+      exited.emplace_back(process.first, exit_code);
+    }
+  }
+  for (const auto& process : exited)
+    HandleExit(process.first, process.second);
+}
+
+#endif
+
+void ProcessSupervisor::HandleExit(ProcessId process_id, int exit_code) {
+  std::unique_ptr<Process> process;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(processes_.find(process_id));
+    if (itr == processes_.end())
+      return;
+    process = std::move(itr->second);
+    processes_.erase(itr);
+  }
+  LOG(kInfo) << process->app_name << " (process " << process_id << ") exited with code "
+             << exit_code;
+  if (process->on_exit)
+    process->on_exit(process_id, exit_code);
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,107 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_PROCESS_SUPERVISOR_H_
+#define MAIDSAFE_LAUNCHER_PROCESS_SUPERVISOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#ifndef MAIDSAFE_WIN32
+#include "asio/signal_set.hpp"
+#endif
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/launcher/executor.h"
+#include "maidsafe/launcher/types.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Splits 'args' into individual arguments at whitespace.  Whitespace within double quotes doesn't
+// split an argument, and the quotes themselves are removed.
+std::vector<std::string> SplitArgs(const AppArgs& args);
+
+// Spawns apps as child processes and tracks them until they exit.  On POSIX, children are started
+// via 'posix_spawn' (which avoids copying the Launcher's address space as a full 'fork' would) and
+// are reaped on 'io_service' when SIGCHLD is raised.  On Windows, each child's process handle is
+// waited on asynchronously on 'io_service'.
+//
+// Children are placed in their own process group so that they outlive the Launcher, and are left
+// running when this is destroyed.  Handlers left queued on 'io_service' when this is destroyed do
+// nothing.  This class is threadsafe.
+class ProcessSupervisor {
+ public:
+  using ProcessId = std::int64_t;
+  // 'exit_code' is the child's exit status, or on POSIX 128 plus the signal number if it was killed
+  // by a signal.
+  using OnExit = std::function<void(ProcessId process_id, int exit_code)>;
+
+  explicit ProcessSupervisor(asio::io_service& io_service);
+  ~ProcessSupervisor();
+
+  ProcessSupervisor(const ProcessSupervisor&) = delete;
+  ProcessSupervisor(ProcessSupervisor&&) = delete;
+  ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+  ProcessSupervisor& operator=(ProcessSupervisor&&) = delete;
+
+  // Starts the executable at 'path' with 'args' (split via 'SplitArgs') and returns its process ID.
+  // 'on_exit' (if non-null) is invoked on 'io_service' once the child has exited and been reaped.
+  // Throws 'CommonErrors::invalid_argument' if 'path' doesn't exist, or
+  // 'CommonErrors::unable_to_handle_request' if the process can't be started.
+  ProcessId Spawn(const AppName& app_name, const boost::filesystem::path& path,
+                  const AppArgs& args, OnExit on_exit = nullptr);
+
+  // Returns whether any child spawned for 'app_name' is still running.
+  bool IsRunning(const AppName& app_name) const;
+  // Returns the process IDs of all running children spawned for 'app_name'.
+  std::vector<ProcessId> RunningProcesses(const AppName& app_name) const;
+
+ private:
+  struct Process;
+
+#ifdef MAIDSAFE_WIN32
+  void WaitForExit(ProcessId process_id, Process& process);
+#else
+  void WaitForChildSignal();
+  void ReapChildren();
+#endif
+  void HandleExit(ProcessId process_id, int exit_code);
+
+  asio::io_service& io_service_;
+  mutable std::mutex mutex_;
+  std::map<ProcessId, std::unique_ptr<Process>> processes_;
+#ifndef MAIDSAFE_WIN32
+  asio::signal_set child_signal_;
+#endif
+  // Declared last so that it's closed before any other member is destroyed.
+  LifetimeGuard lifetime_guard_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_PROCESS_SUPERVISOR_H_
@@ -0,0 +1,146 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/profiler.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#ifdef MAIDSAFE_WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/json.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace {
+
+std::atomic<bool>& ProfilingEnabled() {
+  static std::atomic<bool> enabled(false);
+  return enabled;
+}
+
+std::mutex& EventsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<Profiler::Event>& Events() {
+  static std::vector<Profiler::Event> events;
+  return events;
+}
+
+// Returns zero if the CPU time can't be retrieved.
+std::chrono::nanoseconds ThreadCpuTime() {
+#ifdef MAIDSAFE_WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+    return std::chrono::nanoseconds(0);
+  auto to_100ns([](const FILETIME& file_time) {
+    return (static_cast<std::uint64_t>(file_time.dwHighDateTime) << 32) | file_time.dwLowDateTime;
+  });
+  return std::chrono::nanoseconds((to_100ns(kernel_time) + to_100ns(user_time)) * 100);
+#else
+  timespec cpu_time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) != 0)
+    return std::chrono::nanoseconds(0);
+  return std::chrono::seconds(cpu_time.tv_sec) + std::chrono::nanoseconds(cpu_time.tv_nsec);
+#endif
+}
+
+std::int64_t ToMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+}  // unnamed namespace
+
+const std::size_t Profiler::kMaxEvents(100000);
+
+Profiler::Scope::Scope(const char* category, const char* name)
+    : category_(category),
+      name_(name),
+      enabled_(ProfilingEnabled()),
+      begin_(enabled_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()),
+      begin_cpu_time_(enabled_ ? ThreadCpuTime() : std::chrono::nanoseconds(0)),
+      bytes_(0) {}
+
+Profiler::Scope::~Scope() {
+  if (!enabled_)
+    return;
+  Event event{category_, name_, begin_, std::chrono::steady_clock::now() - begin_,
+              ThreadCpuTime() - begin_cpu_time_, bytes_, std::this_thread::get_id()};
+  std::lock_guard<std::mutex> lock{EventsMutex()};
+  if (Events().size() < kMaxEvents)
+    Events().push_back(std::move(event));
+}
+
+void Profiler::Enable(bool enable) { ProfilingEnabled() = enable; }
+
+bool Profiler::IsEnabled() { return ProfilingEnabled(); }
+
+std::vector<Profiler::Event> Profiler::GetEvents() {
+  std::lock_guard<std::mutex> lock{EventsMutex()};
+  return Events();
+}
+
+void Profiler::Clear() {
+  std::lock_guard<std::mutex> lock{EventsMutex()};
+  Events().clear();
+}
+
+void Profiler::WriteChromeTrace(const boost::filesystem::path& path) {
+  const std::vector<Event> events(GetEvents());
+  // Trace viewers expect small integer thread IDs, so number the threads in order of appearance.
+  std::map<std::thread::id, int> thread_numbers;
+  std::ostringstream output;
+  output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (auto itr(events.begin()); itr != events.end(); ++itr) {
+    const int thread_number(
+        thread_numbers.emplace(itr->thread_id, static_cast<int>(thread_numbers.size()) + 1)
+            .first->second);
+    output << (itr == events.begin() ? "\n" : ",\n") << "  {\"name\": " << JsonString(itr->name)
+           << ", \"cat\": " << JsonString(itr->category) << ", \"ph\": \"X\", \"ts\": "
+           << ToMicroseconds(itr->begin.time_since_epoch()) << ", \"dur\": "
+           << ToMicroseconds(itr->wall_time) << ", \"pid\": 1, \"tid\": " << thread_number
+           << ", \"args\": {\"cpu_us\": "
+           << std::chrono::duration_cast<std::chrono::microseconds>(itr->cpu_time).count()
+           << ", \"bytes\": " << itr->bytes << "}}";
+  }
+  output << "\n]}\n";
+
+  if (!WriteFile(path, output.str())) {
+    LOG(kError) << "Failed to write profile to " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
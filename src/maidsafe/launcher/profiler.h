@@ -0,0 +1,95 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_PROFILER_H_
+#define MAIDSAFE_LAUNCHER_PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// An opt-in, process-wide profiler for the phases of expensive operations such as logging in and
+// creating accounts.  Each phase is marked by a 'Scope', which records its wall time, the CPU time
+// used by its thread and the number of bytes it moved.  Profiling is disabled by default, and while
+// disabled a 'Scope' does nothing beyond checking a flag.  This class is threadsafe.
+class Profiler {
+ public:
+  struct Event {
+    std::string category, name;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::duration wall_time;
+    // The CPU time used by the recording thread, so excludes any work done by other threads while
+    // this one waited.
+    std::chrono::nanoseconds cpu_time;
+    std::uint64_t bytes;
+    std::thread::id thread_id;
+  };
+
+  // Records an event spanning its own lifetime if profiling was enabled when it was constructed.
+  // Scopes nested on one thread are shown nested in the trace.  'category' and 'name' must outlive
+  // the scope (e.g. be string literals).
+  class Scope {
+   public:
+    Scope(const char* category, const char* name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+    // Adds to the bytes read, written or transformed during this phase.
+    void AddBytes(std::uint64_t bytes) { bytes_ += bytes; }
+
+   private:
+    const char* const category_;
+    const char* const name_;
+    const bool enabled_;
+    std::chrono::steady_clock::time_point begin_;
+    std::chrono::nanoseconds begin_cpu_time_;
+    std::uint64_t bytes_;
+  };
+
+  // Once this many events have been recorded, further ones are dropped.
+  static const std::size_t kMaxEvents;
+
+  static void Enable(bool enable);
+  static bool IsEnabled();
+
+  // Returns the recorded events in the order they ended.
+  static std::vector<Event> GetEvents();
+  static void Clear();
+
+  // Writes the recorded events to 'path' in the Chrome trace event format, replacing any existing
+  // file.  This can be loaded via 'chrome://tracing' or other trace viewers.  Throws on error.
+  static void WriteChromeTrace(const boost::filesystem::path& path);
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_PROFILER_H_
@@ -0,0 +1,159 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/save_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+const std::chrono::steady_clock::duration SaveScheduler::kInitialBackoff(std::chrono::seconds(1));
+const std::chrono::steady_clock::duration SaveScheduler::kMaxBackoff(std::chrono::minutes(5));
+
+SaveScheduler::SaveScheduler(asio::io_service& io_service, std::function<void()> save,
+                             std::chrono::steady_clock::duration initial_backoff,
+                             std::chrono::steady_clock::duration max_backoff)
+    : save_(std::move(save)),
+      initial_backoff_(initial_backoff),
+      max_backoff_(std::max(initial_backoff, max_backoff)),
+      mutex_(),
+      timer_(io_service),
+      timer_generation_(0),
+      delay_(std::chrono::steady_clock::duration::zero()),
+      max_delay_(std::chrono::steady_clock::duration::zero()),
+      backoff_(std::chrono::steady_clock::duration::zero()),
+      dirty_(false),
+      saving_(false),
+      change_count_(0),
+      first_unsaved_change_(),
+      lifetime_guard_() {}
+
+void SaveScheduler::SetDelay(std::chrono::steady_clock::duration delay,
+                             std::chrono::steady_clock::duration max_delay) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  delay_ = delay;
+  max_delay_ = std::max(delay, max_delay);
+  if (!dirty_ || saving_ || backoff_ != std::chrono::steady_clock::duration::zero())
+    return;
+  if (delay_ == std::chrono::steady_clock::duration::zero()) {
+    ++timer_generation_;
+    timer_.cancel();
+  } else {
+    Schedule(std::min(std::chrono::steady_clock::now() + delay_,
+                      first_unsaved_change_ + max_delay_));
+  }
+}
+
+void SaveScheduler::MarkDirty() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const auto now(std::chrono::steady_clock::now());
+  ++change_count_;
+  if (!dirty_) {
+    dirty_ = true;
+    first_unsaved_change_ = now;
+  }
+  // A save in progress reschedules once it completes, and a retry keeps its backoff.
+  if (delay_ == std::chrono::steady_clock::duration::zero() || saving_ ||
+      backoff_ != std::chrono::steady_clock::duration::zero()) {
+    return;
+  }
+  Schedule(std::min(now + delay_, first_unsaved_change_ + max_delay_));
+}
+
+void SaveScheduler::MarkSaved() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (saving_)
+    return;
+  dirty_ = false;
+  backoff_ = std::chrono::steady_clock::duration::zero();
+  ++timer_generation_;
+  timer_.cancel();
+}
+
+SaveScheduler::State SaveScheduler::GetState() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (saving_)
+    return State::kSaving;
+  if (!dirty_)
+    return State::kSaved;
+  return backoff_ == std::chrono::steady_clock::duration::zero() ? State::kDirty
+                                                                 : State::kRetrying;
+}
+
+void SaveScheduler::Schedule(std::chrono::steady_clock::time_point when) {
+  const std::uint64_t generation(++timer_generation_);
+  timer_.expires_at(when);
+  timer_.async_wait(lifetime_guard_.Wrap([this, generation](const asio::error_code& error) {
+    if (error == asio::error::operation_aborted)
+      return;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (generation != timer_generation_)
+        return;
+    }
+    Save();
+  }));
+}
+
+void SaveScheduler::Save() {
+  std::uint64_t change_count(0);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!dirty_ || saving_)
+      return;
+    saving_ = true;
+    change_count = change_count_;
+  }
+
+  bool succeeded(false);
+  try {
+    save_();
+    succeeded = true;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to save: " << boost::diagnostic_information(e);
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  saving_ = false;
+  const auto now(std::chrono::steady_clock::now());
+  if (!succeeded) {
+    backoff_ = backoff_ == std::chrono::steady_clock::duration::zero()
+                   ? initial_backoff_
+                   : std::min(backoff_ * 2, max_backoff_);
+    Schedule(now + backoff_);
+    return;
+  }
+  backoff_ = std::chrono::steady_clock::duration::zero();
+  if (change_count_ == change_count) {
+    dirty_ = false;
+    return;
+  }
+  // Save the changes made while saving.
+  first_unsaved_change_ = now;
+  if (delay_ != std::chrono::steady_clock::duration::zero())
+    Schedule(now + delay_);
+}
+
+}  // namespace launcher
+
+}  // namespace maidsafe
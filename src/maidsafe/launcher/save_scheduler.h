@@ -0,0 +1,105 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LAUNCHER_SAVE_SCHEDULER_H_
+#define MAIDSAFE_LAUNCHER_SAVE_SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "asio/io_service.hpp"
+#include "asio/steady_timer.hpp"
+
+#include "maidsafe/launcher/executor.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+// Schedules calls to 'save' on 'io_service' so that changes made in quick succession are saved
+// together.  Once enabled via 'SetDelay', 'save' is called when 'delay' has passed without any
+// further change, or when 'max_delay' has passed since the first unsaved change, whichever is
+// sooner.  If 'save' throws, it's retried after a backoff which doubles after each failure (from
+// 'initial_backoff' up to 'max_backoff') for as long as there are unsaved changes.
+//
+// 'save' is never invoked concurrently with itself, nor with this class' mutex held, so it may call
+// 'MarkSaved'.  Handlers left queued on 'io_service' when this is destroyed do nothing, and
+// destroying this waits for a save in progress.  This class is threadsafe.
+class SaveScheduler {
+ public:
+  enum class State {
+    kSaved,     // no unsaved changes
+    kDirty,     // unsaved changes, with a save scheduled if enabled
+    kSaving,    // a save is in progress
+    kRetrying   // the last save failed, and a retry is scheduled
+  };
+
+  SaveScheduler(asio::io_service& io_service, std::function<void()> save,
+                std::chrono::steady_clock::duration initial_backoff = kInitialBackoff,
+                std::chrono::steady_clock::duration max_backoff = kMaxBackoff);
+
+  SaveScheduler(const SaveScheduler&) = delete;
+  SaveScheduler(SaveScheduler&&) = delete;
+  SaveScheduler& operator=(const SaveScheduler&) = delete;
+  SaveScheduler& operator=(SaveScheduler&&) = delete;
+
+  // A 'delay' of zero disables scheduling saves, although changes are still tracked.  'max_delay'
+  // is raised to 'delay' if it's less.
+  void SetDelay(std::chrono::steady_clock::duration delay,
+                std::chrono::steady_clock::duration max_delay);
+
+  // Records a change, and schedules a save if none is scheduled or in progress.  A change made
+  // while a save is in progress is saved by another save once that one completes.
+  void MarkDirty();
+
+  // Records that all changes have been saved (or discarded) other than via this scheduler, and
+  // cancels any scheduled save.  Has no effect while a save is in progress.
+  void MarkSaved();
+
+  State GetState() const;
+
+  static const std::chrono::steady_clock::duration kInitialBackoff;
+  static const std::chrono::steady_clock::duration kMaxBackoff;
+
+ private:
+  // Must be called with 'mutex_' held.
+  void Schedule(std::chrono::steady_clock::time_point when);
+  void Save();
+
+  const std::function<void()> save_;
+  const std::chrono::steady_clock::duration initial_backoff_, max_backoff_;
+  mutable std::mutex mutex_;
+  asio::steady_timer timer_;
+  // Incremented whenever the timer is reset, so that a handler which was already queued when its
+  // wait was cancelled can tell it's out of date.
+  std::uint64_t timer_generation_;
+  std::chrono::steady_clock::duration delay_, max_delay_, backoff_;
+  bool dirty_, saving_;
+  std::uint64_t change_count_;
+  std::chrono::steady_clock::time_point first_unsaved_change_;
+  // Declared last so that it's closed before any other member is destroyed.
+  LifetimeGuard lifetime_guard_;
+};
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LAUNCHER_SAVE_SCHEDULER_H_
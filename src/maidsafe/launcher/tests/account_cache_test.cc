@@ -0,0 +1,86 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/account_cache.h"
+
+#include <iterator>
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/authentication/user_credential_utils.h"
+
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(AccountCacheTest, BEH_PutGetRemove) {
+  const maidsafe::test::TestPath test_root(
+      maidsafe::test::CreateTestPath("MaidSafe_TestAccountCache"));
+  // The directory should be created when first needed.
+  AccountCache account_cache{*test_root / "cache"};
+  const Identity account_location{MakeIdentity()};
+  const crypto::SecurePassword secure_password{
+      authentication::CreateSecurePassword(GetRandomUserCredentials())};
+  EXPECT_TRUE(account_cache.Get(account_location, secure_password).empty());
+
+  AccountCache::Chunks chunks;
+  for (int i(0); i < 3; ++i)
+    chunks[MakeIdentity()] = RandomString((RandomUint32() % 1000) + 1);
+  account_cache.Put(account_location, secure_password, chunks);
+  EXPECT_EQ(chunks, account_cache.Get(account_location, secure_password));
+  EXPECT_EQ(1, std::distance(fs::directory_iterator(*test_root / "cache"),
+                             fs::directory_iterator()));
+
+  // Other accounts, and the wrong password, shouldn't see the chunks.
+  EXPECT_TRUE(account_cache.Get(MakeIdentity(), secure_password).empty());
+  EXPECT_TRUE(account_cache
+                  .Get(account_location, authentication::CreateSecurePassword(
+                                             GetRandomUserCredentials()))
+                  .empty());
+
+  // Replacing the chunks shouldn't leave a temporary file behind.
+  chunks.erase(chunks.begin());
+  account_cache.Put(account_location, secure_password, chunks);
+  EXPECT_EQ(chunks, account_cache.Get(account_location, secure_password));
+  EXPECT_EQ(1, std::distance(fs::directory_iterator(*test_root / "cache"),
+                             fs::directory_iterator()));
+
+  // A corrupt file should be treated as empty.
+  const fs::path file_path(fs::directory_iterator(*test_root / "cache")->path());
+  ASSERT_TRUE(WriteFile(file_path, RandomString(100)));
+  EXPECT_TRUE(account_cache.Get(account_location, secure_password).empty());
+
+  account_cache.Remove(account_location);
+  EXPECT_FALSE(fs::exists(file_path));
+  EXPECT_TRUE(account_cache.Get(account_location, secure_password).empty());
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
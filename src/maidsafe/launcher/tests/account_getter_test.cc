@@ -18,6 +18,8 @@
 
 #include "maidsafe/launcher/account_getter.h"
 
+#include <memory>
+
 #include "maidsafe/common/test.h"
 
 #include "maidsafe/launcher/tests/test_utils.h"
@@ -40,6 +42,25 @@ TEST_F(AccountGetterTest, FUNC_Constructor) {
   ASSERT_NO_THROW(account_getter = account_getter_future.get());
 }
 
+TEST_F(AccountGetterTest, FUNC_Shared) {
+  AccountGetter::PrewarmShared();
+  std::shared_ptr<AccountGetter> account_getter;
+  ASSERT_NO_THROW(account_getter = AccountGetter::GetShared());
+  ASSERT_TRUE(account_getter != nullptr);
+  EXPECT_TRUE(account_getter->IsConnected());
+
+  // Check the same instance is reused while it remains connected.
+  AccountGetter::PrewarmShared();
+  EXPECT_EQ(account_getter, AccountGetter::GetShared());
+
+  // Check a new instance is created once the shared one has been released.
+  AccountGetter::ReleaseShared();
+  std::shared_ptr<AccountGetter> new_account_getter;
+  ASSERT_NO_THROW(new_account_getter = AccountGetter::GetShared());
+  EXPECT_NE(account_getter, new_account_getter);
+  AccountGetter::ReleaseShared();
+}
+
 }  // namespace test
 
 }  // namespace launcher
@@ -23,6 +23,7 @@
 #include "maidsafe/common/authentication/user_credentials.h"
 
 #include "maidsafe/launcher/account.h"
+#include "maidsafe/launcher/account_cache.h"
 #include "maidsafe/launcher/account_getter.h"
 #include "maidsafe/launcher/launcher.h"
 #include "maidsafe/launcher/tests/test_utils.h"
@@ -97,6 +98,33 @@ TEST_F(AccountHandlerTest, NETWORK_Login) {
   }
 }
 
+TEST_F(AccountHandlerTest, NETWORK_LoginWithDerivedCredentials) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  auto maid_and_signer(passport::CreateMaidAndSigner());
+  // Derive the credentials while the AccountGetter is being created, as Launcher::Login does.
+  auto account_getter_future(AccountGetter::CreateAccountGetter());
+  DerivedCredentials derived_credentials{
+      DeriveCredentials(MakeUserCredentials(user_credentials_tuple))};
+  {
+    auto network_client(GetNetworkClient(maid_and_signer.first));
+    Account account{maid_and_signer};
+    authentication::UserCredentials user_credentials{MakeUserCredentials(user_credentials_tuple)};
+    AccountHandler{std::move(account), std::move(user_credentials), *network_client};
+  }
+  AccountHandler account_handler{};
+  std::shared_ptr<AccountGetter> account_getter{account_getter_future.get()};
+  ASSERT_NO_THROW(account_handler.Login(MakeUserCredentials(user_credentials_tuple),
+                                        derived_credentials, *account_getter));
+  EXPECT_EQ(maid_and_signer.first.name(), account_handler.account_->passport->GetMaid().name());
+
+  // Check credentials which don't match the derived ones fail to login.
+  AccountHandler other_account_handler{};
+  EXPECT_THROW(other_account_handler.Login(MakeUserCredentials(user_credentials_tuple),
+                                           DeriveCredentials(GetRandomUserCredentials()),
+                                           *account_getter),
+               std::exception);
+}
+
 TEST_F(AccountHandlerTest, NETWORK_Save) {
   auto user_credentials_tuple(GetRandomUserCredentialsTuple());
   auto maid_and_signer(passport::CreateMaidAndSigner());
@@ -134,6 +162,89 @@ TEST_F(AccountHandlerTest, NETWORK_Save) {
   }
 }
 
+TEST_F(AccountHandlerTest, NETWORK_SaveIncremental) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  auto maid_and_signer(passport::CreateMaidAndSigner());
+  auto account_getter_future(AccountGetter::CreateAccountGetter());
+  std::shared_ptr<AccountGetter> account_getter{account_getter_future.get()};
+  {
+    auto network_client(GetNetworkClient(maid_and_signer.first));
+    Account account{maid_and_signer};
+    authentication::UserCredentials user_credentials{MakeUserCredentials(user_credentials_tuple)};
+    AccountHandler{std::move(account), std::move(user_credentials), *network_client};
+  }
+  AppRegistry apps;
+  {
+    AccountHandler account_handler{};
+    account_handler.Login(MakeUserCredentials(user_credentials_tuple), *account_getter);
+    auto network_client(GetNetworkClient(account_handler.account_->passport->GetMaid()));
+    // Save enough times to cause the chain of deltas to be compacted at least once, changing the
+    // apps each time.
+    for (std::uint32_t i(0); i != AccountHandler::kMaxDeltaCount + 3; ++i) {
+      account_handler.account_->apps.Insert(CreateRandomAppDetails());
+      if (i % 3 == 2)
+        account_handler.account_->apps.Erase(account_handler.account_->apps.begin()->name);
+      ASSERT_NO_THROW(account_handler.Save(*network_client));
+    }
+    apps = account_handler.account_->apps;
+  }
+  // Check logging in retrieves the latest state, which should be a delta.
+  AccountHandler account_handler{};
+  ASSERT_NO_THROW(
+      account_handler.Login(MakeUserCredentials(user_credentials_tuple), *account_getter));
+  EXPECT_TRUE(Equals(apps, account_handler.account_->apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreIcon | kIgnoreAutoStart)));
+}
+
+TEST_F(AccountHandlerTest, NETWORK_LoginFromCache) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  auto maid_and_signer(passport::CreateMaidAndSigner());
+  auto account_getter_future(AccountGetter::CreateAccountGetter());
+  DerivedCredentials derived_credentials{
+      DeriveCredentials(MakeUserCredentials(user_credentials_tuple))};
+  AccountCache account_cache{*test_root_ / "account_cache"};
+  {
+    auto network_client(GetNetworkClient(maid_and_signer.first));
+    Account account{maid_and_signer};
+    AccountHandler account_handler{std::move(account), MakeUserCredentials(user_credentials_tuple),
+                                   *network_client};
+    ASSERT_NO_THROW(account_handler.StoreInCache(account_cache));
+  }
+
+  // Logging in from the cache shouldn't need the network, and the cached copy should be current.
+  AccountHandler cached_account_handler{};
+  ASSERT_TRUE(cached_account_handler.LoginFromCache(MakeUserCredentials(user_credentials_tuple),
+                                                    derived_credentials, account_cache));
+  EXPECT_EQ(maid_and_signer.first.name(),
+            cached_account_handler.account_->passport->GetMaid().name());
+  std::shared_ptr<AccountGetter> account_getter{account_getter_future.get()};
+  EXPECT_FALSE(cached_account_handler.RetrieveLatest(*account_getter));
+
+  // Save a newer version elsewhere, which the cached copy should then be reconciled with.
+  AppRegistry apps;
+  {
+    AccountHandler account_handler{};
+    account_handler.Login(MakeUserCredentials(user_credentials_tuple), *account_getter);
+    account_handler.account_->apps.Insert(CreateRandomAppDetails());
+    ASSERT_NO_THROW(account_handler.Save(*GetNetworkClient(maid_and_signer.first)));
+    apps = account_handler.account_->apps;
+  }
+  Account* const account{cached_account_handler.account_.get()};
+  ASSERT_TRUE(cached_account_handler.RetrieveLatest(*account_getter));
+  EXPECT_TRUE(account->apps.empty());
+  cached_account_handler.AdoptRetrieved();
+  EXPECT_EQ(account, cached_account_handler.account_.get());
+  EXPECT_TRUE(Equals(apps, account->apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreIcon | kIgnoreAutoStart)));
+  EXPECT_FALSE(cached_account_handler.RetrieveLatest(*account_getter));
+
+  // The cache can't be read with other credentials.
+  AccountHandler other_account_handler{};
+  EXPECT_FALSE(other_account_handler.LoginFromCache(
+      MakeUserCredentials(user_credentials_tuple), DeriveCredentials(GetRandomUserCredentials()),
+      account_cache));
+}
+
 }  // namespace test
 
 }  // namespace launcher
@@ -18,12 +18,21 @@
 
 #include "maidsafe/launcher/account.h"
 
+#include <iterator>
 #include <memory>
+#include <string>
+
+#include "cereal/types/set.hpp"
+#include "cereal/types/string.hpp"
 
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/authentication/user_credential_utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/serialisation/types/asio_and_boost_asio.h"
 
+#include "maidsafe/launcher/app_details.h"
 #include "maidsafe/launcher/tests/test_utils.h"
 
 namespace maidsafe {
@@ -81,10 +90,10 @@ TEST(AccountTest, FUNC_SaveAndLogin) {
   const Identity root_parent_id(MakeIdentity());
   const crypto::AES256KeyAndIV aes_key_and_iv(
       RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize));
-  std::set<AppDetails> apps;
-  apps.insert(CreateRandomAppDetails());
-  apps.insert(CreateRandomAppDetails());
-  apps.insert(CreateRandomAppDetails());
+  AppRegistry apps;
+  apps.Insert(CreateRandomAppDetails());
+  apps.Insert(CreateRandomAppDetails());
+  apps.Insert(CreateRandomAppDetails());
 
   account1->ip = ip;
   account1->port = port;
@@ -115,8 +124,112 @@ TEST(AccountTest, FUNC_SaveAndLogin) {
   EXPECT_EQ(account1->unique_user_id, account2->unique_user_id);
   EXPECT_EQ(account1->root_parent_id, account2->root_parent_id);
   EXPECT_EQ(account1->config_file_aes_key_and_iv, account2->config_file_aes_key_and_iv);
-  EXPECT_TRUE(
-      Equals(account1->apps, account2->apps, (kIgnorePath | kIgnoreArgs | kIgnoreAutoStart)));
+  EXPECT_TRUE(Equals(account1->apps, account2->apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreIcon | kIgnoreAutoStart)));
+  for (const auto& app : account2->apps)
+    EXPECT_TRUE(app.icon.empty());
+}
+
+// Tests incremental serialising/encrypting function and decrypting/parsing delta constructor.
+TEST(AccountTest, FUNC_SaveAndLoginDelta) {
+  Account account{passport::CreateMaidAndSigner()};
+  authentication::UserCredentials user_credentials{GetRandomUserCredentials()};
+  for (int i{0}; i < 5; ++i)
+    account.apps.Insert(CreateRandomAppDetails());
+  ImmutableData encrypted_base{EncryptAccount(user_credentials, account)};
+  EXPECT_FALSE(IsAccountDelta(encrypted_base));
+  const AppDigests base_app_digests{GetAppDigests(account.apps)};
+  ASSERT_EQ(account.apps.size(), base_app_digests.size());
+  account.apps.ClearChanged();
+
+  // Modify one app, remove one and add one.
+  auto modified_app(*account.apps.begin());
+  modified_app.icon = RandomBytes(20, 1000);
+  modified_app.icon_id =
+      MakeIconChunk(modified_app.icon, account.config_file_aes_key_and_iv).Name();
+  account.apps.InsertOrReplace(modified_app);
+  const AppName removed_app_name{std::prev(account.apps.end())->name};
+  account.apps.Erase(removed_app_name);
+  const AppDetails added_app{CreateRandomAppDetails()};
+  account.apps.Insert(added_app);
+  account.port = static_cast<uint16_t>(RandomUint32());
+
+  ImmutableData encrypted_delta{
+      EncryptAccountDelta(user_credentials, encrypted_base.Name(), base_app_digests, 1, account)};
+  EXPECT_TRUE(IsAccountDelta(encrypted_delta));
+  EXPECT_LT(encrypted_delta.Value().string().size(), encrypted_base.Value().string().size());
+
+  // Parse the delta and check it only holds the changes.
+  std::unique_ptr<AccountDelta> delta;
+  ASSERT_NO_THROW(delta = maidsafe::make_unique<AccountDelta>(encrypted_delta, user_credentials));
+  EXPECT_EQ(encrypted_base.Name(), delta->base_account_name);
+  EXPECT_EQ(1U, delta->index);
+  EXPECT_EQ(account.timestamp, delta->timestamp);
+  EXPECT_EQ(account.port, delta->port);
+  ASSERT_EQ(2U, delta->updated_apps.size());
+  ASSERT_EQ(1U, delta->removed_apps.size());
+  EXPECT_EQ(removed_app_name, *delta->removed_apps.begin());
+
+  // Apply the delta to the base account and check the result matches the modified account.
+  Account parsed_account{encrypted_base, user_credentials};
+  EXPECT_TRUE(parsed_account.apps.ChangedApps().empty());
+  ApplyAccountDelta(std::move(*delta), parsed_account);
+  EXPECT_EQ(account.timestamp, parsed_account.timestamp);
+  EXPECT_EQ(account.port, parsed_account.port);
+  EXPECT_EQ(account.unique_user_id, parsed_account.unique_user_id);
+  EXPECT_EQ(account.root_parent_id, parsed_account.root_parent_id);
+  EXPECT_TRUE(Equals(account.apps, parsed_account.apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreIcon | kIgnoreAutoStart)));
+
+  // Check a full account chunk can't be parsed as a delta.
+  EXPECT_THROW((AccountDelta{encrypted_base, user_credentials}), common_error);
+}
+
+// Tests parsing an account saved before icons were moved out of the account, i.e. with no format
+// version and with each app's icon held inline.
+TEST(AccountTest, FUNC_LoginLegacyAccount) {
+  Account account{passport::CreateMaidAndSigner()};
+  authentication::UserCredentials user_credentials{GetRandomUserCredentials()};
+  for (int i(0); i != 3; ++i)
+    account.apps.Insert(CreateRandomAppDetails(account.config_file_aes_key_and_iv));
+  AppDetails app_without_icon{CreateRandomAppDetails()};
+  app_without_icon.icon.clear();
+  app_without_icon.icon_id = Identity{};
+  account.apps.Insert(app_without_icon);
+
+  boost::optional<Identity> unique_user_id{account.unique_user_id},
+      root_parent_id{account.root_parent_id};
+  OutputVectorStream binary_output_stream;
+  BinaryOutputArchive output_archive{binary_output_stream};
+  output_archive(account.passport->Encrypt(user_credentials), GetTimeStamp(), account.ip,
+                 account.port, unique_user_id, root_parent_id, account.config_file_aes_key_and_iv,
+                 account.apps.size());
+  for (const auto& app : account.apps)
+    output_archive(app.name, app.permitted_dirs, app.icon);
+  NonEmptyString serialised_account{
+      std::string(binary_output_stream.vector().begin(), binary_output_stream.vector().end())};
+  ImmutableData encrypted_account{
+      crypto::SymmEncrypt(authentication::Obfuscate(user_credentials, serialised_account),
+                          authentication::CreateSecurePassword(user_credentials))};
+
+  // The inline icons should be kept, and the icon IDs should name the chunks they'll be stored as.
+  std::unique_ptr<Account> parsed_account;
+  ASSERT_NO_THROW(
+      parsed_account = maidsafe::make_unique<Account>(encrypted_account, user_credentials));
+  EXPECT_EQ(account.unique_user_id, parsed_account->unique_user_id);
+  EXPECT_EQ(account.config_file_aes_key_and_iv, parsed_account->config_file_aes_key_and_iv);
+  EXPECT_TRUE(Equals(account.apps, parsed_account->apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreAutoStart)));
+  EXPECT_TRUE(parsed_account->apps.ChangedApps().empty());
+
+  // Saving again should use the current format, which no longer holds the icons.
+  Account resaved_account{EncryptAccount(user_credentials, *parsed_account), user_credentials};
+  EXPECT_TRUE(Equals(account.apps, resaved_account.apps,
+                     (kIgnorePath | kIgnoreArgs | kIgnoreIcon | kIgnoreAutoStart)));
+  for (const auto& app : resaved_account.apps) {
+    EXPECT_TRUE(app.icon.empty());
+    EXPECT_EQ(account.apps.Find(app.name)->icon_id, app.icon_id);
+  }
 }
 
 TEST(AccountTest, FUNC_MoveConstructAndAssign) {
@@ -131,10 +244,10 @@ TEST(AccountTest, FUNC_MoveConstructAndAssign) {
   const Identity root_parent_id{MakeIdentity()};
   const crypto::AES256KeyAndIV aes_key_and_iv{
       RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
-  std::set<AppDetails> apps;
-  apps.insert(CreateRandomAppDetails());
-  apps.insert(CreateRandomAppDetails());
-  apps.insert(CreateRandomAppDetails());
+  AppRegistry apps;
+  apps.Insert(CreateRandomAppDetails());
+  apps.Insert(CreateRandomAppDetails());
+  apps.Insert(CreateRandomAppDetails());
   initial_account.ip = ip;
   initial_account.port = port;
   initial_account.unique_user_id = unique_user_id;
@@ -18,7 +18,10 @@
 
 #include "maidsafe/launcher/app_details.h"
 
+#include <string>
+
 #include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
 
 #include "maidsafe/launcher/tests/test_utils.h"
 
@@ -35,6 +38,7 @@ TEST(AppDetailsTest, BEH_CopyAndMove) {
   EXPECT_TRUE(default_constructed_app.args.empty());
   EXPECT_TRUE(default_constructed_app.permitted_dirs.empty());
   EXPECT_TRUE(default_constructed_app.icon.empty());
+  EXPECT_FALSE(default_constructed_app.icon_id.IsInitialised());
   EXPECT_FALSE(default_constructed_app.auto_start);
 
   // Create two AppDetails with all fields different from eachother
@@ -46,6 +50,7 @@ TEST(AppDetailsTest, BEH_CopyAndMove) {
   if (app1.permitted_dirs.size() == app2.permitted_dirs.size())
     ASSERT_NE(app1.permitted_dirs.begin()->directory_id, app2.permitted_dirs.begin()->directory_id);
   ASSERT_NE(app1.icon, app2.icon);
+  ASSERT_NE(app1.icon_id, app2.icon_id);
   app2.auto_start = !app1.auto_start;
 
   // Copy construct
@@ -106,6 +111,10 @@ TEST(AppDetailsTest, BEH_LessThan) {
   EXPECT_TRUE(operator<(app1, app2));
   EXPECT_FALSE(operator<(app2, app1));
 
+  swap(app1.icon_id, app2.icon_id);
+  EXPECT_TRUE(operator<(app1, app2));
+  EXPECT_FALSE(operator<(app2, app1));
+
   swap(app1.auto_start, app2.auto_start);
   EXPECT_TRUE(operator<(app1, app2));
   EXPECT_FALSE(operator<(app2, app1));
@@ -131,11 +140,34 @@ TEST(AppDetailsTest, BEH_LessThan) {
   EXPECT_FALSE(operator<(app1, app3));
   EXPECT_FALSE(operator<(app3, app1));
 
+  app3.icon_id = Identity{};
+  EXPECT_FALSE(operator<(app1, app3));
+  EXPECT_FALSE(operator<(app3, app1));
+
   app3.auto_start = !app3.auto_start;
   EXPECT_FALSE(operator<(app1, app3));
   EXPECT_FALSE(operator<(app3, app1));
 }
 
+TEST(AppDetailsTest, BEH_MakeIconChunk) {
+  const crypto::AES256KeyAndIV key_and_iv{
+      RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+  const SerialisedData icon(RandomBytes(20, 1000));
+  // The chunk is content-addressed, so the same icon always yields the same name for one account.
+  const ImmutableData icon_chunk{MakeIconChunk(icon, key_and_iv)};
+  EXPECT_EQ(icon_chunk.Name(), MakeIconChunk(icon, key_and_iv).Name());
+  EXPECT_NE(icon_chunk.Name(), MakeIconChunk(RandomBytes(20, 1000), key_and_iv).Name());
+  EXPECT_THROW(MakeIconChunk(SerialisedData{}, key_and_iv), std::exception);
+
+  // The icon is encrypted under a key derived from the account's.
+  EXPECT_EQ(std::string::npos,
+            icon_chunk.Value().string().find(std::string(icon.begin(), icon.end())));
+  EXPECT_EQ(icon, ParseIconChunk(icon_chunk, key_and_iv));
+  const crypto::AES256KeyAndIV other_key_and_iv{
+      RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+  EXPECT_NE(icon_chunk.Name(), MakeIconChunk(icon, other_key_and_iv).Name());
+}
+
 }  // namespace test
 
 }  // namespace launcher
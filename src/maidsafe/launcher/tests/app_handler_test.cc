@@ -18,19 +18,28 @@
 
 #include "maidsafe/launcher/app_handler.h"
 
+#include <fstream>
+#include <iterator>
 #include <mutex>
+#include <set>
+#include <string>
 
 #include "asio/ip/address_v6.hpp"
 #include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
+#include "cereal/types/string.hpp"
 
+#include "maidsafe/common/convert.h"
 #include "maidsafe/common/crypto.h"
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/serialisation/types/boost_filesystem.h"
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/launcher/account.h"
+#include "maidsafe/launcher/config_journal.h"
 #include "maidsafe/launcher/tests/test_utils.h"
 
 namespace fs = boost::filesystem;
@@ -52,11 +61,11 @@ class AppHandlerTest : public testing::Test {
     account_.unique_user_id = Identity{MakeIdentity()};
     account_.root_parent_id = Identity{MakeIdentity()};
     for (int i{0}; i < 5; ++i)
-      account_.apps.insert(CreateRandomAppDetails());
+      account_.apps.Insert(CreateRandomAppDetails(account_.config_file_aes_key_and_iv));
   }
 
-  fs::path SnapshotConfigFile(const AppHandler::Snapshot& snapshot) {
-    return *snapshot.config_file;
+  const std::uint64_t* SnapshotPosition(const AppHandler::Snapshot& snapshot) {
+    return snapshot.undo_position.get();
   }
 
   const maidsafe::test::TestPath test_root_;
@@ -78,10 +87,10 @@ TEST_F(AppHandlerTest, BEH_Snapshot) {
   auto empty_snapshot(maidsafe::make_unique<AppHandler::Snapshot>(app_handler.GetSnapshot()));
 
   // Cause config file to be created by adding apps.
-  const std::uint32_t app_count{(RandomUint32() % 100) + 1};
+  const std::uint32_t app_count{(RandomUint32() % 100) + 2};
   std::set<AppDetails> apps;
   for (std::uint32_t i{0}; i < app_count; ++i) {
-    AppDetails app{CreateRandomAppDetails()};
+    AppDetails app{CreateRandomAppDetails(account_.config_file_aes_key_and_iv)};
     AppDetails added_app(
         app_handler.AddOrLinkApp(app.name, app.path, app.args, &app.icon, app.auto_start));
     app.permitted_dirs.insert(*added_app.permitted_dirs.begin());
@@ -92,33 +101,38 @@ TEST_F(AppHandlerTest, BEH_Snapshot) {
   ASSERT_TRUE(fs::exists(config_file));
   ASSERT_TRUE(Equals(apps, app_handler.GetApps(true)));
 
-  // Check that creating a snapshot copies the config file and that copying and moving a snapshot
-  // doesn't affect the file copy being destroyed when the final snapshot copy is destroyed.
-  fs::path snapshot_config_file;
+  // Check that creating, copying and moving snapshots doesn't copy the config file, and that copies
+  // share their position in the undo log.
   {
     AppHandler::Snapshot snapshot0;
     {
-      AppHandler::Snapshot snapshot1;
-      {
-        AppHandler::Snapshot snapshot2(app_handler.GetSnapshot());
-        snapshot_config_file = SnapshotConfigFile(snapshot2);
-        EXPECT_TRUE(fs::exists(snapshot_config_file));
-        EXPECT_EQ(ReadFile(config_file).value(), ReadFile(snapshot_config_file).value());
-        snapshot1 = snapshot2;
-      }
-      EXPECT_TRUE(fs::exists(snapshot_config_file));
-      EXPECT_EQ(ReadFile(config_file).value(), ReadFile(snapshot_config_file).value());
+      AppHandler::Snapshot snapshot1(app_handler.GetSnapshot());
+      AppHandler::Snapshot snapshot2(snapshot1);
+      EXPECT_EQ(SnapshotPosition(snapshot1), SnapshotPosition(snapshot2));
       snapshot0 = std::move(snapshot1);
+      EXPECT_EQ(SnapshotPosition(snapshot0), SnapshotPosition(snapshot2));
     }
-    EXPECT_TRUE(fs::exists(snapshot_config_file));
-    EXPECT_EQ(ReadFile(config_file).value(), ReadFile(snapshot_config_file).value());
+    EXPECT_EQ(1, std::distance(fs::directory_iterator(*test_root_), fs::directory_iterator()));
+
+    // Check that only the modified apps are reported as changed, and that applying the snapshot
+    // undoes the changes in both the registries and the account.
+    EXPECT_TRUE(app_handler.ChangedAppsSince(snapshot0).empty());
+    const AppName& removed_app_name(apps.begin()->name);
+    const AppName& renamed_app_name(apps.rbegin()->name);
+    const AppName new_name(RandomAlphaNumericString(41));
+    app_handler.RemoveLocally(removed_app_name);
+    app_handler.UpdateName(renamed_app_name, new_name);
+    EXPECT_EQ(app_count - 1, app_handler.GetApps(true).size());
+    EXPECT_EQ((std::set<AppName>{removed_app_name, renamed_app_name, new_name}),
+              app_handler.ChangedAppsSince(snapshot0));
+    app_handler.ApplySnapshot(snapshot0);
+    EXPECT_TRUE(Equals(apps, app_handler.GetApps(true)));
+    EXPECT_TRUE(account_.apps.Contains(renamed_app_name));
+    EXPECT_FALSE(account_.apps.Contains(new_name));
   }
-  EXPECT_FALSE(fs::exists(snapshot_config_file));
 
   // Keep a copy of the current snapshot to try applying later
   auto snapshot(maidsafe::make_unique<AppHandler::Snapshot>(app_handler.GetSnapshot()));
-  snapshot_config_file = SnapshotConfigFile(*snapshot);
-  auto config_file_contents(ReadFile(config_file).value());
 
   // Check that applying the "empty" snapshot clears the data and removes the config file
   ASSERT_EQ(app_count, app_handler.GetApps(true).size());
@@ -128,12 +142,143 @@ TEST_F(AppHandlerTest, BEH_Snapshot) {
   EXPECT_FALSE(fs::exists(config_file));
   empty_snapshot.reset();
 
-  // Check that applying the other snapshot renews the data and config file.
+  // Check that applying the other snapshot renews the data and rewrites the config file.
   app_handler.ApplySnapshot(std::move(*snapshot));
   EXPECT_TRUE(Equals(apps, app_handler.GetApps(true)));
   EXPECT_TRUE(fs::exists(config_file));
+  AppHandler reloaded_app_handler;
+  reloaded_app_handler.Initialise(config_file, &account_, &account_mutex_);
+  EXPECT_TRUE(Equals(apps, reloaded_app_handler.GetApps(true)));
+}
+
+TEST_F(AppHandlerTest, BEH_Batch) {
+  AppHandler app_handler;
+  fs::path config_file{*test_root_ / "config.txt"};
+  app_handler.Initialise(config_file, &account_, &account_mutex_);
+
+  // The config file shouldn't be written until the batch is ended.
+  std::set<AppDetails> apps;
+  app_handler.BeginBatch();
+  for (int i{0}; i < 10; ++i) {
+    AppDetails app{CreateRandomAppDetails(account_.config_file_aes_key_and_iv)};
+    app.permitted_dirs.clear();
+    AppDetails added_app(
+        app_handler.AddOrLinkApp(app.name, app.path, app.args, &app.icon, app.auto_start));
+    app.permitted_dirs = added_app.permitted_dirs;
+    app.auto_start = !app.auto_start;
+    app_handler.UpdateAutoStart(app.name, app.auto_start);
+    ASSERT_TRUE(apps.insert(std::move(app)).second);
+  }
+  EXPECT_FALSE(fs::exists(config_file));
+  EXPECT_TRUE(Equals(apps, app_handler.GetApps(true)));
+  app_handler.EndBatch(true);
+  ASSERT_TRUE(fs::exists(config_file));
+  auto config_file_contents(ReadFile(config_file).value());
+
+  // An abandoned batch shouldn't write the config file.
+  app_handler.BeginBatch();
+  app_handler.RemoveLocally(apps.begin()->name);
+  app_handler.EndBatch(false);
   EXPECT_EQ(config_file_contents, ReadFile(config_file).value());
-  EXPECT_FALSE(fs::exists(snapshot_config_file));
+}
+
+TEST_F(AppHandlerTest, BEH_ReloadFromJournal) {
+  fs::path config_file{*test_root_ / "config.txt"};
+  std::set<AppDetails> apps;
+  {
+    AppHandler app_handler;
+    app_handler.Initialise(config_file, &account_, &account_mutex_);
+    // Make enough changes to cause the journal to be compacted at least once.
+    for (std::size_t i{0}; i < ConfigJournal::kMaxRecords; ++i) {
+      AppDetails app{CreateRandomAppDetails(account_.config_file_aes_key_and_iv)};
+      app_handler.AddOrLinkApp(app.name, app.path, app.args, &app.icon, app.auto_start);
+      if (i % 3 == 0) {
+        app_handler.UpdatePath(app.name, RandomAlphaNumericString(10));
+      } else if (i % 3 == 1) {
+        AppName new_name{RandomAlphaNumericString(41)};
+        app_handler.UpdateName(app.name, new_name);
+        app_handler.UpdateAutoStart(new_name, !app.auto_start);
+      } else {
+        app_handler.RemoveLocally(app.name);
+      }
+    }
+    apps = app_handler.GetApps(true);
+  }
+
+  // Append a torn record, which should be discarded when reloading.
+  const auto committed_size(fs::file_size(config_file));
+  {
+    std::ofstream config_stream(config_file.string(), std::ios::binary | std::ios::app);
+    config_stream << RandomString(100);
+  }
+
+  AppHandler app_handler;
+  app_handler.Initialise(config_file, &account_, &account_mutex_);
+  EXPECT_TRUE(Equals(apps, app_handler.GetApps(true), kIgnorePermittedDirs | kIgnoreIcon));
+  EXPECT_EQ(committed_size, fs::file_size(config_file));
+}
+
+TEST_F(AppHandlerTest, BEH_CompactToBoundedRecords) {
+  fs::path config_file{*test_root_ / "config.txt"};
+  std::set<AppDetails> apps;
+  {
+    AppHandler app_handler;
+    app_handler.Initialise(config_file, &account_, &account_mutex_);
+    // Appending this many records at once compacts the config file.
+    app_handler.BeginBatch();
+    for (std::size_t i{0}; i < 2 * ConfigJournal::kMaxRecords; ++i) {
+      AppDetails app{CreateRandomAppDetails(account_.config_file_aes_key_and_iv)};
+      app_handler.AddOrLinkApp(app.name, app.path, RandomAlphaNumericString(1000), &app.icon,
+                               app.auto_start);
+    }
+    app_handler.EndBatch(true);
+    apps = app_handler.GetApps(true);
+  }
+
+  // The apps should be split between several records, so that reading the config file never
+  // decrypts all of them at once.
+  ConfigJournal journal{config_file, account_.config_file_aes_key_and_iv};
+  const std::vector<std::string> records(journal.Recover());
+  std::size_t total_size{0};
+  for (const auto& record : records)
+    total_size += record.size();
+  EXPECT_LT(1U, records.size());
+  for (const auto& record : records)
+    EXPECT_LT(record.size(), total_size / 2);
+
+  AppHandler app_handler;
+  app_handler.Initialise(config_file, &account_, &account_mutex_);
+  EXPECT_TRUE(Equals(apps, app_handler.GetApps(true), kIgnorePermittedDirs | kIgnoreIcon));
+}
+
+TEST_F(AppHandlerTest, BEH_ReadLegacyConfigFile) {
+  // Write a legacy config file holding some of the account's apps as local ones.
+  fs::path config_file{*test_root_ / "config.txt"};
+  std::set<AppDetails> local_apps;
+  std::string serialised_contents(ConvertToString(std::size_t{2}));
+  for (const auto& app : account_.apps) {
+    if (local_apps.size() == 2)
+      break;
+    local_apps.insert(app);
+    serialised_contents += ConvertToString(app.name, app.path, app.args, app.auto_start);
+  }
+  ASSERT_TRUE(WriteFile(
+      config_file,
+      crypto::SymmEncrypt(
+          crypto::Compress(crypto::UncompressedText(convert::ToByteVector(serialised_contents)), 9)
+              .data,
+          account_.config_file_aes_key_and_iv)->string()));
+
+  // The apps should be loaded, and the file converted to a journal.
+  {
+    AppHandler app_handler;
+    app_handler.Initialise(config_file, &account_, &account_mutex_);
+    EXPECT_TRUE(Equals(local_apps, app_handler.GetApps(true)));
+  }
+  EXPECT_EQ("MSCJ", ReadFile(config_file).value().substr(0, 4));
+  AppHandler app_handler;
+  app_handler.Initialise(config_file, &account_, &account_mutex_);
+  EXPECT_TRUE(Equals(local_apps, app_handler.GetApps(true)));
 }
 
 }  // namespace test
@@ -0,0 +1,127 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/app_handshake.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "asio/io_service_strand.hpp"
+#include "cereal/types/set.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/listener.h"
+
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+class AppHandshakeTest : public testing::Test {
+ protected:
+  AppHandshakeTest()
+      : asio_service_(2),
+        strand_(asio_service_.service()),
+        client_strand_(asio_service_.service()),
+        permitted_dirs_{CreateRandomDirectoryInfo(), CreateRandomDirectoryInfo()},
+        handshake_(),
+        result_(),
+        listener_(tcp::Listener::MakeShared(
+            strand_, [this](tcp::ConnectionPtr connection) { OnConnection(connection); },
+            tcp::Port{0})) {}
+
+  ~AppHandshakeTest() {
+    listener_->StopListening();
+    asio_service_.Stop();
+  }
+
+  // Plays the Launcher's part, as 'Launcher::HandleNewConnection' does.
+  void OnConnection(tcp::ConnectionPtr connection) {
+    handshake_ = std::make_shared<AppHandshake>(
+        strand_, connection, std::chrono::milliseconds(500), [this] { return permitted_dirs_; },
+        [this](bool succeeded) { result_.set_value(succeeded); });
+    std::shared_ptr<AppHandshake> handshake(handshake_);
+    connection->Start(strand_.wrap([=](tcp::Message message) { handshake->OnMessage(message); }),
+                      strand_.wrap([=] { handshake->OnConnectionClosed(); }));
+    handshake->Start();
+  }
+
+  AsioService asio_service_;
+  asio::io_service::strand strand_, client_strand_;
+  const std::set<DirectoryInfo> permitted_dirs_;
+  std::shared_ptr<AppHandshake> handshake_;
+  std::promise<bool> result_;
+  tcp::ListenerPtr listener_;
+};
+
+TEST_F(AppHandshakeTest, BEH_Succeed) {
+  const asymm::Keys session_keys(asymm::GenerateKeyPair());
+  std::promise<tcp::Message> dirs_message;
+  tcp::ConnectionPtr app(tcp::Connection::MakeShared(client_strand_, listener_->ListeningPort()));
+  app->Start([&](tcp::Message message) { dirs_message.set_value(std::move(message)); }, [] {});
+  const std::string encoded_key(asymm::EncodeKey(session_keys.public_key).string());
+  app->Send(tcp::Message(encoded_key.begin(), encoded_key.end()));
+
+  auto dirs_future(dirs_message.get_future());
+  ASSERT_EQ(std::future_status::ready, dirs_future.wait_for(std::chrono::seconds(5)));
+  EXPECT_EQ(permitted_dirs_, Parse<std::set<DirectoryInfo>>(dirs_future.get()));
+  app->Send(tcp::Message(1, 1));
+
+  auto result(result_.get_future());
+  ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(5)));
+  EXPECT_TRUE(result.get());
+  EXPECT_EQ(AppHandshake::State::kSucceeded, handshake_->GetState());
+  EXPECT_TRUE(asymm::MatchingKeys(session_keys.public_key, handshake_->AppSessionPublicKey()));
+}
+
+TEST_F(AppHandshakeTest, BEH_TimeOut) {
+  // The app connects but never sends its key.
+  tcp::ConnectionPtr app(tcp::Connection::MakeShared(client_strand_, listener_->ListeningPort()));
+  app->Start([](tcp::Message) {}, [] {});
+  auto result(result_.get_future());
+  ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(5)));
+  EXPECT_FALSE(result.get());
+  EXPECT_EQ(AppHandshake::State::kFailed, handshake_->GetState());
+  EXPECT_TRUE(handshake_->TimedOut());
+  EXPECT_TRUE(ThrowsAs([&] { handshake_->AppSessionPublicKey(); }, CommonErrors::uninitialised));
+}
+
+TEST_F(AppHandshakeTest, BEH_InvalidKey) {
+  tcp::ConnectionPtr app(tcp::Connection::MakeShared(client_strand_, listener_->ListeningPort()));
+  app->Start([](tcp::Message) {}, [] {});
+  app->Send(tcp::Message(10, 'x'));
+  auto result(result_.get_future());
+  ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(5)));
+  EXPECT_FALSE(result.get());
+  EXPECT_FALSE(handshake_->TimedOut());
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
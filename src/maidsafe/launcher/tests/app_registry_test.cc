@@ -0,0 +1,221 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/app_registry.h"
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(AppRegistryTest, BEH_InsertFindErase) {
+  AppRegistry registry;
+  EXPECT_TRUE(registry.empty());
+  std::set<AppDetails> apps;
+  for (int i{0}; i < 10; ++i) {
+    AppDetails app{CreateRandomAppDetails()};
+    apps.insert(app);
+    EXPECT_TRUE(registry.Insert(app));
+    EXPECT_FALSE(registry.Insert(app));
+  }
+  EXPECT_TRUE(Equals(apps, registry));
+
+  const AppDetails* const found{registry.Find(apps.begin()->name)};
+  ASSERT_TRUE(found != nullptr);
+  EXPECT_TRUE(Equals(*apps.begin(), *found));
+  EXPECT_TRUE(registry.Find(RandomAlphaNumericString(41)) == nullptr);
+
+  // Replacing an app should update the indexes.
+  AppDetails replacement{CreateRandomAppDetails()};
+  replacement.name = apps.begin()->name;
+  replacement.auto_start = !apps.begin()->auto_start;
+  registry.InsertOrReplace(replacement);
+  EXPECT_EQ(apps.size(), registry.size());
+  EXPECT_EQ(replacement.auto_start, registry.AutoStartApps().count(replacement.name) == 1);
+  for (const auto& dir : apps.begin()->permitted_dirs)
+    EXPECT_TRUE(registry.AppsPermittedToAccess(dir.directory_id).empty());
+  for (const auto& dir : replacement.permitted_dirs)
+    EXPECT_EQ(1U, registry.AppsPermittedToAccess(dir.directory_id).count(replacement.name));
+
+  EXPECT_TRUE(registry.Erase(replacement.name));
+  EXPECT_FALSE(registry.Erase(replacement.name));
+  EXPECT_FALSE(registry.Contains(replacement.name));
+  EXPECT_EQ(0U, registry.AutoStartApps().count(replacement.name));
+  for (const auto& dir : replacement.permitted_dirs)
+    EXPECT_TRUE(registry.AppsPermittedToAccess(dir.directory_id).empty());
+
+  registry.Clear();
+  EXPECT_TRUE(registry.empty());
+  EXPECT_TRUE(registry.AutoStartApps().empty());
+}
+
+TEST(AppRegistryTest, BEH_Modify) {
+  AppRegistry registry;
+  AppDetails app0{CreateRandomAppDetails()}, app1{CreateRandomAppDetails()};
+  app0.auto_start = false;
+  ASSERT_TRUE(registry.Insert(app0));
+  ASSERT_TRUE(registry.Insert(app1));
+
+  // Share a directory between both apps.
+  const DirectoryInfo shared_dir{CreateRandomDirectoryInfo()};
+  for (const auto& app_name : {app0.name, app1.name}) {
+    registry.Modify(app_name, [&](AppDetails& app) { app.permitted_dirs.insert(shared_dir); });
+  }
+  EXPECT_EQ((std::set<AppName>{app0.name, app1.name}),
+            registry.AppsPermittedToAccess(shared_dir.directory_id));
+
+  registry.Modify(app0.name, [](AppDetails& app) { app.auto_start = true; });
+  EXPECT_EQ(1U, registry.AutoStartApps().count(app0.name));
+
+  // Renaming should re-key the app and its index entries.
+  const AppName new_name{RandomAlphaNumericString(41)};
+  registry.Modify(app0.name, [&](AppDetails& app) { app.name = new_name; });
+  EXPECT_FALSE(registry.Contains(app0.name));
+  ASSERT_TRUE(registry.Contains(new_name));
+  EXPECT_EQ(1U, registry.AutoStartApps().count(new_name));
+  EXPECT_EQ(0U, registry.AutoStartApps().count(app0.name));
+  EXPECT_EQ((std::set<AppName>{new_name, app1.name}),
+            registry.AppsPermittedToAccess(shared_dir.directory_id));
+
+  // Renaming to an existing name should fail and leave the app unchanged.
+  EXPECT_TRUE(ThrowsAs([&] {
+    registry.Modify(new_name, [&](AppDetails& app) { app.name = app1.name; });
+  }, CommonErrors::unable_to_handle_request));
+  EXPECT_TRUE(registry.Contains(new_name));
+  EXPECT_EQ(2U, registry.size());
+  EXPECT_EQ(1U, registry.AutoStartApps().count(new_name));
+
+  EXPECT_TRUE(ThrowsAs([&] { registry.Modify(app0.name, [](AppDetails&) {}); },
+                       CommonErrors::no_such_element));
+
+  // A throwing modifier should leave the registry unchanged.
+  registry.ClearChanged();
+  EXPECT_THROW(registry.Modify(new_name, [](AppDetails& app) {
+    app.auto_start = false;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unknown));
+  }), common_error);
+  EXPECT_EQ(1U, registry.AutoStartApps().count(new_name));
+  EXPECT_TRUE(registry.Find(new_name)->auto_start);
+  EXPECT_TRUE(registry.ChangedApps().empty());
+}
+
+TEST(AppRegistryTest, BEH_CopiesShareApps) {
+  AppRegistry registry;
+  AppDetails app0{CreateRandomAppDetails()}, app1{CreateRandomAppDetails()};
+  ASSERT_TRUE(registry.Insert(app0));
+  ASSERT_TRUE(registry.Insert(app1));
+
+  // A copy shouldn't copy the apps themselves.
+  AppRegistry copy{registry};
+  EXPECT_EQ(registry.Find(app0.name), copy.Find(app0.name));
+  EXPECT_EQ(registry.Find(app1.name), copy.Find(app1.name));
+
+  // Modifying an app in the copy should only replace that app, and only in the copy.
+  const AppDetails* const original_app0{registry.Find(app0.name)};
+  copy.Modify(app0.name, [](AppDetails& app) { app.auto_start = !app.auto_start; });
+  EXPECT_EQ(original_app0, registry.Find(app0.name));
+  EXPECT_EQ(app0.auto_start, registry.Find(app0.name)->auto_start);
+  EXPECT_NE(app0.auto_start, copy.Find(app0.name)->auto_start);
+  EXPECT_EQ(registry.Find(app1.name), copy.Find(app1.name));
+
+  copy.Erase(app1.name);
+  EXPECT_TRUE(registry.Contains(app1.name));
+}
+
+TEST(AppRegistryTest, BEH_Restore) {
+  AppRegistry registry;
+  AppDetails app0{CreateRandomAppDetails()}, app1{CreateRandomAppDetails()};
+  app0.auto_start = false;
+  ASSERT_TRUE(registry.Insert(app0));
+  EXPECT_FALSE(registry.FindShared(app1.name));
+
+  // Restoring the recorded instances should undo modifying, erasing and inserting apps.
+  const std::shared_ptr<const AppDetails> original_app0{registry.FindShared(app0.name)};
+  ASSERT_EQ(registry.Find(app0.name), original_app0.get());
+  registry.Modify(app0.name, [](AppDetails& app) { app.auto_start = true; });
+  EXPECT_EQ(1U, registry.AutoStartApps().count(app0.name));
+  registry.Restore(app0.name, original_app0);
+  EXPECT_EQ(original_app0.get(), registry.Find(app0.name));
+  EXPECT_TRUE(registry.AutoStartApps().empty());
+
+  EXPECT_TRUE(registry.Erase(app0.name));
+  registry.Restore(app0.name, original_app0);
+  EXPECT_EQ(original_app0.get(), registry.Find(app0.name));
+
+  ASSERT_TRUE(registry.Insert(app1));
+  registry.ClearChanged();
+  registry.Restore(app1.name, nullptr);
+  EXPECT_FALSE(registry.Contains(app1.name));
+  EXPECT_EQ(std::set<AppName>{app1.name}, registry.ChangedApps());
+
+  // Restoring an app to its current state shouldn't count as a change.
+  registry.ClearChanged();
+  registry.Restore(app0.name, original_app0);
+  registry.Restore(app1.name, nullptr);
+  EXPECT_TRUE(registry.ChangedApps().empty());
+  EXPECT_EQ(1U, registry.size());
+}
+
+TEST(AppRegistryTest, BEH_ChangedApps) {
+  AppRegistry registry;
+  AppDetails app0{CreateRandomAppDetails()}, app1{CreateRandomAppDetails()},
+      app2{CreateRandomAppDetails()};
+  for (const auto& app : {app0, app1, app2})
+    ASSERT_TRUE(registry.Insert(app));
+  EXPECT_EQ((std::set<AppName>{app0.name, app1.name, app2.name}), registry.ChangedApps());
+  registry.ClearChanged();
+  EXPECT_TRUE(registry.ChangedApps().empty());
+
+  // Failing to insert or erase shouldn't count as a change.
+  EXPECT_FALSE(registry.Insert(app0));
+  EXPECT_FALSE(registry.Erase(RandomAlphaNumericString(41)));
+  EXPECT_TRUE(registry.ChangedApps().empty());
+
+  const AppName new_name{RandomAlphaNumericString(41)};
+  registry.Modify(app0.name, [&](AppDetails& app) { app.name = new_name; });
+  EXPECT_TRUE(registry.Erase(app1.name));
+  EXPECT_EQ((std::set<AppName>{app0.name, new_name, app1.name}), registry.ChangedApps());
+
+  // Copies and swaps should carry the changes with the apps.
+  AppRegistry copy{registry};
+  AppRegistry other;
+  swap(copy, other);
+  EXPECT_TRUE(copy.ChangedApps().empty());
+  EXPECT_EQ(registry.ChangedApps(), other.ChangedApps());
+
+  registry.ClearChanged();
+  registry.Clear();
+  EXPECT_EQ((std::set<AppName>{new_name, app2.name}), registry.ChangedApps());
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,156 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/auto_start_scheduler.h"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+namespace {
+
+// Polls 'condition' until it's true or 'timeout' has passed.
+bool WaitFor(const std::function<bool()>& condition,
+             std::chrono::steady_clock::duration timeout = std::chrono::seconds(5)) {
+  const auto deadline(std::chrono::steady_clock::now() + timeout);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+std::vector<AppDetails> MakeApps(const std::vector<AppName>& names) {
+  std::vector<AppDetails> apps;
+  for (const auto& name : names) {
+    AppDetails app;
+    app.name = name;
+    apps.push_back(app);
+  }
+  return apps;
+}
+
+}  // unnamed namespace
+
+TEST(AutoStartSchedulerTest, BEH_ConcurrencyAndPriority) {
+  // A single thread, so that launches start in the order they're scheduled.
+  AsioService asio_service(1);
+  std::mutex mutex;
+  std::vector<AppName> launched;
+  std::vector<std::function<void()>> in_progress;
+  AutoStartScheduler scheduler{asio_service.service(),
+                               [&](const AppDetails& app, std::function<void()> on_finished) {
+                                 std::lock_guard<std::mutex> lock{mutex};
+                                 launched.push_back(app.name);
+                                 if (app.name == "d")
+                                   BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+                                 in_progress.push_back(std::move(on_finished));
+                               }};
+  auto launched_count([&]() -> std::size_t {
+    std::lock_guard<std::mutex> lock{mutex};
+    return launched.size();
+  });
+  auto finish_one([&] {
+    std::lock_guard<std::mutex> lock{mutex};
+    ASSERT_FALSE(in_progress.empty());
+    auto on_finished(std::move(in_progress.front()));
+    in_progress.erase(in_progress.begin());
+    on_finished();
+    on_finished();  // Extra calls should be ignored.
+  });
+
+  AutoStartOptions options;
+  options.max_concurrent_launches = 2;
+  options.stagger = std::chrono::steady_clock::duration::zero();
+  options.priority = {"e", "c", "unknown"};
+  scheduler.Start(MakeApps({"a", "b", "c", "d", "e"}), options);
+
+  // Only two launches should run at once, with the prioritised apps first.
+  EXPECT_TRUE(WaitFor([&] { return launched_count() == 2; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2U, launched_count());
+  EXPECT_EQ(5U, scheduler.PendingCount());
+
+  finish_one();
+  EXPECT_TRUE(WaitFor([&] { return launched_count() == 3; }));
+  finish_one();
+  EXPECT_TRUE(WaitFor([&] { return launched_count() == 4; }));
+  // "d" throws, so should be treated as finished straight away.
+  finish_one();
+  EXPECT_TRUE(WaitFor([&] { return launched_count() == 5; }));
+  EXPECT_TRUE(WaitFor([&] { return scheduler.PendingCount() == 1; }));
+  finish_one();
+  EXPECT_TRUE(WaitFor([&] { return scheduler.PendingCount() == 0; }));
+  EXPECT_EQ((std::vector<AppName>{"e", "c", "a", "b", "d"}), launched);
+  asio_service.Stop();
+}
+
+TEST(AutoStartSchedulerTest, BEH_StaggerAndCancel) {
+  AsioService asio_service(2);
+  std::mutex mutex;
+  std::vector<std::chrono::steady_clock::time_point> launch_times;
+  AutoStartScheduler scheduler{asio_service.service(),
+                               [&](const AppDetails&, std::function<void()> on_finished) {
+                                 std::lock_guard<std::mutex> lock{mutex};
+                                 launch_times.push_back(std::chrono::steady_clock::now());
+                                 on_finished();
+                               }};
+  AutoStartOptions options;
+  options.max_concurrent_launches = 10;
+  options.stagger = std::chrono::milliseconds(100);
+  scheduler.Start(MakeApps({"a", "b", "c"}), options);
+  EXPECT_TRUE(WaitFor([&] { return scheduler.PendingCount() == 0; }));
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    ASSERT_EQ(3U, launch_times.size());
+    // Allow for some jitter between a launch being started and 'launch' being invoked.
+    for (std::size_t i(1); i < launch_times.size(); ++i)
+      EXPECT_GE(launch_times[i] - launch_times[i - 1], options.stagger / 2);
+  }
+
+  // Cancelling should discard the apps still waiting to be launched.
+  options.stagger = std::chrono::seconds(1);
+  scheduler.Start(MakeApps({"d", "e", "f"}), options);
+  EXPECT_TRUE(WaitFor([&] { return scheduler.PendingCount() == 2; }));
+  scheduler.Cancel();
+  EXPECT_EQ(0U, scheduler.PendingCount());
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  std::lock_guard<std::mutex> lock{mutex};
+  EXPECT_EQ(4U, launch_times.size());
+  asio_service.Stop();
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,231 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Microbenchmarks for encrypting, decrypting and serialising accounts and the local config file,
+// including compacting and appending to the config journal with each codec.
+// Run with e.g. '--benchmark_out=launcher.json --benchmark_out_format=json' to record the results
+// as JSON (or just '--benchmark_format=json' to print them as JSON).
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/authentication/user_credential_utils.h"
+#include "maidsafe/common/data_types/immutable_data.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/launcher/account.h"
+#include "maidsafe/launcher/account_handler.h"
+#include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/app_handler.h"
+#include "maidsafe/launcher/config_journal.h"
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+namespace {
+
+// Generating keys is slow, so all accounts share a single passport.
+const passport::MaidAndSigner& GetMaidAndSigner() {
+  static const passport::MaidAndSigner maid_and_signer(passport::CreateMaidAndSigner());
+  return maid_and_signer;
+}
+
+std::unique_ptr<Account> MakeAccount(int app_count) {
+  std::unique_ptr<Account> account(new Account{GetMaidAndSigner()});
+  for (int i(0); i < app_count; ++i)
+    account->apps.Insert(CreateRandomAppDetails());
+  return account;
+}
+
+void BM_EncryptAccount(benchmark::State& state) {
+  const auto account(MakeAccount(static_cast<int>(state.range(0))));
+  const authentication::UserCredentials user_credentials(GetRandomUserCredentials());
+  std::int64_t bytes(0);
+  while (state.KeepRunning()) {
+    ImmutableData encrypted_account(EncryptAccount(user_credentials, *account));
+    bytes += static_cast<std::int64_t>(encrypted_account.Value().string().size());
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+// Decrypts with an already-derived secure password, to exclude the cost of deriving it.
+void BM_DecryptAccount(benchmark::State& state) {
+  const auto account(MakeAccount(static_cast<int>(state.range(0))));
+  const authentication::UserCredentials user_credentials(GetRandomUserCredentials());
+  const ImmutableData encrypted_account(EncryptAccount(user_credentials, *account));
+  const crypto::SecurePassword secure_password(
+      authentication::CreateSecurePassword(user_credentials));
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(Account(encrypted_account, user_credentials, secure_password));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(encrypted_account.Value().string().size()));
+}
+
+// Icons are held as separate chunks rather than in the account, so their size is benchmarked via
+// 'MakeIconChunk' rather than via the account functions.
+void BM_MakeIconChunk(benchmark::State& state) {
+  const SerialisedData icon(RandomBytes(static_cast<std::uint32_t>(state.range(0))));
+  const crypto::AES256KeyAndIV key_and_iv{
+      RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(MakeIconChunk(icon, key_and_iv));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_GetAccountLocation(benchmark::State& state) {
+  const authentication::UserCredentials user_credentials(GetRandomUserCredentials());
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(GetAccountLocation(*user_credentials.keyword, *user_credentials.pin));
+}
+
+// Holds an AppHandler with 'app_count' local apps and a compacted config file.
+struct ConfigFixture {
+  explicit ConfigFixture(int app_count)
+      : test_root(maidsafe::test::CreateTestPath("MaidSafe_BenchLauncher")),
+        account(MakeAccount(0)),
+        account_mutex(),
+        app_handler() {
+    app_handler.Initialise(*test_root / "config", account.get(), &account_mutex);
+    app_handler.BeginBatch();
+    for (int i(0); i < app_count; ++i) {
+      AppDetails app(CreateRandomAppDetails());
+      app_handler.AddOrLinkApp(app.name, app.path, app.args, &app.icon, app.auto_start);
+    }
+    app_handler.EndBatch(true);
+    // Applying a snapshot compacts the config file.
+    app_handler.ApplySnapshot(app_handler.GetSnapshot());
+  }
+
+  const maidsafe::test::TestPath test_root;
+  std::unique_ptr<Account> account;
+  std::mutex account_mutex;
+  AppHandler app_handler;
+};
+
+// Reverting to a snapshot rebuilds the account's apps and compacts the config file.
+void BM_ApplySnapshot(benchmark::State& state) {
+  ConfigFixture fixture(static_cast<int>(state.range(0)));
+  while (state.KeepRunning())
+    fixture.app_handler.ApplySnapshot(fixture.app_handler.GetSnapshot());
+}
+
+// Initialising an AppHandler reads the config file and merges its apps with the account's.
+void BM_InitialiseAppHandler(benchmark::State& state) {
+  ConfigFixture fixture(static_cast<int>(state.range(0)));
+  while (state.KeepRunning()) {
+    AppHandler app_handler;
+    app_handler.Initialise(*fixture.test_root / "config", fixture.account.get(),
+                           &fixture.account_mutex);
+  }
+}
+
+// Returns a record resembling a config journal 'kPut' record for an app.
+std::string MakeAppRecord(int index) {
+  const std::string id(std::to_string(index));
+  return "App " + id + " /usr/local/bin/maidsafe_app_" + id +
+         " --config /home/user/.config/MaidSafe/app_" + id + ".conf --verbose";
+}
+
+// Holds a ConfigJournal using the codec 'state.range(1)', and a record resembling a compacted
+// config file holding 'state.range(0)' apps.
+struct JournalFixture {
+  explicit JournalFixture(const benchmark::State& state)
+      : test_root(maidsafe::test::CreateTestPath("MaidSafe_BenchLauncher")),
+        journal(*test_root / "config",
+                crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)},
+                static_cast<ConfigJournal::Codec>(state.range(1))),
+        snapshot_record() {
+    for (int i(0); i < state.range(0); ++i)
+      snapshot_record += MakeAppRecord(i);
+  }
+
+  const maidsafe::test::TestPath test_root;
+  ConfigJournal journal;
+  std::string snapshot_record;
+};
+
+void BM_CompactConfigJournal(benchmark::State& state) {
+  JournalFixture fixture(state);
+  while (state.KeepRunning())
+    fixture.journal.Compact({fixture.snapshot_record});
+  state.SetLabel(std::to_string(boost::filesystem::file_size(*fixture.test_root / "config")) +
+                 " bytes");
+}
+
+void BM_AppendConfigJournal(benchmark::State& state) {
+  JournalFixture fixture(state);
+  fixture.journal.Compact({fixture.snapshot_record});
+  std::size_t index(0);
+  while (state.KeepRunning()) {
+    fixture.journal.Append(std::vector<std::string>{MakeAppRecord(static_cast<int>(index))});
+    // Keep the journal from growing without bound, as its owner would.
+    if (++index % ConfigJournal::kMaxRecords == 0) {
+      state.PauseTiming();
+      fixture.journal.Compact({fixture.snapshot_record});
+      state.ResumeTiming();
+    }
+  }
+}
+
+// Each pair of arguments is the number of apps and the codec.
+void ConfigJournalArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int app_count : {10, 100, 1000}) {
+    for (auto codec : {ConfigJournal::Codec::kNone, ConfigJournal::Codec::kFast,
+                       ConfigJournal::Codec::kMax}) {
+      benchmark->Args({app_count, static_cast<int>(codec)});
+    }
+  }
+}
+
+BENCHMARK(BM_EncryptAccount)->Arg(0)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DecryptAccount)->Arg(0)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MakeIconChunk)->Arg(1 << 10)->Arg(16 << 10)->Arg(256 << 10)->Arg(1 << 20);
+BENCHMARK(BM_GetAccountLocation);
+BENCHMARK(BM_ApplySnapshot)->Arg(0)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InitialiseAppHandler)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CompactConfigJournal)->Apply(ConfigJournalArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AppendConfigJournal)->Apply(ConfigJournalArgs)->Unit(benchmark::kMicrosecond);
+
+}  // unnamed namespace
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+BENCHMARK_MAIN();
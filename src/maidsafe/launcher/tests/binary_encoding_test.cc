@@ -0,0 +1,75 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/binary_encoding.h"
+
+#include <string>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(BinaryEncodingTest, BEH_RoundTrip) {
+  const std::string value(RandomString(1000));
+  std::string encoded;
+  AppendUint8(0xab, encoded);
+  AppendUint16(0xabcd, encoded);
+  AppendUint32(0x01234567, encoded);
+  AppendString(value, encoded);
+  AppendString("", encoded);
+  EXPECT_EQ(1U + 2U + 4U + 4U + value.size() + 4U, encoded.size());
+  // Integers should be little-endian.
+  EXPECT_EQ('\x67', encoded[3]);
+  EXPECT_EQ('\x01', encoded[6]);
+
+  BinaryReader reader{encoded};
+  EXPECT_EQ(0xab, reader.ReadUint8());
+  EXPECT_EQ(0xabcd, reader.ReadUint16());
+  EXPECT_EQ(0x01234567U, reader.ReadUint32());
+  EXPECT_EQ(value, reader.ReadString());
+  EXPECT_TRUE(reader.ReadString().empty());
+  EXPECT_EQ(0U, reader.Remaining());
+  EXPECT_EQ(encoded.size(), reader.Offset());
+}
+
+TEST(BinaryEncodingTest, BEH_Truncated) {
+  std::string encoded;
+  AppendString(RandomString(10), encoded);
+  for (std::size_t size(0); size < encoded.size(); ++size) {
+    const std::string truncated(encoded.substr(0, size));
+    BinaryReader reader{truncated};
+    EXPECT_TRUE(ThrowsAs([&] { reader.ReadString(); }, CommonErrors::parsing_error));
+  }
+  const std::string empty;
+  BinaryReader reader{empty};
+  EXPECT_TRUE(ThrowsAs([&] { reader.ReadUint8(); }, CommonErrors::parsing_error));
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,116 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/bootstrap_cache.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+namespace {
+
+asio::ip::udp::endpoint MakeEndpoint(std::uint16_t port) {
+  return asio::ip::udp::endpoint{asio::ip::make_address_v4("127.0.0.1"), port};
+}
+
+}  // unnamed namespace
+
+TEST(BootstrapCacheTest, BEH_Prioritise) {
+  maidsafe::test::TestPath test_root(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  BootstrapCache bootstrap_cache{*test_root / "bootstrap_cache"};
+  EXPECT_TRUE(bootstrap_cache.GetPrioritised(10).empty());
+
+  bootstrap_cache.RecordSuccess(MakeEndpoint(1), std::chrono::milliseconds(300));
+  bootstrap_cache.RecordSuccess(MakeEndpoint(2), std::chrono::milliseconds(100));
+  bootstrap_cache.RecordSuccess(MakeEndpoint(3), std::chrono::milliseconds(200));
+  // Failing should demote the fastest endpoint below all others.
+  bootstrap_cache.RecordFailure(MakeEndpoint(2));
+  // Failing an unknown endpoint should be a no-op.
+  bootstrap_cache.RecordFailure(MakeEndpoint(4));
+
+  std::vector<asio::ip::udp::endpoint> expected{MakeEndpoint(3), MakeEndpoint(1), MakeEndpoint(2)};
+  EXPECT_EQ(expected, bootstrap_cache.GetPrioritised(10));
+  expected.resize(2);
+  EXPECT_EQ(expected, bootstrap_cache.GetPrioritised(2));
+
+  // Succeeding again should reset the failure count.
+  bootstrap_cache.RecordSuccess(MakeEndpoint(2), std::chrono::milliseconds(100));
+  EXPECT_EQ(MakeEndpoint(2), bootstrap_cache.GetPrioritised(1).front());
+}
+
+TEST(BootstrapCacheTest, BEH_RecordJoinSuccess) {
+  maidsafe::test::TestPath test_root(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  BootstrapCache bootstrap_cache{*test_root / "bootstrap_cache"};
+
+  // A join via routing's default contacts should record the contacts routing reported, so that
+  // the next join has cached endpoints to race.
+  const std::vector<asio::ip::udp::endpoint> reported{MakeEndpoint(1), MakeEndpoint(2)};
+  bootstrap_cache.RecordJoinSuccess({}, reported, std::chrono::milliseconds(100));
+  EXPECT_EQ(reported, bootstrap_cache.GetPrioritised(10));
+
+  // A join via a cached endpoint should only record that endpoint.
+  bootstrap_cache.RecordFailure(MakeEndpoint(3));
+  bootstrap_cache.RecordJoinSuccess({MakeEndpoint(3)}, {MakeEndpoint(4)},
+                                    std::chrono::milliseconds(50));
+  const std::vector<asio::ip::udp::endpoint> expected{MakeEndpoint(3), MakeEndpoint(1),
+                                                      MakeEndpoint(2)};
+  EXPECT_EQ(expected, bootstrap_cache.GetPrioritised(10));
+}
+
+TEST(BootstrapCacheTest, BEH_SaveAndLoad) {
+  maidsafe::test::TestPath test_root(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  const fs::path file_path{*test_root / "bootstrap_cache"};
+  std::vector<asio::ip::udp::endpoint> expected;
+  {
+    BootstrapCache bootstrap_cache{file_path};
+    for (std::size_t i(0); i < BootstrapCache::kMaxEntries + 5; ++i) {
+      bootstrap_cache.RecordSuccess(MakeEndpoint(static_cast<std::uint16_t>(i + 1)),
+                                    std::chrono::milliseconds(i + 1));
+    }
+    expected = bootstrap_cache.GetPrioritised(BootstrapCache::kMaxEntries + 5);
+    ASSERT_NO_THROW(bootstrap_cache.Save());
+  }
+  // The slowest endpoints should have been dropped.
+  ASSERT_EQ(BootstrapCache::kMaxEntries, expected.size());
+  EXPECT_EQ(MakeEndpoint(1), expected.front());
+
+  BootstrapCache reloaded_cache{file_path};
+  EXPECT_EQ(expected, reloaded_cache.GetPrioritised(BootstrapCache::kMaxEntries));
+
+  // A corrupt file should be treated as an empty cache.
+  ASSERT_TRUE(WriteFile(file_path, RandomString(100)));
+  BootstrapCache corrupt_cache{file_path};
+  EXPECT_TRUE(corrupt_cache.GetPrioritised(10).empty());
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
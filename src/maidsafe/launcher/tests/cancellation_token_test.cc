@@ -0,0 +1,99 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/cancellation_token.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(CancellationTokenTest, BEH_Cancel) {
+  CancellationToken cancellation_token;
+  CancellationToken copy(cancellation_token);
+  EXPECT_FALSE(cancellation_token.IsCancelled());
+  EXPECT_NO_THROW(cancellation_token.ThrowIfCancelled());
+
+  int handler_count(0);
+  auto handler_id(cancellation_token.AddHandler([&] { ++handler_count; }));
+  auto removed_handler_id(cancellation_token.AddHandler([&] { ++handler_count; }));
+  cancellation_token.RemoveHandler(removed_handler_id);
+
+  // Cancelling a copy should cancel the original, and handlers should only be invoked once.
+  copy.Cancel();
+  copy.Cancel();
+  EXPECT_TRUE(cancellation_token.IsCancelled());
+  EXPECT_EQ(1, handler_count);
+  EXPECT_TRUE(ThrowsAs([&] { cancellation_token.ThrowIfCancelled(); },
+                       AsioErrors::operation_aborted));
+
+  // Adding a handler once cancelled should invoke it immediately.
+  cancellation_token.RemoveHandler(cancellation_token.AddHandler([&] { ++handler_count; }));
+  cancellation_token.RemoveHandler(handler_id);
+  EXPECT_EQ(2, handler_count);
+}
+
+TEST(CancellationTokenTest, BEH_WakeWaiter) {
+  CancellationToken cancellation_token;
+  std::mutex mutex;
+  std::condition_variable condition_variable;
+  auto handler_id(cancellation_token.AddHandler([&] {
+    std::lock_guard<std::mutex> lock{mutex};
+    condition_variable.notify_all();
+  }));
+  std::thread canceller([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    cancellation_token.Cancel();
+  });
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(condition_variable.wait_for(lock, std::chrono::seconds(10),
+                                            [&] { return cancellation_token.IsCancelled(); }));
+  }
+  canceller.join();
+  cancellation_token.RemoveHandler(handler_id);
+}
+
+TEST(CancellationTokenTest, BEH_ThrowIfCancelledOrExpired) {
+  CancellationToken cancellation_token;
+  const auto now(std::chrono::steady_clock::now());
+  EXPECT_NO_THROW(ThrowIfCancelledOrExpired(cancellation_token, now + std::chrono::minutes(1)));
+  EXPECT_TRUE(ThrowsAs([&] { ThrowIfCancelledOrExpired(cancellation_token, now); },
+                       AsioErrors::timed_out));
+  cancellation_token.Cancel();
+  EXPECT_TRUE(ThrowsAs(
+      [&] { ThrowIfCancelledOrExpired(cancellation_token, now + std::chrono::minutes(1)); },
+      AsioErrors::operation_aborted));
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,284 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/config_journal.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/convert.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/binary_encoding.h"
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+class ConfigJournalTest : public testing::Test {
+ protected:
+  ConfigJournalTest()
+      : test_root_(maidsafe::test::CreateTestPath("MaidSafe_TestConfigJournal")),
+        file_path_(*test_root_ / "config"),
+        key_and_iv_(RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)) {}
+
+  std::vector<std::string> MakeRecords(int count) {
+    std::vector<std::string> records;
+    for (int i(0); i < count; ++i)
+      records.push_back(RandomString((RandomUint32() % 100) + 1));
+    return records;
+  }
+
+  const maidsafe::test::TestPath test_root_;
+  const fs::path file_path_;
+  const crypto::AES256KeyAndIV key_and_iv_;
+};
+
+TEST_F(ConfigJournalTest, BEH_AppendCompactAndRecover) {
+  std::vector<std::string> records{MakeRecords(5)};
+  {
+    ConfigJournal journal{file_path_, key_and_iv_};
+    EXPECT_TRUE(journal.Recover().empty());
+    journal.Append(std::vector<std::string>(records.begin(), records.begin() + 2));
+    journal.Append(std::vector<std::string>(records.begin() + 2, records.end()));
+    EXPECT_EQ(records.size(), journal.RecordCount());
+  }
+  {
+    ConfigJournal journal{file_path_, key_and_iv_};
+    EXPECT_EQ(records, journal.Recover());
+    EXPECT_EQ(records.size(), journal.RecordCount());
+
+    // Compacting should replace all records and leave no temporary file behind.
+    records = MakeRecords(3);
+    journal.Compact(records);
+    EXPECT_EQ(records.size(), journal.RecordCount());
+    EXPECT_EQ(1, std::distance(fs::directory_iterator(*test_root_), fs::directory_iterator()));
+    const std::vector<std::string> appended{MakeRecords(2)};
+    journal.Append(appended);
+    records.insert(records.end(), appended.begin(), appended.end());
+  }
+  ConfigJournal journal{file_path_, key_and_iv_};
+  EXPECT_EQ(records, journal.Recover());
+  std::vector<std::string> streamed_records;
+  journal.Recover([&](std::string record) { streamed_records.push_back(std::move(record)); });
+  EXPECT_EQ(records, streamed_records);
+  EXPECT_EQ(records.size(), journal.RecordCount());
+
+  journal.Remove();
+  EXPECT_FALSE(fs::exists(file_path_));
+  EXPECT_EQ(0U, journal.RecordCount());
+  EXPECT_TRUE(journal.Recover().empty());
+}
+
+TEST_F(ConfigJournalTest, BEH_RecoverFromTornWrite) {
+  const std::vector<std::string> records{MakeRecords(3)};
+  ConfigJournal journal{file_path_, key_and_iv_};
+  journal.Append(records);
+  const auto committed_size(fs::file_size(file_path_));
+  journal.Append(MakeRecords(1));
+
+  // Simulate a crash part way through writing the last record by truncating the file at each
+  // possible point within it.  Only the earlier records should be recovered.
+  const std::string contents(ReadFile(file_path_).value());
+  for (auto size(committed_size); size < contents.size(); ++size) {
+    ASSERT_TRUE(WriteFile(file_path_, contents.substr(0, static_cast<std::size_t>(size))));
+    EXPECT_EQ(records, journal.Recover());
+    EXPECT_EQ(committed_size, fs::file_size(file_path_));
+  }
+
+  // Records appended after recovering should follow the recovered ones.
+  const std::vector<std::string> appended{MakeRecords(2)};
+  journal.Append(appended);
+  std::vector<std::string> expected(records);
+  expected.insert(expected.end(), appended.begin(), appended.end());
+  EXPECT_EQ(expected, journal.Recover());
+}
+
+TEST_F(ConfigJournalTest, BEH_VersionAndFeatures) {
+  const std::vector<std::string> records{MakeRecords(2)};
+  {
+    ConfigJournal journal{file_path_, key_and_iv_};
+    journal.Append(records);
+    EXPECT_EQ(ConfigJournal::kFormatVersion, journal.FileVersion());
+  }
+  const std::string contents(ReadFile(file_path_).value());
+  ASSERT_EQ("MSCJ", contents.substr(0, 4));
+  ConfigJournal journal{file_path_, key_and_iv_};
+  EXPECT_EQ(records, journal.Recover());
+
+  // A file with a newer version or unknown features should be rejected and left unmodified.
+  auto write_header([&](std::uint16_t version, std::uint32_t features) {
+    std::string modified_contents("MSCJ");
+    AppendUint16(version, modified_contents);
+    AppendUint32(features, modified_contents);
+    modified_contents += contents.substr(modified_contents.size());
+    ASSERT_TRUE(WriteFile(file_path_, modified_contents));
+  });
+  write_header(static_cast<std::uint16_t>(ConfigJournal::kFormatVersion + 1), 0);
+  EXPECT_TRUE(ThrowsAs([&] { journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(contents.size(), fs::file_size(file_path_));
+  write_header(ConfigJournal::kFormatVersion, ~ConfigJournal::kKnownFeatures);
+  EXPECT_TRUE(ThrowsAs([&] { journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(contents.size(), fs::file_size(file_path_));
+
+  // A file with a torn header holds no committed records.
+  for (std::size_t size(1); size <= 4 + 2 + 4; ++size) {
+    ASSERT_TRUE(WriteFile(file_path_, contents.substr(0, size)));
+    EXPECT_TRUE(journal.Recover().empty());
+    EXPECT_EQ(0U, fs::file_size(file_path_));
+  }
+  journal.Append(records);
+  EXPECT_EQ(records, journal.Recover());
+
+  // A file without a header which can't be decrypted as a legacy file should be rejected and left
+  // unmodified.
+  ASSERT_TRUE(WriteFile(file_path_, "Not a journal"));
+  EXPECT_TRUE(ThrowsAs([&] { journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(std::string("Not a journal").size(), fs::file_size(file_path_));
+}
+
+TEST_F(ConfigJournalTest, BEH_WrongKey) {
+  const std::vector<std::string> records{MakeRecords(3)};
+  {
+    ConfigJournal journal{file_path_, key_and_iv_};
+    journal.Append(records);
+  }
+  const auto file_size(fs::file_size(file_path_));
+
+  // Intact records which can't be decrypted aren't a torn write, so mustn't be discarded.
+  const crypto::AES256KeyAndIV other_key_and_iv{
+      RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+  ConfigJournal other_journal{file_path_, other_key_and_iv};
+  EXPECT_TRUE(ThrowsAs([&] { other_journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(file_size, fs::file_size(file_path_));
+
+  ConfigJournal journal{file_path_, key_and_iv_};
+  EXPECT_EQ(records, journal.Recover());
+}
+
+TEST_F(ConfigJournalTest, BEH_ReadLegacyFile) {
+  // Legacy files have no header, and hold a single record compressed and encrypted as a whole.
+  const std::string record{MakeRecords(1).front()};
+  const std::string contents(
+      crypto::SymmEncrypt(
+          crypto::Compress(crypto::UncompressedText(convert::ToByteVector(record)), 9).data,
+          key_and_iv_)->string());
+  ASSERT_TRUE(WriteFile(file_path_, contents));
+
+  ConfigJournal journal{file_path_, key_and_iv_};
+  std::vector<std::string> recovered;
+  journal.Recover([&](std::string recovered_record) {
+    EXPECT_EQ(ConfigJournal::kLegacyVersion, journal.FileVersion());
+    recovered.push_back(std::move(recovered_record));
+  });
+  EXPECT_EQ(std::vector<std::string>{record}, recovered);
+  EXPECT_EQ(ConfigJournal::kLegacyVersion, journal.FileVersion());
+  EXPECT_EQ(1U, journal.RecordCount());
+  EXPECT_EQ(contents.size(), fs::file_size(file_path_));
+
+  // A legacy file encrypted with a different key should be rejected and left unmodified.
+  const crypto::AES256KeyAndIV other_key_and_iv{
+      RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+  ConfigJournal other_journal{file_path_, other_key_and_iv};
+  EXPECT_TRUE(ThrowsAs([&] { other_journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(contents.size(), fs::file_size(file_path_));
+
+  // Compacting should convert the file to the current version.
+  journal.Compact({record});
+  EXPECT_EQ(ConfigJournal::kFormatVersion, journal.FileVersion());
+  EXPECT_EQ(std::vector<std::string>{record}, journal.Recover());
+  EXPECT_EQ(ConfigJournal::kFormatVersion, journal.FileVersion());
+}
+
+TEST_F(ConfigJournalTest, BEH_Codecs) {
+  for (auto codec : {ConfigJournal::Codec::kNone, ConfigJournal::Codec::kFast,
+                     ConfigJournal::Codec::kMax}) {
+    std::vector<std::string> records{MakeRecords(3)};
+    {
+      ConfigJournal journal{file_path_, key_and_iv_, codec};
+      journal.Append(records);
+      EXPECT_EQ(codec, journal.FileCodec());
+    }
+    // The file's own codec should be used to read it, regardless of the preferred codec.
+    ConfigJournal journal{file_path_, key_and_iv_, ConfigJournal::Codec::kNone};
+    EXPECT_EQ(records, journal.Recover());
+    EXPECT_EQ(codec, journal.FileCodec());
+    const std::vector<std::string> appended{MakeRecords(2)};
+    journal.Append(appended);
+    records.insert(records.end(), appended.begin(), appended.end());
+    EXPECT_EQ(records, journal.Recover());
+    EXPECT_EQ(codec, journal.FileCodec());
+
+    // Changing the codec should only take effect on compacting.
+    journal.SetCodec(ConfigJournal::Codec::kMax);
+    journal.Compact({records.front()});
+    EXPECT_EQ(ConfigJournal::Codec::kMax, journal.FileCodec());
+    EXPECT_EQ(std::vector<std::string>{records.front()}, journal.Recover());
+    journal.Remove();
+  }
+
+  // An unknown codec should be rejected without modifying the file.
+  ConfigJournal journal{file_path_, key_and_iv_};
+  journal.Append(MakeRecords(1));
+  std::string contents(ReadFile(file_path_).value());
+  contents[4 + 2 + 4] = static_cast<char>(0xff);
+  ASSERT_TRUE(WriteFile(file_path_, contents));
+  EXPECT_TRUE(ThrowsAs([&] { journal.Recover(); }, CommonErrors::parsing_error));
+  EXPECT_EQ(contents.size(), fs::file_size(file_path_));
+}
+
+TEST_F(ConfigJournalTest, BEH_ReadVersion1) {
+  // Version 1 files have no codec in their header and hold uncompressed records.
+  const std::vector<std::string> records{MakeRecords(3)};
+  {
+    ConfigJournal journal{file_path_, key_and_iv_, ConfigJournal::Codec::kNone};
+    journal.Append(records);
+  }
+  std::string contents("MSCJ");
+  AppendUint16(1, contents);
+  AppendUint32(0, contents);
+  contents += ReadFile(file_path_).value().substr(contents.size() + 1);
+  ASSERT_TRUE(WriteFile(file_path_, contents));
+
+  ConfigJournal journal{file_path_, key_and_iv_, ConfigJournal::Codec::kFast};
+  EXPECT_EQ(records, journal.Recover());
+  EXPECT_EQ(1U, journal.FileVersion());
+  EXPECT_EQ(ConfigJournal::Codec::kNone, journal.FileCodec());
+  journal.Compact({records.back()});
+  EXPECT_EQ(ConfigJournal::kFormatVersion, journal.FileVersion());
+  EXPECT_EQ(std::vector<std::string>{records.back()}, journal.Recover());
+  EXPECT_EQ(ConfigJournal::Codec::kFast, journal.FileCodec());
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
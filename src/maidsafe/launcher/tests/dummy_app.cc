@@ -16,61 +16,130 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+// A minimal app for the Launcher's tests and load harness.  It plays the app's part of the launch
+// handshake described at 'Launcher::LaunchApp', checking that the set of permitted directories it
+// receives can be parsed, then exits.
+
 #include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <future>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "asio/io_service_strand.hpp"
+#include "cereal/types/set.hpp"
 
+#include "maidsafe/directory_info.h"
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
-#include "maidsafe/common/utils.h"
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+
+namespace {
+
+// How long to wait for each of the Launcher's steps of the handshake.
+const std::chrono::seconds kStepTimeout(30);
+
+// Returns the value of the option "--<name>=<value>", or throws if it's missing or empty.
+std::string GetOption(int argc, char* argv[], const std::string& name) {
+  const std::string prefix("--" + name + "=");
+  for (int i(1); i < argc; ++i) {
+    if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0 && argv[i][prefix.size()])
+      return std::string(argv[i] + prefix.size());
+  }
+  BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+}
+
+// Connects to the Launcher at the port given by "--launcher_port", starts the connection with the
+// given handlers, then sends the token given by "--launcher_token" as the first message, which
+// identifies this launch to the Launcher.
+maidsafe::tcp::ConnectionPtr ConnectToLauncher(
+    asio::io_service::strand& strand, int argc, char* argv[],
+    std::function<void(maidsafe::tcp::Message)> on_message, std::function<void()> on_closed) {
+  const auto port(
+      static_cast<maidsafe::tcp::Port>(std::stoi(GetOption(argc, argv, "launcher_port"))));
+  const std::string token(GetOption(argc, argv, "launcher_token"));
+  maidsafe::tcp::ConnectionPtr connection(maidsafe::tcp::Connection::MakeShared(strand, port));
+  connection->Start(std::move(on_message), std::move(on_closed));
+  connection->Send(maidsafe::tcp::Message(token.begin(), token.end()));
+  return connection;
+}
+
+}  // unnamed namespace
 
 int main(int argc, char* argv[]) {
-  bool connected_to_launcher{false}, should_hang{false};
+  bool connected_to_launcher{false};
   int exit_code{0};
   try {
-    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
-    if (unuseds.size() != 2U)
-      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
-    // uint16_t port{static_cast<uint16_t>(std::stoi(std::string{&unuseds[1][0]}))};
-    // maidsafe::launcher::ClientInterface client_interface{port};
-    // connected_to_launcher = true;
-
-    //  std::future<void> worker;
-    //  VaultConfig config{ vault_interface.GetConfiguration() };
-    //  switch (config.test_config.test_type) {
-    //  case VaultConfig::TestType::kNone:
-    //    break;
-    //  case VaultConfig::TestType::kKillConnection:
-    //    worker = std::async(std::launch::async, [&] { vault_interface.KillConnection(); });
-    //    break;
-    //  case VaultConfig::TestType::kSendInvalidMessage:
-    //    worker = std::async(std::launch::async, [&] { vault_interface.SendInvalidMessage(); });
-    //    break;
-    //  case VaultConfig::TestType::kStopProcess:
-    //    worker = std::async(std::launch::async, [&] { vault_interface.StopProcess(); });
-    //    break;
-    //  case VaultConfig::TestType::kIgnoreStopRequest:
-    //    should_hang = true;
-    //    break;
-    //  default:
-    //    BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
-    //  }
-    //  exit_code = vault_interface.WaitForExit();
-    //  worker.get();
+    maidsafe::log::Logging::Instance().Initialise(argc, argv);
+    // The state used by the handlers is declared before the service, and the service is stopped on
+    // every way out of this scope, so no handler can outlive it.
+    std::promise<std::set<maidsafe::DirectoryInfo>> permitted_dirs;
+    std::promise<void> closed;
+    bool dirs_received{false}, connection_closed{false};
+    maidsafe::AsioService asio_service(1);
+    asio::io_service::strand strand(asio_service.service());
+    maidsafe::tcp::ConnectionPtr connection;
+    maidsafe::on_scope_exit stop_service{[&] { asio_service.Stop(); }};
+    // The only message expected is the set of permitted dirs (step 2 of the handshake described
+    // at 'AppHandshake'), and replying to it confirms receipt (step 3), after which the Launcher
+    // closes the connection.  Nothing is received until the key is sent below.
+    connection = ConnectToLauncher(
+        strand, argc, argv,
+        [&](maidsafe::tcp::Message message) {
+          if (dirs_received)
+            return;
+          dirs_received = true;
+          try {
+            permitted_dirs.set_value(maidsafe::Parse<std::set<maidsafe::DirectoryInfo>>(message));
+            connection->Send(maidsafe::tcp::Message(1, 1));
+          } catch (const std::exception&) {
+            permitted_dirs.set_exception(std::current_exception());
+          }
+        },
+        [&] {
+          if (connection_closed)
+            return;
+          connection_closed = true;
+          if (!dirs_received) {
+            dirs_received = true;
+            permitted_dirs.set_exception(std::make_exception_ptr(
+                maidsafe::MakeError(maidsafe::CommonErrors::unable_to_handle_request)));
+          }
+          closed.set_value();
+        });
+    connected_to_launcher = true;
+
+    // Step 1: send the session public key.
+    const std::string encoded_key(
+        maidsafe::asymm::EncodeKey(maidsafe::asymm::GenerateKeyPair().public_key).string());
+    connection->Send(maidsafe::tcp::Message(encoded_key.begin(), encoded_key.end()));
+
+    auto dirs_future(permitted_dirs.get_future());
+    if (dirs_future.wait_for(kStepTimeout) != std::future_status::ready)
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::unable_to_handle_request));
+    LOG(kInfo) << "Permitted to access " << dirs_future.get().size() << " directories.";
+    if (closed.get_future().wait_for(kStepTimeout) != std::future_status::ready)
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::unable_to_handle_request));
   } catch (const maidsafe::maidsafe_error& error) {
     if (connected_to_launcher)
       LOG(kError) << error.what();
     else
-      LOG(kError) << "This is only designed to be invoked by VaultManager.";
+      LOG(kError) << "This is only designed to be invoked by the Launcher.";
     exit_code = maidsafe::ErrorToInt(error);
   } catch (const std::exception& e) {
     if (connected_to_launcher)
       LOG(kError) << e.what();
     else
-      LOG(kError) << "This is only designed to be invoked by VaultManager.";
+      LOG(kError) << "This is only designed to be invoked by the Launcher.";
     exit_code = maidsafe::ErrorToInt(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
   }
-  if (should_hang)
-    maidsafe::Sleep(std::chrono::hours(6));
   return exit_code;
 }
@@ -0,0 +1,150 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(ExecutorTest, BEH_ThreadCount) {
+  {
+    Executor executor;
+    EXPECT_GE(executor.ThreadCount(),
+              static_cast<std::size_t>(std::thread::hardware_concurrency()));
+    EXPECT_EQ(ExecutorOptions().blocking_thread_count, executor.BlockingThreadCount());
+  }
+
+  ExecutorOptions options;
+  options.thread_count = 3;
+  options.blocking_thread_count = 2;
+  options.thread_name = "test";
+  options.pin_threads = true;
+  Executor executor{options};
+  EXPECT_EQ(3U, executor.ThreadCount());
+  EXPECT_EQ(2U, executor.BlockingThreadCount());
+
+  // Block all the threads at once to check they're all running the io_service.
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::set<std::thread::id> thread_ids;
+  std::atomic<int> timed_out_count(0);
+  for (int i(0); i < 3; ++i) {
+    executor.service().post([&] {
+      std::unique_lock<std::mutex> lock{mutex};
+      thread_ids.insert(std::this_thread::get_id());
+      condition.notify_all();
+      if (!condition.wait_for(lock, std::chrono::seconds(5),
+                              [&] { return thread_ids.size() == 3U; })) {
+        ++timed_out_count;
+      }
+    });
+  }
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds(10),
+                                   [&] { return thread_ids.size() == 3U; }));
+  }
+  executor.Stop();
+  EXPECT_EQ(0, timed_out_count);
+
+  EXPECT_EQ(Executor::Shared(), Executor::Shared());
+}
+
+TEST(ExecutorTest, BEH_BlockingService) {
+  ExecutorOptions options;
+  options.thread_count = 1;
+  options.blocking_thread_count = 1;
+  Executor executor{options};
+
+  // A task blocking every blocking thread shouldn't delay tasks on the main service.
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future());
+  executor.blocking_service().post([released] { released.wait(); });
+  std::promise<void> ran;
+  executor.service().post([&] { ran.set_value(); });
+  EXPECT_EQ(std::future_status::ready, ran.get_future().wait_for(std::chrono::seconds(10)));
+  release.set_value();
+  executor.Stop();
+}
+
+TEST(ExecutorTest, BEH_LifetimeGuard) {
+  Executor executor;
+  std::atomic<int> run_count(0);
+
+  // A handler run after 'Close' should do nothing.
+  {
+    auto guard(std::make_shared<LifetimeGuard>());
+    auto handler(guard->Wrap([&] { ++run_count; }));
+    handler();
+    EXPECT_EQ(1, run_count);
+    guard->Close();
+    handler();
+    EXPECT_EQ(1, run_count);
+  }
+
+  // 'Close' should wait for a running handler to return.
+  {
+    LifetimeGuard guard;
+    std::promise<void> started, finish;
+    auto finish_future(finish.get_future().share());
+    executor.service().post(guard.Wrap([&, finish_future] {
+      started.set_value();
+      finish_future.wait();
+      ++run_count;
+    }));
+    started.get_future().wait();
+    auto closed(std::async(std::launch::async, [&] { guard.Close(); }));
+    EXPECT_EQ(std::future_status::timeout, closed.wait_for(std::chrono::milliseconds(100)));
+    finish.set_value();
+    closed.get();
+    EXPECT_EQ(2, run_count);
+  }
+
+  // 'Close' from inside a wrapped handler shouldn't wait for that handler.
+  {
+    auto guard(std::make_shared<LifetimeGuard>());
+    std::promise<void> done;
+    executor.service().post(guard->Wrap([&] {
+      guard->Close();
+      ++run_count;
+      done.set_value();
+    }));
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    EXPECT_EQ(3, run_count);
+  }
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
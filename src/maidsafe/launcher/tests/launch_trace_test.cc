@@ -0,0 +1,148 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/launch_trace.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(LaunchTraceTest, BEH_Trace) {
+  LaunchTrace trace{"App"};
+  EXPECT_EQ(LaunchTrace::Outcome::kInProgress, trace.GetOutcome());
+  EXPECT_EQ(std::chrono::steady_clock::duration(0), trace.Duration());
+  for (auto phase : {LaunchPhase::kSpawn, LaunchPhase::kConnect, LaunchPhase::kSessionKey}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    trace.BeginPhase(phase);
+  }
+  EXPECT_TRUE(trace.Finish(LaunchTrace::Outcome::kTimedOut));
+  EXPECT_FALSE(trace.Finish(LaunchTrace::Outcome::kSucceeded));
+  trace.BeginPhase(LaunchPhase::kConfirmation);
+  EXPECT_EQ(LaunchTrace::Outcome::kTimedOut, trace.GetOutcome());
+
+  // The spans should be consecutive, and the failed phase should be the last.
+  const std::vector<LaunchTrace::Span>& spans(trace.Spans());
+  ASSERT_EQ(4U, spans.size());
+  EXPECT_EQ(LaunchPhase::kListen, spans.front().phase);
+  EXPECT_EQ(LaunchPhase::kSessionKey, spans.back().phase);
+  for (std::size_t i(1); i < spans.size(); ++i) {
+    EXPECT_EQ(spans[i - 1].end, spans[i].begin);
+    EXPECT_LE(spans[i].begin, spans[i].end);
+  }
+  EXPECT_EQ(spans.back().end - spans.front().begin, trace.Duration());
+  EXPECT_GE(trace.Duration(), std::chrono::milliseconds(3));
+}
+
+TEST(LaunchTraceTest, BEH_Histogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0U, histogram.Count());
+  EXPECT_EQ(std::chrono::microseconds(0), histogram.Percentile(50));
+
+  for (int i(1); i <= 1000; ++i)
+    histogram.Add(std::chrono::microseconds(i * 100));
+  EXPECT_EQ(1000U, histogram.Count());
+  EXPECT_EQ(std::chrono::microseconds(100000), histogram.Max());
+  // Each percentile should be no less than the true value, and less than 20% above it.
+  for (auto percentile_and_value : {std::make_pair(50.0, 50000), std::make_pair(95.0, 95000),
+                                    std::make_pair(99.0, 99000), std::make_pair(100.0, 100000)}) {
+    const auto value(histogram.Percentile(percentile_and_value.first).count());
+    EXPECT_GE(value, percentile_and_value.second);
+    EXPECT_LT(value, percentile_and_value.second * 1.2);
+  }
+  EXPECT_LE(histogram.Percentile(100), histogram.Max());
+
+  // Very long latencies should be held in the last bucket.
+  histogram.Add(std::chrono::hours(5));
+  EXPECT_EQ(std::chrono::microseconds(std::chrono::hours(5)), histogram.Max());
+  EXPECT_EQ(histogram.Max(), histogram.Percentile(100));
+}
+
+TEST(LaunchTraceTest, BEH_Stats) {
+  const maidsafe::test::TestPath test_root(maidsafe::test::CreateTestPath("MaidSafe_TestLaunch"));
+  LaunchStats stats;
+  EXPECT_TRUE(stats.GetAppStats().empty());
+
+  auto make_trace([](const AppName& app_name, LaunchPhase last_phase,
+                     LaunchTrace::Outcome outcome) {
+    LaunchTrace trace{app_name};
+    for (auto phase(LaunchPhase::kSpawn); phase <= last_phase;
+         phase = static_cast<LaunchPhase>(static_cast<int>(phase) + 1)) {
+      trace.BeginPhase(phase);
+    }
+    trace.Finish(outcome);
+    return trace;
+  });
+  for (int i(0); i < 3; ++i) {
+    stats.Record(
+        make_trace("App \"0\"", LaunchPhase::kConfirmation, LaunchTrace::Outcome::kSucceeded));
+  }
+  stats.Record(make_trace("App \"0\"", LaunchPhase::kConnect, LaunchTrace::Outcome::kTimedOut));
+  stats.Record(make_trace("App 1", LaunchPhase::kSessionKey, LaunchTrace::Outcome::kFailed));
+
+  const auto app_stats(stats.GetAppStats());
+  ASSERT_EQ(2U, app_stats.size());
+  const LaunchStats::AppStats& app0(app_stats.at("App \"0\""));
+  EXPECT_EQ(3U, app0.succeeded);
+  EXPECT_EQ(1U, app0.timed_out);
+  EXPECT_EQ(0U, app0.failed);
+  EXPECT_EQ(3U, app0.total.count);
+  ASSERT_EQ(kLaunchPhaseCount, app0.phases.size());
+  // The timed out phase shouldn't be counted.
+  EXPECT_EQ(4U, app0.phases.at(LaunchPhase::kSpawn).count);
+  EXPECT_EQ(3U, app0.phases.at(LaunchPhase::kConnect).count);
+  EXPECT_EQ(3U, app0.phases.at(LaunchPhase::kConfirmation).count);
+
+  const LaunchStats::AppStats& app1(app_stats.at("App 1"));
+  EXPECT_EQ(1U, app1.failed);
+  EXPECT_EQ(0U, app1.total.count);
+  EXPECT_EQ(3U, app1.phases.size());
+  EXPECT_EQ(0U, app1.phases.count(LaunchPhase::kSessionKey));
+
+  // Only the most recent traces should be kept.
+  EXPECT_EQ(5U, stats.GetRecentTraces().size());
+  for (std::size_t i(0); i < LaunchStats::kMaxRecentTraces; ++i)
+    stats.Record(make_trace("App 2", LaunchPhase::kListen, LaunchTrace::Outcome::kFailed));
+  const std::vector<LaunchTrace> recent_traces(stats.GetRecentTraces());
+  EXPECT_EQ(LaunchStats::kMaxRecentTraces, recent_traces.size());
+  EXPECT_EQ("App 2", recent_traces.front().GetAppName());
+
+  const boost::filesystem::path file_path(*test_root / "launch_stats.json");
+  stats.WriteToFile(file_path);
+  const std::string contents(ReadFile(file_path).value());
+  EXPECT_NE(std::string::npos, contents.find("\"name\": \"App \\\"0\\\"\""));
+  EXPECT_NE(std::string::npos, contents.find("\"session_key\": {\"count\": 3"));
+  EXPECT_NE(std::string::npos, contents.find("\"outcome\": \"failed\""));
+  EXPECT_TRUE(ThrowsAs([&] { stats.WriteToFile(*test_root / "no_such_dir" / "file"); },
+                       CommonErrors::filesystem_io_error));
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -22,11 +22,18 @@
 extern "C" char** environ;
 #endif
 
+#include <atomic>
 #include <future>
+#include <map>
 #include <memory>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include "maidsafe/common/authentication/user_credentials.h"
 #include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
 
 #include "maidsafe/launcher/account.h"
 #include "maidsafe/launcher/account_getter.h"
@@ -107,6 +114,196 @@ TEST_F(LauncherTest, NETWORK_InvalidLogin) {
   }, VaultErrors::no_such_account));
 }
 
+TEST_F(LauncherTest, NETWORK_AppIcons) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  std::set<AppName> app_names;
+  std::map<AppName, SerialisedData> icons;
+  {
+    auto launcher(Launcher::CreateAccount(std::get<0>(user_credentials_tuple),
+                                          std::get<1>(user_credentials_tuple),
+                                          std::get<2>(user_credentials_tuple)));
+    for (int i(0); i != 5; ++i) {
+      AppDetails app{CreateRandomAppDetails()};
+      ASSERT_NO_THROW(launcher->AddApp(app.name, app.path, app.args, app.icon, app.auto_start));
+      app_names.insert(app.name);
+      icons.emplace(app.name, app.icon);
+    }
+    launcher->LogoutAndStop();
+  }
+
+  auto launcher(Launcher::Login(std::get<0>(user_credentials_tuple),
+                                std::get<1>(user_credentials_tuple),
+                                std::get<2>(user_credentials_tuple)));
+  // Icons shouldn't have been retrieved by logging in.
+  for (const auto& app : launcher->GetApps(true)) {
+    EXPECT_TRUE(app.icon.empty());
+    EXPECT_TRUE(app.icon_id.IsInitialised());
+  }
+  std::map<AppName, SerialisedData> retrieved_icons;
+  ASSERT_NO_THROW(retrieved_icons = launcher->GetAppIcons(app_names));
+  EXPECT_EQ(icons, retrieved_icons);
+  // Retrieving again should be satisfied from the cache.
+  EXPECT_EQ(icons, launcher->GetAppIcons(app_names));
+  EXPECT_THROW(launcher->GetAppIcons(std::set<AppName>{RandomAlphaNumericString(10)}),
+               common_error);
+  launcher->LogoutAndStop();
+
+  // As above, but retrieving asynchronously from a fresh session, i.e. with nothing cached.
+  launcher = Launcher::Login(std::get<0>(user_credentials_tuple),
+                             std::get<1>(user_credentials_tuple),
+                             std::get<2>(user_credentials_tuple));
+  std::atomic<bool> ready{false};
+  auto icons_future(launcher->GetAppIconsAsync(app_names, [&] { ready = true; }));
+  ASSERT_NO_THROW(retrieved_icons = icons_future.get());
+  EXPECT_EQ(icons, retrieved_icons);
+  while (!ready)
+    std::this_thread::yield();
+  EXPECT_EQ(icons, launcher->GetAppIconsAsync(app_names).get());
+  auto invalid_future(
+      launcher->GetAppIconsAsync(std::set<AppName>{RandomAlphaNumericString(10)}));
+  EXPECT_TRUE(ThrowsAs([&] { invalid_future.get(); }, CommonErrors::no_such_element));
+  launcher->LogoutAndStop();
+}
+
+TEST_F(LauncherTest, NETWORK_ConcurrentSessions) {
+  // Concurrent sessions of different accounts each have their own config file, so neither sees the
+  // other's local apps, and logging in to one isn't prevented by the other's config.
+  std::vector<decltype(GetRandomUserCredentialsTuple())> credentials;
+  std::vector<std::unique_ptr<Launcher>> launchers;
+  std::vector<AppName> app_names;
+  for (int i(0); i != 2; ++i) {
+    credentials.push_back(GetRandomUserCredentialsTuple());
+    launchers.push_back(Launcher::CreateAccount(std::get<0>(credentials.back()),
+                                                std::get<1>(credentials.back()),
+                                                std::get<2>(credentials.back())));
+  }
+  for (auto& launcher : launchers) {
+    AppDetails app{CreateRandomAppDetails()};
+    ASSERT_NO_THROW(launcher->AddApp(app.name, app.path, app.args, app.icon, app.auto_start));
+    app_names.push_back(app.name);
+  }
+  for (auto& launcher : launchers)
+    launcher->LogoutAndStop();
+
+  for (std::size_t i(0); i != credentials.size(); ++i) {
+    ASSERT_NO_THROW(launchers[i] = Launcher::Login(std::get<0>(credentials[i]),
+                                                   std::get<1>(credentials[i]),
+                                                   std::get<2>(credentials[i])));
+  }
+  for (std::size_t i(0); i != launchers.size(); ++i) {
+    const std::set<AppDetails> apps(launchers[i]->GetApps(true));
+    ASSERT_EQ(1U, apps.size());
+    EXPECT_EQ(app_names[i], apps.begin()->name);
+  }
+  for (auto& launcher : launchers)
+    launcher->LogoutAndStop();
+}
+
+TEST_F(LauncherTest, NETWORK_AsyncApi) {
+  const int kCount{3};
+  std::vector<std::tuple<Keyword, Pin, Password>> user_credentials_tuples;
+  std::vector<std::future<std::unique_ptr<Launcher>>> create_futures;
+  std::atomic<int> ready_count{0};
+  for (int i(0); i != kCount; ++i) {
+    user_credentials_tuples.push_back(GetRandomUserCredentialsTuple());
+    create_futures.push_back(Launcher::CreateAccountAsync(
+        std::get<0>(user_credentials_tuples.back()), std::get<1>(user_credentials_tuples.back()),
+        std::get<2>(user_credentials_tuples.back()), [&] { ++ready_count; }));
+  }
+
+  std::vector<std::unique_ptr<Launcher>> launchers;
+  for (auto& create_future : create_futures) {
+    ASSERT_NO_THROW(launchers.push_back(create_future.get()));
+    AppDetails app{CreateRandomAppDetails()};
+    ASSERT_NO_THROW(launchers.back()->AddApp(app.name, app.path, app.args, app.icon, false));
+  }
+  // 'on_ready' is invoked just after each future has been made ready.
+  while (ready_count != kCount)
+    std::this_thread::yield();
+
+  std::vector<std::future<void>> save_futures;
+  for (auto& launcher : launchers)
+    save_futures.push_back(launcher->SaveSessionAsync());
+  for (auto& save_future : save_futures)
+    EXPECT_NO_THROW(save_future.get());
+  launchers.clear();
+
+  std::vector<std::future<std::unique_ptr<Launcher>>> login_futures;
+  for (const auto& user_credentials_tuple : user_credentials_tuples) {
+    login_futures.push_back(Launcher::LoginAsync(std::get<0>(user_credentials_tuple),
+                                                 std::get<1>(user_credentials_tuple),
+                                                 std::get<2>(user_credentials_tuple)));
+  }
+  for (auto& login_future : login_futures) {
+    std::unique_ptr<Launcher> launcher;
+    ASSERT_NO_THROW(launcher = login_future.get());
+    EXPECT_EQ(1U, launcher->GetApps(true).size());
+    launcher->LogoutAndStop();
+  }
+
+  // Errors should be reported via the future.
+  auto invalid_login(Launcher::LoginAsync(std::get<0>(GetRandomUserCredentialsTuple()),
+                                          std::get<1>(GetRandomUserCredentialsTuple()),
+                                          std::get<2>(GetRandomUserCredentialsTuple())));
+  EXPECT_TRUE(ThrowsAs([&] { invalid_login.get(); }, VaultErrors::no_such_account));
+}
+
+TEST_F(LauncherTest, NETWORK_CancelLoginAndCreateAccount) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  CancellationToken cancellation_token;
+  cancellation_token.Cancel();
+  EXPECT_TRUE(ThrowsAs([&] {
+    Launcher::CreateAccount(std::get<0>(user_credentials_tuple),
+                            std::get<1>(user_credentials_tuple),
+                            std::get<2>(user_credentials_tuple), cancellation_token);
+  }, AsioErrors::operation_aborted));
+
+  // The cancelled creation shouldn't have put the account, so creating it now should succeed.
+  Launcher::CreateAccount(std::get<0>(user_credentials_tuple), std::get<1>(user_credentials_tuple),
+                          std::get<2>(user_credentials_tuple))->LogoutAndStop();
+
+  auto login_future(Launcher::LoginAsync(std::get<0>(user_credentials_tuple),
+                                         std::get<1>(user_credentials_tuple),
+                                         std::get<2>(user_credentials_tuple), nullptr,
+                                         cancellation_token));
+  EXPECT_TRUE(ThrowsAs([&] { login_future.get(); }, AsioErrors::operation_aborted));
+  Launcher::CancelPrepareForLogin();
+}
+
+TEST_F(LauncherTest, NETWORK_ApplyChanges) {
+  auto user_credentials_tuple(GetRandomUserCredentialsTuple());
+  auto launcher(Launcher::CreateAccount(std::get<0>(user_credentials_tuple),
+                                        std::get<1>(user_credentials_tuple),
+                                        std::get<2>(user_credentials_tuple)));
+  std::vector<AppChange> changes;
+  std::set<AppName> app_names;
+  for (int i(0); i != 20; ++i) {
+    AppDetails app{CreateRandomAppDetails()};
+    changes.push_back(AppChange::AddApp(app.name, app.path, app.args, app.icon, false));
+    changes.push_back(AppChange::UpdateAppAutoStart(app.name, true));
+    app_names.insert(app.name);
+  }
+  ASSERT_NO_THROW(launcher->ApplyChanges(changes));
+  auto apps(launcher->GetApps(true));
+  ASSERT_EQ(app_names.size(), apps.size());
+  for (const auto& app : apps) {
+    EXPECT_EQ(1U, app_names.count(app.name));
+    EXPECT_TRUE(app.auto_start);
+  }
+
+  // If any change fails, none should be applied.
+  changes.clear();
+  changes.push_back(AppChange::RemoveAppLocally(*app_names.begin()));
+  changes.push_back(AppChange::UpdateAppName(*app_names.rbegin(), RandomAlphaNumericString(10)));
+  changes.push_back(AppChange::RemoveAppLocally(RandomAlphaNumericString(10)));
+  EXPECT_TRUE(ThrowsAs([&] { launcher->ApplyChanges(changes); }, CommonErrors::no_such_element));
+  EXPECT_TRUE(Equals(apps, launcher->GetApps(true)));
+
+  // Reverting should undo the whole batch.
+  launcher->RevertToLastSavedSession();
+  EXPECT_TRUE(launcher->GetApps(true).empty());
+  launcher->LogoutAndStop();
+}
 
 // TODO(Team)  move to nfs
 // TEST(ClientTest, FUNC_Constructor) {
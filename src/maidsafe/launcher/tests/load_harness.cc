@@ -0,0 +1,430 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// A load harness which runs many concurrent Launcher sessions against the fake store, and reports
+// the throughput and latency percentiles of each operation.  Run e.g.
+//
+//   load_harness --sessions=16 --operations=200 --launches=20 --output=load.json
+//
+// All sessions run concurrently in this process, each on its own thread with its own account, and
+// share a single fake store; each account has its own local config file.  A session creates an
+// account, logs in to it, applies '--operations' randomly-chosen add, update, remove and save
+// operations, then launches 'dummy_app' '--launches' times and logs out.  All the sessions are
+// started at once so that these phases overlap across sessions.  The throughput of an operation is
+// its count divided by the time from its first start to its last finish across all sessions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "boost/exception/diagnostic_information.hpp"
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/launcher/app_details.h"
+#include "maidsafe/launcher/json.h"
+#include "maidsafe/launcher/launch_trace.h"
+#include "maidsafe/launcher/launcher.h"
+#include "maidsafe/launcher/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Options = std::map<std::string, std::string>;
+
+const char* const kUsage =
+    "Usage: load_harness [--sessions=N] [--operations=N] [--launches=N] [--dummy_app=PATH] "
+    "[--output=PATH]\n"
+    "  --sessions    concurrent sessions, each with its own account (default 4)\n"
+    "  --operations  random add, update, remove and save operations per session (default 100)\n"
+    "  --launches    launches of dummy_app per session (default 10)\n"
+    "  --dummy_app   path to dummy_app (default is alongside this executable)\n"
+    "  --output      file to write the results to as JSON\n";
+
+// Parses arguments of the form "--name=value", or "--name" which is given an empty value.
+Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i(1); i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg.compare(0, 2, "--") != 0)
+      continue;
+    const auto equals(arg.find('='));
+    options[arg.substr(2, equals - 2)] =
+        (equals == std::string::npos ? std::string() : arg.substr(equals + 1));
+  }
+  return options;
+}
+
+int GetCount(const Options& options, const std::string& name, int default_value) {
+  const auto itr(options.find(name));
+  if (itr == options.end())
+    return default_value;
+  const int value(std::stoi(itr->second));
+  if (value < 0) {
+    LOG(kError) << "--" << name << " can't be negative.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  return value;
+}
+
+fs::path GetPath(const Options& options, const std::string& name) {
+  const auto itr(options.find(name));
+  return itr == options.end() ? fs::path() : fs::path(itr->second);
+}
+
+std::int64_t ToMicroseconds(Clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+struct OperationResults {
+  OperationResults()
+      : latencies(),
+        errors(0),
+        first_begin_us(std::numeric_limits<std::int64_t>::max()),
+        last_end_us(std::numeric_limits<std::int64_t>::min()) {}
+
+  // Successful operations only.
+  LatencyHistogram latencies;
+  std::uint64_t errors;
+  std::int64_t first_begin_us, last_end_us;
+
+  double Throughput() const {
+    const auto elapsed_us(last_end_us - first_begin_us);
+    return elapsed_us <= 0 ? 0.0 : static_cast<double>(latencies.Count() + errors) * 1000000.0 /
+                                       static_cast<double>(elapsed_us);
+  }
+};
+
+// Collects the outcome and timing of each operation run by all the sessions.  Threadsafe.
+class Results {
+ public:
+  Results() : mutex_(), results_() {}
+
+  void Record(const std::string& operation, bool succeeded, Clock::time_point begin,
+              Clock::time_point end) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    OperationResults& operation_results(results_[operation]);
+    if (succeeded) {
+      operation_results.latencies.Add(
+          std::chrono::duration_cast<std::chrono::microseconds>(end - begin));
+    } else {
+      ++operation_results.errors;
+    }
+    operation_results.first_begin_us =
+        std::min(operation_results.first_begin_us, ToMicroseconds(begin));
+    operation_results.last_end_us = std::max(operation_results.last_end_us, ToMicroseconds(end));
+  }
+
+  // Runs 'operation', recording its timing and whether it threw.  Returns false if it threw.
+  bool Time(const std::string& name, const std::function<void()>& operation) {
+    const auto begin(Clock::now());
+    bool succeeded{true};
+    try {
+      operation();
+    } catch (const std::exception& e) {
+      LOG(kWarning) << name << " failed: " << boost::diagnostic_information(e);
+      succeeded = false;
+    }
+    Record(name, succeeded, begin, Clock::now());
+    return succeeded;
+  }
+
+  std::map<std::string, OperationResults> Get() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return results_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, OperationResults> results_;
+};
+
+// Applies a randomly-chosen operation, keeping 'app_names' up to date with the local apps.  Apps
+// are added more often than they're removed, so the number of apps grows as the session goes on.
+void ApplyRandomOperation(Launcher& launcher, std::vector<AppName>& app_names,
+                          Results& results) {
+  const auto choice(RandomUint32() % 20);
+  if (app_names.empty() || choice < 5) {
+    const AppDetails app(CreateRandomAppDetails());
+    if (results.Time("add_app", [&] {
+          launcher.AddApp(app.name, app.path, app.args, app.icon, app.auto_start);
+        })) {
+      app_names.push_back(app.name);
+    }
+    return;
+  }
+
+  const std::size_t index(RandomUint32() % app_names.size());
+  const AppName app_name(app_names[index]);
+  switch (choice) {
+    case 5:
+    case 6: {
+      const AppName new_name(RandomAlphaNumericString(27, 40));
+      if (results.Time("update_app_name", [&] { launcher.UpdateAppName(app_name, new_name); }))
+        app_names[index] = new_name;
+      break;
+    }
+    case 7:
+    case 8: {
+      const fs::path new_path(RandomAlphaNumericString(27, 255));
+      results.Time("update_app_path", [&] { launcher.UpdateAppPath(app_name, new_path); });
+      break;
+    }
+    case 9:
+    case 10: {
+      const AppArgs new_args(RandomAlphaNumericString(27, 100));
+      results.Time("update_app_args", [&] { launcher.UpdateAppArgs(app_name, new_args); });
+      break;
+    }
+    case 11:
+    case 12: {
+      const SerialisedData new_icon(RandomBytes(20, 1000));
+      results.Time("update_app_icon", [&] { launcher.UpdateAppIcon(app_name, new_icon); });
+      break;
+    }
+    case 13: {
+      const bool new_auto_start_value(RandomUint32() % 2 == 0);
+      results.Time("update_app_auto_start",
+                   [&] { launcher.UpdateAppAutoStart(app_name, new_auto_start_value); });
+      break;
+    }
+    case 14:
+    case 15:
+      if (results.Time("remove_app_locally", [&] { launcher.RemoveAppLocally(app_name); }))
+        app_names.erase(app_names.begin() + index);
+      break;
+    default:
+      results.Time("save_session", [&] { launcher.SaveSession(); });
+      break;
+  }
+}
+
+// Launches 'dummy_app' 'launches' times, then waits for the launches to finish and records their
+// traces, both as a whole and per phase.
+void LaunchDummyApps(Launcher& launcher, const fs::path& dummy_app, int launches,
+                     Results& results) {
+  const AppName app_name("dummy_app");
+  if (launches == 0 || !results.Time("add_app", [&] {
+        launcher.AddApp(app_name, dummy_app, AppArgs(), SerialisedData(), false);
+      })) {
+    return;
+  }
+
+  std::uint64_t started(0);
+  for (int i(0); i < launches; ++i) {
+    if (results.Time("launch_app", [&] { launcher.LaunchApp(app_name); }))
+      ++started;
+  }
+
+  auto finished_count([&]() -> std::uint64_t {
+    const auto stats(launcher.GetLaunchStats());
+    const auto itr(stats.find(app_name));
+    return itr == stats.end()
+               ? 0
+               : itr->second.succeeded + itr->second.timed_out + itr->second.failed;
+  });
+  const auto deadline(Clock::now() + Launcher::connect_timeout_ +
+                      2 * Launcher::handshake_timeout_ + std::chrono::seconds(10));
+  while (finished_count() < started && Clock::now() < deadline)
+    Sleep(std::chrono::milliseconds(100));
+
+  for (const auto& trace : launcher.GetRecentLaunchTraces()) {
+    if (trace.GetAppName() != app_name)
+      continue;
+    const bool succeeded(trace.GetOutcome() == LaunchTrace::Outcome::kSucceeded);
+    results.Record("launch", succeeded, trace.Begin(), trace.Begin() + trace.Duration());
+    // Unless the launch succeeded, its last phase is the one in which it failed.
+    for (const auto& span : trace.Spans()) {
+      results.Record("launch_" + ToString(span.phase),
+                     succeeded || &span != &trace.Spans().back(), span.begin, span.end);
+    }
+  }
+}
+
+// Runs a single session for a new account.  Returns false if the session couldn't log in.
+bool RunSession(int operations, int launches, const fs::path& dummy_app, Results& results) {
+  const auto credentials(GetRandomUserCredentialsTuple());
+  std::unique_ptr<Launcher> launcher;
+  if (!results.Time("create_account", [&] {
+        launcher = Launcher::CreateAccount(std::get<0>(credentials), std::get<1>(credentials),
+                                           std::get<2>(credentials));
+      })) {
+    return false;
+  }
+  launcher->LogoutAndStop();
+  launcher.reset();
+  if (!results.Time("login", [&] {
+        launcher = Launcher::Login(std::get<0>(credentials), std::get<1>(credentials),
+                                   std::get<2>(credentials));
+      })) {
+    return false;
+  }
+
+  std::vector<AppName> app_names;
+  for (int i(0); i < operations; ++i)
+    ApplyRandomOperation(*launcher, app_names, results);
+  LaunchDummyApps(*launcher, dummy_app, launches, results);
+  results.Time("logout", [&] { launcher->LogoutAndStop(); });
+  return true;
+}
+
+void PrintResults(const std::map<std::string, OperationResults>& results) {
+  std::cout << std::left << std::setw(28) << "operation" << std::right << std::setw(8) << "count"
+            << std::setw(8) << "errors" << std::setw(10) << "ops/s" << std::setw(12) << "p50 (us)"
+            << std::setw(12) << "p95 (us)" << std::setw(12) << "p99 (us)" << std::setw(12)
+            << "max (us)" << '\n';
+  for (const auto& result : results) {
+    const LatencyHistogram& latencies(result.second.latencies);
+    std::cout << std::left << std::setw(28) << result.first << std::right << std::setw(8)
+              << latencies.Count() << std::setw(8) << result.second.errors << std::setw(10)
+              << std::fixed << std::setprecision(1) << result.second.Throughput() << std::setw(12)
+              << latencies.Percentile(50).count() << std::setw(12)
+              << latencies.Percentile(95).count() << std::setw(12)
+              << latencies.Percentile(99).count() << std::setw(12) << latencies.Max().count()
+              << '\n';
+  }
+}
+
+void WriteResults(const fs::path& path, int sessions, int operations, int launches,
+                  int failed_sessions, const std::map<std::string, OperationResults>& results) {
+  std::ostringstream output;
+  output << "{\n  \"sessions\": " << sessions << ", \"operations\": " << operations
+         << ", \"launches\": " << launches << ", \"failed_sessions\": " << failed_sessions
+         << ",\n  \"results\": {";
+  for (auto itr(results.begin()); itr != results.end(); ++itr) {
+    const LatencyHistogram& latencies(itr->second.latencies);
+    output << (itr == results.begin() ? "\n" : ",\n") << "    " << JsonString(itr->first)
+           << ": {\"count\": " << latencies.Count() << ", \"errors\": " << itr->second.errors
+           << ", \"ops_per_second\": " << itr->second.Throughput()
+           << ", \"p50_us\": " << latencies.Percentile(50).count()
+           << ", \"p95_us\": " << latencies.Percentile(95).count()
+           << ", \"p99_us\": " << latencies.Percentile(99).count()
+           << ", \"max_us\": " << latencies.Max().count() << "}";
+  }
+  output << "}\n}\n";
+  if (!WriteFile(path, output.str())) {
+    LOG(kError) << "Failed to write results to " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+}
+
+int Run(const Options& options, const fs::path& self) {
+  const int sessions(GetCount(options, "sessions", 4));
+  const int operations(GetCount(options, "operations", 100));
+  const int launches(GetCount(options, "launches", 10));
+  // Each session reads its launch traces from 'GetRecentLaunchTraces', which only keeps so many.
+  if (sessions == 0 || static_cast<std::size_t>(launches) > LaunchStats::kMaxRecentTraces) {
+    LOG(kError) << "--sessions must be non-zero and --launches at most "
+                << LaunchStats::kMaxRecentTraces;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  fs::path dummy_app(GetPath(options, "dummy_app"));
+  if (dummy_app.empty())
+    dummy_app = self.parent_path() / ("dummy_app" + self.extension().string());
+  if (launches != 0 && !fs::exists(dummy_app)) {
+    LOG(kError) << dummy_app << " doesn't exist.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+
+  const maidsafe::test::TestPath test_root(
+      maidsafe::test::CreateTestPath("MaidSafe_TestLoadHarness"));
+  const fs::path store_path(*test_root / "store");
+  DiskUsage usage(std::uint64_t{1} << 30);
+  fs::create_directories(store_path);
+  Launcher::FakeStorePath(&store_path);
+  Launcher::FakeStoreDiskUsage(&usage);
+
+  Results results;
+  std::vector<std::future<bool>> session_results;
+  for (int i(0); i < sessions; ++i) {
+    session_results.push_back(std::async(std::launch::async, [&] {
+      try {
+        return RunSession(operations, launches, dummy_app, results);
+      } catch (const std::exception& e) {
+        LOG(kError) << "Session failed: " << boost::diagnostic_information(e);
+        return false;
+      }
+    }));
+  }
+  int failed_sessions(0);
+  for (auto& session_result : session_results) {
+    if (!session_result.get())
+      ++failed_sessions;
+  }
+
+  std::cout << sessions << " sessions, " << operations << " operations and " << launches
+            << " launches each, " << failed_sessions << " failed\n\n";
+  const std::map<std::string, OperationResults> merged_results(results.Get());
+  PrintResults(merged_results);
+  const fs::path output_path(GetPath(options, "output"));
+  if (!output_path.empty())
+    WriteResults(output_path, sessions, operations, launches, failed_sessions, merged_results);
+  return failed_sessions == 0 ? 0 : ErrorToInt(MakeError(CommonErrors::unable_to_handle_request));
+}
+
+}  // unnamed namespace
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  namespace test = maidsafe::launcher::test;
+  maidsafe::log::Logging::Instance().Initialise(argc, argv);
+  try {
+    const test::Options options(test::ParseOptions(argc, argv));
+    if (options.count("help") != 0) {
+      std::cout << test::kUsage;
+      return 0;
+    }
+    return test::Run(options, fs::system_complete(argv[0]));
+  } catch (const maidsafe::maidsafe_error& error) {
+    LOG(kError) << "Error: " << boost::diagnostic_information(error);
+    return maidsafe::ErrorToInt(error);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error: " << e.what();
+    return maidsafe::ErrorToInt(MakeError(maidsafe::CommonErrors::unknown));
+  }
+}
@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/process_supervisor.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(ProcessSupervisorTest, BEH_SplitArgs) {
+  EXPECT_TRUE(SplitArgs("").empty());
+  EXPECT_TRUE(SplitArgs(" \t ").empty());
+  EXPECT_EQ((std::vector<std::string>{"--a", "b"}), SplitArgs("  --a\tb "));
+  EXPECT_EQ((std::vector<std::string>{"--path=/x y/z", "", "c"}),
+            SplitArgs("--path=\"/x y/z\" \"\" c"));
+}
+
+#ifndef MAIDSAFE_WIN32
+TEST(ProcessSupervisorTest, BEH_SpawnAndReap) {
+  AsioService asio_service(1);
+  ProcessSupervisor supervisor{asio_service.service()};
+  const AppName app_name{"App"};
+  EXPECT_FALSE(supervisor.IsRunning(app_name));
+
+  std::promise<int> exit_code;
+  const ProcessSupervisor::ProcessId process_id{supervisor.Spawn(
+      app_name, "/bin/sh", "-c \"sleep 1; exit 3\"",
+      [&](ProcessSupervisor::ProcessId, int code) { exit_code.set_value(code); })};
+  EXPECT_TRUE(supervisor.IsRunning(app_name));
+  EXPECT_EQ(std::vector<ProcessSupervisor::ProcessId>{process_id},
+            supervisor.RunningProcesses(app_name));
+
+  auto exit_future(exit_code.get_future());
+  ASSERT_EQ(std::future_status::ready, exit_future.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(3, exit_future.get());
+  EXPECT_FALSE(supervisor.IsRunning(app_name));
+
+  // Several children exiting together should all be reaped.
+  std::atomic<int> exited_count(0);
+  for (int i(0); i < 5; ++i)
+    supervisor.Spawn(app_name, "/bin/sh", "-c true", [&](ProcessSupervisor::ProcessId, int code) {
+      EXPECT_EQ(0, code);
+      ++exited_count;
+    });
+  const auto deadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+  while (exited_count < 5 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(5, exited_count);
+  EXPECT_FALSE(supervisor.IsRunning(app_name));
+
+  EXPECT_TRUE(ThrowsAs([&] { supervisor.Spawn(app_name, "/no/such/app", ""); },
+                       CommonErrors::invalid_argument));
+  asio_service.Stop();
+}
+#endif
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,110 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/profiler.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+TEST(ProfilerTest, BEH_Scopes) {
+  Profiler::Clear();
+  EXPECT_FALSE(Profiler::IsEnabled());
+  { Profiler::Scope scope{"test", "Disabled"}; }
+  EXPECT_TRUE(Profiler::GetEvents().empty());
+
+  Profiler::Enable(true);
+  {
+    Profiler::Scope outer_scope{"test", "Outer"};
+    {
+      Profiler::Scope inner_scope{"test", "Inner"};
+      inner_scope.AddBytes(10);
+      inner_scope.AddBytes(5);
+      // Busy-wait so that some CPU time is used.
+      const auto end(std::chrono::steady_clock::now() + std::chrono::milliseconds(20));
+      while (std::chrono::steady_clock::now() < end) {
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  // A scope constructed while enabled should still be recorded if profiling is disabled meanwhile.
+  {
+    Profiler::Scope scope{"test", "Disabling"};
+    Profiler::Enable(false);
+  }
+  { Profiler::Scope scope{"test", "Disabled"}; }
+
+  const std::vector<Profiler::Event> events(Profiler::GetEvents());
+  ASSERT_EQ(3U, events.size());
+  const Profiler::Event& inner(events[0]);
+  const Profiler::Event& outer(events[1]);
+  EXPECT_EQ("Inner", inner.name);
+  EXPECT_EQ("test", inner.category);
+  EXPECT_EQ(15U, inner.bytes);
+  EXPECT_GE(inner.wall_time, std::chrono::milliseconds(20));
+  EXPECT_GT(inner.cpu_time, std::chrono::nanoseconds(0));
+  EXPECT_EQ("Outer", outer.name);
+  EXPECT_EQ(0U, outer.bytes);
+  EXPECT_LE(outer.begin, inner.begin);
+  EXPECT_GE(outer.begin + outer.wall_time, inner.begin + inner.wall_time);
+  EXPECT_GE(outer.wall_time, std::chrono::milliseconds(40));
+  // The sleep shouldn't count as CPU time.
+  EXPECT_LT(outer.cpu_time, outer.wall_time);
+  EXPECT_EQ("Disabling", events[2].name);
+
+  Profiler::Clear();
+  EXPECT_TRUE(Profiler::GetEvents().empty());
+}
+
+TEST(ProfilerTest, BEH_WriteChromeTrace) {
+  const maidsafe::test::TestPath test_root(maidsafe::test::CreateTestPath("MaidSafe_TestProfile"));
+  Profiler::Clear();
+  Profiler::Enable(true);
+  { Profiler::Scope scope{"test", "Main \"thread\""}; }
+  std::thread([] { Profiler::Scope scope{"test", "Other thread"}; }).join();
+  Profiler::Enable(false);
+
+  const boost::filesystem::path file_path(*test_root / "profile.json");
+  Profiler::WriteChromeTrace(file_path);
+  const std::string contents(ReadFile(file_path).value());
+  EXPECT_EQ(0U, contents.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": ["));
+  EXPECT_NE(std::string::npos, contents.find("\"name\": \"Main \\\"thread\\\"\""));
+  EXPECT_NE(std::string::npos, contents.find("\"ph\": \"X\""));
+  EXPECT_NE(std::string::npos, contents.find("\"tid\": 1,"));
+  EXPECT_NE(std::string::npos, contents.find("\"tid\": 2,"));
+  EXPECT_NE(std::string::npos, contents.find("\"bytes\": 0"));
+  Profiler::Clear();
+  EXPECT_TRUE(ThrowsAs([&] { Profiler::WriteChromeTrace(*test_root / "no_such_dir" / "file"); },
+                       CommonErrors::filesystem_io_error));
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -0,0 +1,120 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/launcher/save_scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace launcher {
+
+namespace test {
+
+namespace {
+
+// Polls 'condition' until it's true or 'timeout' has passed.
+bool WaitFor(const std::function<bool()>& condition,
+             std::chrono::steady_clock::duration timeout = std::chrono::seconds(5)) {
+  const auto deadline(std::chrono::steady_clock::now() + timeout);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+}  // unnamed namespace
+
+TEST(SaveSchedulerTest, BEH_CoalesceChanges) {
+  AsioService asio_service(1);
+  std::atomic<int> save_count(0);
+  SaveScheduler save_scheduler{asio_service.service(), [&] { ++save_count; }};
+  EXPECT_EQ(SaveScheduler::State::kSaved, save_scheduler.GetState());
+
+  // While disabled, changes should be tracked but not saved.
+  save_scheduler.MarkDirty();
+  EXPECT_EQ(SaveScheduler::State::kDirty, save_scheduler.GetState());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(0, save_count);
+  save_scheduler.MarkSaved();
+  EXPECT_EQ(SaveScheduler::State::kSaved, save_scheduler.GetState());
+
+  // A burst of changes within the delay should be saved together.
+  save_scheduler.SetDelay(std::chrono::milliseconds(200), std::chrono::seconds(10));
+  for (int i(0); i < 5; ++i) {
+    save_scheduler.MarkDirty();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(SaveScheduler::State::kDirty, save_scheduler.GetState());
+  EXPECT_TRUE(WaitFor([&] { return save_scheduler.GetState() == SaveScheduler::State::kSaved; }));
+  EXPECT_EQ(1, save_count);
+
+  // Continual changes shouldn't defer saving beyond the maximum delay.
+  save_scheduler.SetDelay(std::chrono::milliseconds(200), std::chrono::milliseconds(300));
+  const auto end(std::chrono::steady_clock::now() + std::chrono::seconds(1));
+  while (std::chrono::steady_clock::now() < end) {
+    save_scheduler.MarkDirty();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_GE(save_count, 2);
+  asio_service.Stop();
+}
+
+TEST(SaveSchedulerTest, BEH_RetryWithBackoff) {
+  AsioService asio_service(1);
+  std::atomic<int> attempt_count(0);
+  SaveScheduler save_scheduler{asio_service.service(),
+                               [&] {
+                                 if (++attempt_count < 3)
+                                   BOOST_THROW_EXCEPTION(
+                                       MakeError(CommonErrors::unable_to_handle_request));
+                               },
+                               std::chrono::milliseconds(100), std::chrono::milliseconds(200)};
+  save_scheduler.SetDelay(std::chrono::milliseconds(10), std::chrono::milliseconds(10));
+  save_scheduler.MarkDirty();
+  EXPECT_TRUE(
+      WaitFor([&] { return save_scheduler.GetState() == SaveScheduler::State::kRetrying; }));
+  EXPECT_TRUE(WaitFor([&] { return save_scheduler.GetState() == SaveScheduler::State::kSaved; }));
+  EXPECT_EQ(3, attempt_count);
+
+  // Explicitly marking as saved should cancel a scheduled retry.
+  attempt_count = 0;
+  save_scheduler.MarkDirty();
+  EXPECT_TRUE(
+      WaitFor([&] { return save_scheduler.GetState() == SaveScheduler::State::kRetrying; }));
+  save_scheduler.MarkSaved();
+  EXPECT_EQ(SaveScheduler::State::kSaved, save_scheduler.GetState());
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(1, attempt_count);
+  asio_service.Stop();
+}
+
+}  // namespace test
+
+}  // namespace launcher
+
+}  // namespace maidsafe
@@ -88,6 +88,11 @@ DirectoryInfo CreateRandomDirectoryInfo() {
 }
 
 AppDetails CreateRandomAppDetails() {
+  return CreateRandomAppDetails(
+      crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)});
+}
+
+AppDetails CreateRandomAppDetails(const crypto::AES256KeyAndIV& account_key_and_iv) {
   AppDetails app;
   app.name = RandomAlphaNumericString(27, 40);
   app.path = RandomAlphaNumericString(27, 255);
@@ -96,6 +101,7 @@ AppDetails CreateRandomAppDetails() {
   for (int i = 0; i < count; ++i)
     app.permitted_dirs.insert(CreateRandomDirectoryInfo());
   app.icon = RandomBytes(20, 1000);
+  app.icon_id = MakeIconChunk(app.icon, account_key_and_iv).Name();
   app.auto_start = (count % 2 == 1);
   return app;
 }
@@ -170,6 +176,11 @@ testing::AssertionResult Equals(const AppDetails& expected, const AppDetails& ac
            << ") does not match actual icon ("
            << hex::Encode(std::string(actual.icon.begin(), actual.icon.end())) << ")\n";
   }
+  if (!(ignore_field & kIgnoreIcon) && expected.icon_id != actual.icon_id) {
+    return testing::AssertionFailure()
+           << "\n    Expected icon ID (" << hex::Substr(expected.icon_id)
+           << ") does not match actual icon ID (" << hex::Substr(actual.icon_id) << ")\n";
+  }
   if (!(ignore_field & kIgnoreAutoStart) && expected.auto_start != actual.auto_start) {
     return testing::AssertionFailure() << "\n    Expected auto start value (" << expected.auto_start
                                        << ") does not match actual auto start value ("
@@ -178,27 +189,6 @@ testing::AssertionResult Equals(const AppDetails& expected, const AppDetails& ac
   return testing::AssertionSuccess();
 }
 
-testing::AssertionResult Equals(const std::set<AppDetails>& expected,
-                                const std::set<AppDetails>& actual, int ignore_field) {
-  if (expected.size() != actual.size()) {
-    return testing::AssertionFailure() << "\n  Expected size (" << expected.size()
-                                       << ") does not match actual size (" << actual.size() << ")";
-  }
-  auto expected_itr(expected.begin());
-  auto actual_itr(actual.begin());
-  int count{0};
-  while (expected_itr != expected.end()) {
-    if (!Equals(*expected_itr, *actual_itr, ignore_field)) {
-      EXPECT_TRUE(Equals(*expected_itr, *actual_itr, ignore_field));  // to get console output.
-      return testing::AssertionFailure() << "Failed to match apps at index " << count;
-    }
-    ++expected_itr;
-    ++actual_itr;
-    ++count;
-  }
-  return testing::AssertionSuccess();
-}
-
 }  // namespace test
 
 }  // namespace launcher
@@ -23,6 +23,7 @@
 #include <string>
 #include <tuple>
 
+#include "maidsafe/common/crypto.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/authentication/user_credentials.h"
@@ -81,7 +82,9 @@ testing::AssertionResult ThrowsAs(std::function<void()> statement,
 
 DirectoryInfo CreateRandomDirectoryInfo();
 
+// The app's icon ID is derived from a random account key unless 'account_key_and_iv' is given.
 AppDetails CreateRandomAppDetails();
+AppDetails CreateRandomAppDetails(const crypto::AES256KeyAndIV& account_key_and_iv);
 
 enum IgnoreField {
   kIgnorePath = 1,
@@ -94,8 +97,28 @@ enum IgnoreField {
 testing::AssertionResult Equals(const AppDetails& expected, const AppDetails& actual,
                                 int ignore_field = 0);
 
-testing::AssertionResult Equals(const std::set<AppDetails>& expected,
-                                const std::set<AppDetails>& actual, int ignore_field = 0);
+// Compares two ordered collections of apps, e.g. 'std::set<AppDetails>' or 'AppRegistry'.
+template <typename ExpectedApps, typename ActualApps>
+testing::AssertionResult Equals(const ExpectedApps& expected, const ActualApps& actual,
+                                int ignore_field = 0) {
+  if (expected.size() != actual.size()) {
+    return testing::AssertionFailure() << "\n  Expected size (" << expected.size()
+                                       << ") does not match actual size (" << actual.size() << ")";
+  }
+  auto expected_itr(expected.begin());
+  auto actual_itr(actual.begin());
+  int count{0};
+  while (expected_itr != expected.end()) {
+    if (!Equals(*expected_itr, *actual_itr, ignore_field)) {
+      EXPECT_TRUE(Equals(*expected_itr, *actual_itr, ignore_field));  // to get console output.
+      return testing::AssertionFailure() << "Failed to match apps at index " << count;
+    }
+    ++expected_itr;
+    ++actual_itr;
+    ++count;
+  }
+  return testing::AssertionSuccess();
+}
 
 }  // namespace test
 
@@ -44,6 +44,8 @@ AccountHandlerController::AccountHandlerController(MainWindow& main_window,
 }
 
 AccountHandlerController::~AccountHandlerController() {
+  // Abort any in-flight login so that this doesn't block until it completes.
+  account_handler_model_->CancelPending();
   if (future_.valid()) {
     future_.wait();
   }
@@ -62,10 +64,8 @@ void AccountHandlerController::SetCurrentView(const AccountHandlingViews new_cur
 
 void AccountHandlerController::login(const QString& pin, const QString& keyword,
                                      const QString& password) {
-  if (!future_.valid()) {
-    future_ = std::async(std::launch::async,
-                         [=] { return account_handler_model_->Login(pin, keyword, password); });
-  }
+  if (!future_.valid())
+    future_ = account_handler_model_->Login(pin, keyword, password);
 }
 
 void AccountHandlerController::showLoginView() {
@@ -74,11 +74,8 @@ void AccountHandlerController::showLoginView() {
 
 void AccountHandlerController::createAccount(const QString& pin, const QString& keyword,
                                              const QString& password) {
-  if (!future_.valid()) {
-    future_ =
-        std::async(std::launch::async,
-                   [=] { return account_handler_model_->CreateAccount(pin, keyword, password); });
-  }
+  if (!future_.valid())
+    future_ = account_handler_model_->CreateAccount(pin, keyword, password);
 }
 
 void AccountHandlerController::showCreateAccountView() {
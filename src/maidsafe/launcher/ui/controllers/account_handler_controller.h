@@ -31,7 +31,7 @@ namespace maidsafe {
 
 namespace launcher {
 
-struct Launcher;
+class Launcher;
 
 namespace ui {
 
@@ -18,13 +18,11 @@
 
 #include "maidsafe/launcher/ui/controllers/main_controller.h"
 
+#include "maidsafe/launcher/launcher.h"
 #include "maidsafe/launcher/ui/controllers/account_handler_controller.h"
 #include "maidsafe/launcher/ui/helpers/main_window.h"
 #include "maidsafe/launcher/ui/models/api_model.h"
 
-// TODO(Spandan) remove when fake Launcher is removed
-#include "maidsafe/launcher/ui/models/account_handler_model.h"
-
 namespace maidsafe {
 
 namespace launcher {
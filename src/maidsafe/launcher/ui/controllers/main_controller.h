@@ -30,7 +30,7 @@ namespace maidsafe {
 
 namespace launcher {
 
-struct Launcher;
+class Launcher;
 
 namespace ui {
 
@@ -17,8 +17,9 @@
     use of the MaidSafe Software.                                                                 */
 
 #include "maidsafe/launcher/ui/models/account_handler_model.h"
-#include "maidsafe/common/on_scope_exit.h"
-#include "maidsafe/common/utils.h"
+
+#include <string>
+#include <vector>
 
 namespace maidsafe {
 
@@ -26,29 +27,38 @@ namespace launcher {
 
 namespace ui {
 
+namespace {
+
+std::vector<unsigned char> ToBytes(const QString& text) {
+  const std::string utf8{text.toStdString()};
+  return std::vector<unsigned char>(utf8.begin(), utf8.end());
+}
+
+}  // unnamed namespace
+
 AccountHandlerModel::AccountHandlerModel(QObject* parent) : QObject{parent} {}
 
 AccountHandlerModel::~AccountHandlerModel() = default;
 
-std::unique_ptr<Launcher> AccountHandlerModel::Login(const QString& /*pin*/,
-                                                     const QString& /*keyword*/,
-                                                     const QString& /*password*/) {
-  Sleep(std::chrono::seconds(3));
-  on_scope_exit sig{[this] { emit LoginResultAvailable(); }};
-  //  return Launcher::Login(pin.toStdString(), keyword.toStdString(), password.toStdString());
-  std::unique_ptr<Launcher> launcher{new Launcher};
-  return std::move(launcher);
+std::future<std::unique_ptr<Launcher>> AccountHandlerModel::Login(const QString& pin,
+                                                                  const QString& keyword,
+                                                                  const QString& password) {
+  cancellation_token_ = CancellationToken();
+  return Launcher::LoginAsync(ToBytes(keyword), pin.toUInt(), ToBytes(password),
+                              [this] { emit LoginResultAvailable(); }, cancellation_token_);
+}
+
+std::future<std::unique_ptr<Launcher>> AccountHandlerModel::CreateAccount(
+    const QString& pin, const QString& keyword, const QString& password) {
+  cancellation_token_ = CancellationToken();
+  return Launcher::CreateAccountAsync(ToBytes(keyword), pin.toUInt(), ToBytes(password),
+                                      [this] { emit CreateAccountResultAvailable(); },
+                                      cancellation_token_);
 }
 
-std::unique_ptr<Launcher> AccountHandlerModel::CreateAccount(const QString& /*pin*/,
-                                                             const QString& /*keyword*/,
-                                                             const QString& /*password*/) {
-  Sleep(std::chrono::seconds(3));
-  on_scope_exit sig{[this] { emit CreateAccountResultAvailable(); }};
-  //  return Launcher::CreateAccount(pin.toStdString(), keyword.toStdString(),
-  // password.toStdString());
-  std::unique_ptr<Launcher> launcher{new Launcher};
-  return std::move(launcher);
+void AccountHandlerModel::CancelPending() {
+  cancellation_token_.Cancel();
+  Launcher::CancelPrepareForLogin();
 }
 
 }  // namespace ui
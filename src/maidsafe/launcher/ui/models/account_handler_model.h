@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_LAUNCHER_UI_MODELS_ACCOUNT_HANDLER_MODEL_H_
 #define MAIDSAFE_LAUNCHER_UI_MODELS_ACCOUNT_HANDLER_MODEL_H_
 
+#include <future>
 #include <memory>
 
 #include "maidsafe/launcher/ui/helpers/qt_push_headers.h"
@@ -26,15 +27,13 @@
 
 #include "maidsafe/common/config.h"
 
+#include "maidsafe/launcher/cancellation_token.h"
+#include "maidsafe/launcher/launcher.h"
+
 namespace maidsafe {
 
 namespace launcher {
 
-// TODO(Spandan) Remove this once backend is in place
-struct Launcher {
-  int a_{999};
-};
-
 namespace ui {
 
 class AccountHandlerModel : public QObject {
@@ -44,14 +43,25 @@ class AccountHandlerModel : public QObject {
   explicit AccountHandlerModel(QObject* parent = nullptr);
   ~AccountHandlerModel() override;
 
-  std::unique_ptr<Launcher> Login(const QString& pin, const QString& keyword,
-                                  const QString& password);
-  std::unique_ptr<Launcher> CreateAccount(const QString& pin, const QString& keyword,
-                                          const QString& password);
+  // These return immediately, running on the Launcher's async pool rather than a thread of their
+  // own.  'LoginResultAvailable' or 'CreateAccountResultAvailable' respectively is emitted from
+  // that pool once the returned future is ready.
+  std::future<std::unique_ptr<Launcher>> Login(const QString& pin, const QString& keyword,
+                                               const QString& password);
+  std::future<std::unique_ptr<Launcher>> CreateAccount(const QString& pin, const QString& keyword,
+                                                       const QString& password);
+
+  // Aborts any pending 'Login' or 'CreateAccount' so that its future becomes ready promptly, e.g.
+  // on shutdown.
+  void CancelPending();
 
  signals: // NOLINT - Spandan
   void LoginResultAvailable();
   void CreateAccountResultAvailable();
+
+ private:
+  // Replaced for each request, so that cancelling one doesn't affect the next.
+  CancellationToken cancellation_token_;
 };
 
 }  // namespace ui